@@ -0,0 +1,31 @@
+#include "../units/systems/angles.hpp"
+#include "../units/systems/si.hpp"
+#include "../units/quantity.hpp"
+#include "../units/trigonometry.hpp"
+
+namespace tests
+{
+	using units::angles;
+	using units::si;
+	using units::quantity;
+	using units::delta;
+
+	template<class T>
+	constexpr T close(T a, T b, T tolerance)
+	{
+		return (a < b ? b - a : a - b) <= tolerance;
+	}
+
+	using bam16 = angles::binary_angle<std::uint16_t>;
+
+	static_assert(units::AngleUnit<angles::degree> && units::AngleUnit<bam16> && !units::AngleUnit<si::meter>, "Incorrect AngleUnit");
+	static_assert(quantity<angles::degree>{ quantity<angles::turn>{ 0.25 } }.value() == 90.0, "Incorrect degree value");
+	static_assert(quantity<angles::arcsecond>{ quantity<angles::degree>{ 1.0 } }.value() == 3600.0, "Incorrect arcsecond value");
+	static_assert(units::unit_conversion<angles::gradian, angles::degree>::factor.exact, "Fractions of a turn should convert exactly");
+	static_assert(close(quantity<angles::radian>{ quantity<angles::degree>{ 180.0 } }.value(), 3.141592653589793, 1e-15), "Incorrect radian value");
+
+	// Binary angles wrap at a full turn.
+	static_assert(quantity<angles::degree>{ quantity<bam16>{ 16384 } }.value() == 90.0, "Incorrect binary angle value");
+	static_assert((quantity<bam16>{ 49152 } + delta<bam16>{ 32768 }).value() == 16384, "Binary angles must wrap at a full turn");
+	static_assert(units::quantize<bam16, units::overflow_policy::wrap>(quantity<angles::degree>{ -90.0 }).value() == 49152, "Negative angles must wrap into a binary angle");
+}
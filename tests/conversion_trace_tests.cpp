@@ -0,0 +1,55 @@
+#define CPP_UNITS_TRACE_CONVERSIONS
+#include <string>
+#include <vector>
+#include "../units/units.hpp"
+#include "../units/fundamental_unit.hpp"
+#include "../units/linear_unit.hpp"
+#include "../units/quantity.hpp"
+#include "../units/conversion_trace.hpp"
+#include "runtime_tests.hpp"
+
+namespace tests
+{
+	// The units are local to this file: with tracing on, unit_conversion<From, To>::convert has a
+	// different definition, so it must not be instantiated for units used by the other test files.
+	namespace
+	{
+		struct trace_meter : units::fundamental_unit<trace_meter, double> {};
+		using trace_millimeter = units::scaled_unit<trace_meter, units::ratio<1000>>;
+		using trace_kilometer = units::scaled_unit<trace_meter, units::ratio<1, 1000>>;
+	}
+
+	void conversion_trace_tests()
+	{
+		using units::quantity;
+		units::reset_conversion_counts();
+		check(units::conversion_counts().empty(), "Conversion counts must start empty");
+
+		quantity<trace_millimeter> stored{ 1500.0 };
+		for (int i = 0; i < 3; ++i)
+		{
+			const quantity<trace_meter> meters = stored;
+			stored = meters;
+		}
+		const quantity<trace_kilometer> kilometers = stored;
+		check(kilometers.value() == 0.0015, "Incorrect traced conversion");
+
+		const std::vector<units::conversion_count> counts = units::conversion_counts();
+		check(counts.size() == 3, "Each converted pair must be counted once");
+		check(counts.size() == 3 && counts[0].count == 3 && counts[1].count == 3 && counts[2].count == 1, "Counts must be ordered most frequent first");
+
+		const std::string report = units::conversion_report();
+		std::size_t round_trips = 0;
+		for (std::size_t position = report.find("(round trip)"); position != std::string::npos; position = report.find("(round trip)", position + 1))
+			++round_trips;
+		check(round_trips == 2, "Both directions of mm -> m -> mm must be marked as round trips");
+		check(report.find("units::") == std::string::npos, "Unit names in the report must not repeat the namespace");
+
+		units::reset_conversion_counts();
+		check(units::conversion_counts().empty(), "reset_conversion_counts must clear the counts");
+
+		constexpr quantity<trace_meter> folded = quantity<trace_kilometer>{ 2.0 };
+		static_assert(folded.value() == 2000.0, "Incorrect constant conversion");
+		check(units::conversion_counts().empty(), "Constant-evaluated conversions must not be counted");
+	}
+}
@@ -0,0 +1,48 @@
+#include "../units/systems/data.hpp"
+#include "../units/quantity.hpp"
+#include "../units/checked_value.hpp"
+
+namespace tests
+{
+	using units::data;
+	using units::quantity;
+	using units::delta;
+
+	using gibibyte_rate = units::make_compound_t<units::gibi<data::byte>, data::frequency>;
+	using megabit_rate = units::make_compound_t<units::mega<data::bit>, data::frequency>;
+
+	constexpr quantity<data::bit> bits = quantity<data::byte>{ 3 };
+	static_assert(bits.value() == 24, "Incorrect bit value");
+
+	constexpr quantity<data::byte> bytes = quantity<units::kibi<data::byte>>{ 3 };
+	static_assert(bytes.value() == 3072, "Incorrect byte value");
+
+	constexpr quantity<units::mebi<data::byte>> mebibytes = quantity<units::kibi<units::kibi<data::byte>>>{ 7 };
+	static_assert(mebibytes.value() == 7, "Incorrect chained prefix value");
+
+	constexpr quantity<units::gibi<data::byte>> gibibytes = quantity<data::byte>{ (std::uint64_t{ 5 } << 30) + 7 };
+	static_assert(gibibytes.value() == 5, "Incorrect gibibyte value");
+
+	constexpr quantity<gibibyte_rate> rate = quantity<data::byte_rate>{ std::uint64_t{ 12 } << 30 };
+	static_assert(rate.value() == 12, "Incorrect rate value");
+	static_assert(std::is_same_v<decltype(rate.value()), std::uint64_t>, "Incorrect rate value_type");
+
+	constexpr quantity<megabit_rate> mbps = quantity<units::kilo<data::byte>>{ 1000 } / quantity<data::second>{ 4 };
+	static_assert(mbps.value() == 2, "Incorrect decimal rate value");
+
+	constexpr delta<data::byte> transferred = quantity<data::byte>{ 4096 } - quantity<units::kibi<data::byte>>{ 1 };
+	static_assert(transferred.value() == 3072, "Incorrect delta value");
+
+	static_assert(units::unit_scale_v<units::gibi<data::byte>>.num == (std::intmax_t{ 8 } << 30), "Incorrect gibibyte scale");
+	static_assert(units::unit_conversion<data::byte_rate, gibibyte_rate>::factor.den == (std::intmax_t{ 1 } << 30), "Incorrect folded rate factor");
+
+	using saturating = units::data_system_t<units::checked<std::uint64_t, units::overflow_policy::saturate>>;
+	using wrapping = units::data_system_t<units::checked<std::int32_t, units::overflow_policy::wrap>>;
+
+	constexpr quantity<saturating::bit> saturated_bits = quantity<saturating::byte>{ std::uint64_t{ 1 } << 62 };
+	static_assert(saturated_bits.value() == std::numeric_limits<std::uint64_t>::max(), "Incorrect saturated conversion");
+	static_assert((quantity<saturating::byte>{ 3 } - delta<saturating::byte>{ 5 }).value() == 0, "Incorrect saturated subtraction");
+	static_assert(quantity<saturating::bit>{ quantity<units::kibi<saturating::byte>>{ 2 } }.value() == 16384, "Incorrect checked conversion");
+
+	static_assert((quantity<wrapping::bit>{ std::numeric_limits<std::int32_t>::max() } + delta<wrapping::bit>{ 1 }).value() == std::numeric_limits<std::int32_t>::min(), "Incorrect wrapped addition");
+}
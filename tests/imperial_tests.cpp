@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <type_traits>
+#include "../units/systems/imperial.hpp"
+#include "../units/systems/si.hpp"
+#include "../units/quantity.hpp"
+
+namespace tests
+{
+	using units::imperial;
+	using units::si;
+	using units::quantity;
+	using units::delta;
+
+	template<class T>
+	constexpr T close(T a, T b, T tolerance)
+	{
+		return (a < b ? b - a : a - b) <= tolerance;
+	}
+
+	static_assert(quantity<si::meter>{ quantity<imperial::foot>{ 1.0 } }.value() == 0.3048, "Incorrect foot value");
+	static_assert(quantity<imperial::inch>{ quantity<imperial::yard>{ 1.0 } }.value() == 36.0, "Incorrect inch value");
+	static_assert(close(quantity<si::kilogram>{ quantity<imperial::pound>{ 1.0 } }.value(), 0.45359237, 1e-15), "Incorrect pound value");
+
+	// Derived units convert with one folded constant.
+	static_assert(units::unit_conversion<imperial::pound_force, si::force>::factor.exact, "pound-force to newton should be exact");
+	static_assert(close(quantity<si::force>{ quantity<imperial::pound_force>{ 1.0 } }.value(), 4.4482216152605, 1e-12), "Incorrect pound-force value");
+	static_assert(close(quantity<si::energy>{ quantity<imperial::foot_pound>{ 1.0 } }.value(), 1.3558179483314004, 1e-12), "Incorrect foot-pound value");
+	static_assert(close(quantity<units::make_compound_t<si::force, units::make_exponent_t<si::meter, -2>>>{ quantity<imperial::psi>{ 1.0 } }.value(), 6894.757293168361, 1e-9), "Incorrect psi value");
+	static_assert(close(quantity<si::velocity>{ quantity<imperial::miles_per_hour>{ 60.0 } }.value(), 26.8224, 1e-12), "Incorrect mph value");
+
+	constexpr auto newtons = units::system_cast<si>(quantity<imperial::force>{ 1.0 });
+	static_assert(units::similar_units_v<typename decltype(newtons)::unit_type, si::force>, "Incorrect system_cast unit");
+	static_assert(close(newtons.value(), 0.138254954376, 1e-12), "Incorrect poundal value");
+	static_assert(close(units::system_cast<imperial>(quantity<si::kilogram>{ 1.0 }).value(), 2.2046226218487757, 1e-12), "Incorrect system_cast value");
+
+	static_assert(close(quantity<si::celsius>{ quantity<imperial::fahrenheit>{ 212.0 } }.value(), 100.0, 1e-12), "Incorrect fahrenheit value");
+	static_assert(close(quantity<imperial::rankine>{ quantity<si::celsius>{ 0.0 } }.value(), 491.67, 1e-12), "Incorrect rankine value");
+	static_assert(close(quantity<si::kelvin>{ quantity<si::celsius>{ 26.85 } }.value(), 300.0, 1e-12), "Incorrect celsius value");
+	static_assert((delta<si::kelvin>{ delta<imperial::fahrenheit>{ 18.0 } }).value() == 10.0, "Incorrect fahrenheit delta");
+
+	// Between value types, widening is implicit and narrowing is explicit.
+	using si_float = units::si_system_t<float>;
+	static_assert(std::is_convertible_v<quantity<si_float::meter>, quantity<si::meter>>, "float to double should be implicit");
+	static_assert(!std::is_convertible_v<quantity<si::meter>, quantity<si_float::meter>>, "double to float should be explicit");
+	static_assert(units::system_cast<si_float>(quantity<units::milli<si::meter>>{ 1500.0 }).value() == 1.5f, "Incorrect narrowing system_cast");
+
+	// Migration from implicit narrowing: construct explicitly, or system_cast, before assigning.
+	using si_int = units::si_system_t<std::int64_t>;
+	static_assert(!std::is_convertible_v<quantity<si_int::meter>, quantity<si::meter>>, "int64 to double should be explicit");
+	static_assert(!std::is_assignable_v<quantity<si_float::meter>&, quantity<si::meter>>, "double to float should not assign implicitly");
+	static_assert(std::is_assignable_v<quantity<si::meter>&, quantity<si_float::meter>>, "float to double should assign implicitly");
+
+	constexpr quantity<si_float::meter> narrowed_assignment()
+	{
+		quantity<si_float::meter> value{};
+		value = quantity<si_float::meter>{ quantity<si::meter>{ 2.5 } };
+		return value;
+	}
+	static_assert(narrowed_assignment().value() == 2.5f, "Incorrect explicit narrowing");
+	static_assert(quantity<si::meter>{ quantity<si_int::meter>{ 3 } }.value() == 3.0, "Incorrect explicit int64 conversion");
+}
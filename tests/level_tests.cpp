@@ -0,0 +1,37 @@
+#include "../units/systems/levels.hpp"
+#include "../units/quantity.hpp"
+#include "../units/runtime_unit.hpp"
+
+namespace tests
+{
+	using units::levels;
+	using units::quantity;
+	using units::delta;
+
+	template<class T>
+	constexpr T level_abs(T value)
+	{
+		return value < 0 ? -value : value;
+	}
+
+	static_assert(units::similar_units_v<levels::dBm, levels::dBW>, "Levels of power must be similar");
+	static_assert(units::similar_units_v<levels::dBm, levels::watt>, "A level must be similar to its base unit");
+	static_assert(!units::similar_units_v<levels::dBm, levels::dBV>, "Levels of power and voltage must not be similar");
+	static_assert(std::is_same_v<units::difference_unit_t<levels::dBm>, units::difference_unit_t<levels::dBW>>, "Levels with the same scale share a difference unit");
+
+	constexpr quantity<levels::dBm> amplified = quantity<levels::dBm>{ 10 } + delta<levels::dBm>{ 3 };
+	static_assert(amplified.value() == 13, "Adding a gain must add levels");
+
+	template<class A, class B>
+	concept addable = requires(A a, B b) { a + b; };
+
+	static_assert(!addable<quantity<levels::dBm>, delta<levels::watt>>, "A power must not be added to a level as a gain");
+	static_assert(!addable<quantity<levels::watt>, delta<levels::dBm>>, "A gain must not be added to a power");
+	static_assert(addable<delta<levels::dBm>, delta<levels::dBW>>, "Gains of the same base unit must add");
+	static_assert(units::level_system::milli_reference<std::int32_t>::value == 0.001, "The milliwatt reference must not be truncated for integer levels");
+
+	static_assert(units::unit_fingerprint<levels::dBm>() != units::unit_fingerprint<levels::dBW>(), "Levels with different references must have different fingerprints");
+
+	constexpr delta<levels::neper> nepers = delta<levels::dBV>{ 20 };
+	static_assert(level_abs(nepers.value() - 2.302585092994046) < 1e-12, "Incorrect dB to neper gain");
+}
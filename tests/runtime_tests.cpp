@@ -0,0 +1,1140 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "../units/units.hpp"
+#include "../units/fundamental_unit.hpp"
+#include "../units/linear_unit.hpp"
+#include "../units/quantity.hpp"
+#include "../units/series_compression.hpp"
+#include "../units/pipeline.hpp"
+#include "../units/formula.hpp"
+#include "../units/logarithmic_unit.hpp"
+#include "../units/shared_ring.hpp"
+#include "../units/trigonometry.hpp"
+#include "../units/hdr_histogram.hpp"
+#include "../units/arrow.hpp"
+#include "../units/algorithm.hpp"
+#include "../units/parallel_transform.hpp"
+#include "../units/polynomial_unit.hpp"
+#include "../units/quantity_lut.hpp"
+#include "../units/calibration.hpp"
+#include "../units/checked_value.hpp"
+#include "../units/systems/data.hpp"
+#include "../units/atomic_quantity.hpp"
+#include "../units/systems/thermocouples.hpp"
+#include "../units/systems/si.hpp"
+#include "runtime_tests.hpp"
+
+namespace tests
+{
+	namespace
+	{
+		struct runtime_meter : units::fundamental_unit<runtime_meter, double> {};
+		struct runtime_tick : units::fundamental_unit<runtime_tick, std::int64_t> {};
+		struct runtime_second : units::fundamental_unit<runtime_second, double> {};
+		struct runtime_count : units::fundamental_unit<runtime_count, std::int8_t> {};
+		using runtime_millimeter = units::scaled_unit<runtime_meter, units::ratio<1000>>;
+
+		template<class Q>
+		bool same_bits(std::vector<Q> const& a, std::vector<Q> const& b)
+		{
+			if (a.size() != b.size())
+				return false;
+			using bits = std::conditional_t<sizeof(typename Q::value_type) == 8, std::uint64_t, std::uint32_t>;
+			for (std::size_t i = 0; i < a.size(); ++i)
+			{
+				if (std::bit_cast<bits>(a[i].value()) != std::bit_cast<bits>(b[i].value()))
+					return false;
+			}
+			return true;
+		}
+
+		template<class Q>
+		void check_series_round_trip(std::vector<Q> const& values, const char* message)
+		{
+			units::compressed_series<Q> series{ 64 };
+			for (Q const& value : values)
+				series.push_back(value);
+			check(same_bits(series.decode(), values), message);
+			series.flush();
+			check(same_bits(series.decode(), values), message);
+
+			std::vector<Q> indexed;
+			for (std::size_t i = 0; i < series.size(); ++i)
+				indexed.push_back(series[i]);
+			check(same_bits(indexed, values), message);
+			check(series[3].value() == values[3].value() && series[200].value() == values[200].value(), message);
+		}
+
+		void series_compression_tests()
+		{
+			using length = units::quantity<runtime_meter>;
+			std::vector<length> lengths;
+			for (int i = 0; i < 300; ++i)
+				lengths.push_back(length{ 20.0 + 0.25 * std::sin(i * 0.1) + (i % 7 == 0 ? 1e-300 : 0.0) });
+			lengths[10] = length{ -0.0 };
+			lengths[11] = length{ std::numeric_limits<double>::infinity() };
+			lengths[12] = length{ std::numeric_limits<double>::quiet_NaN() };
+			lengths[13] = length{ std::numeric_limits<double>::denorm_min() };
+			lengths[14] = length{ std::numeric_limits<double>::max() };
+			check_series_round_trip(lengths, "compressed doubles must decode bit-exactly");
+
+			using ticks = units::quantity<runtime_tick>;
+			std::vector<ticks> timestamps;
+			for (std::int64_t i = 0; i < 300; ++i)
+				timestamps.push_back(ticks{ 1700000000000 + i * 1000 + (i % 5) });
+			timestamps[20] = ticks{ std::numeric_limits<std::int64_t>::min() };
+			timestamps[21] = ticks{ std::numeric_limits<std::int64_t>::max() };
+			timestamps[22] = ticks{ 0 };
+			check_series_round_trip(timestamps, "compressed integers must decode exactly");
+		}
+
+		//! Evaluates text over the columns x (m), mm (mm) and t (s), with rows x = {1, 2}, mm = {1000, 500}, t = {4, 8}.
+		std::vector<double> evaluate_formula(std::string_view text, units::runtime_unit const& output)
+		{
+			units::formula_schema schema;
+			schema.add_column<runtime_meter>("x");
+			schema.add_column<runtime_millimeter>("mm");
+			schema.add_column<runtime_second>("t");
+			const std::vector<double> x{ 1, 2 }, mm{ 1000, 500 }, t{ 4, 8 };
+			const std::span<const double> columns[]{ x, mm, t };
+			std::vector<double> out(2);
+			units::formula::compile(text, schema, output).evaluate(columns, out);
+			return out;
+		}
+
+		//! Returns the offset of the formula_error thrown by compiling text, or -1 if there was none.
+		std::ptrdiff_t formula_error_position(std::string_view text, units::runtime_unit const& output)
+		{
+			try
+			{
+				evaluate_formula(text, output);
+			}
+			catch (units::formula_error const& error)
+			{
+				return static_cast<std::ptrdiff_t>(error.position());
+			}
+			return -1;
+		}
+
+		void formula_tests()
+		{
+			const units::runtime_unit meter = units::runtime_unit::of<runtime_meter>();
+			const units::runtime_unit none{};
+			const auto equals = [](std::vector<double> const& values, std::initializer_list<double> expected)
+			{
+				return std::equal(values.begin(), values.end(), expected.begin(), expected.end());
+			};
+
+			check(equals(evaluate_formula("x + mm", meter), { 2, 2.5 }), "Incorrect formula sum");
+			check(equals(evaluate_formula("d = x * x / t", units::runtime_unit::of<units::make_compound_t<runtime_meter, units::make_compound_t<runtime_meter, units::inverse_unit<runtime_second>>>>()), { 0.25, 0.5 }), "Incorrect formula value");
+			check(formula_error_position("x + t", meter) == 2, "Adding a length to a time must be a dimension error");
+			check(formula_error_position("x * x", meter) == 2, "A result of the wrong dimension must be an error");
+
+			// Scales and literals fold into one instruction: load and rescale.
+			units::formula_schema schema;
+			schema.add_column<runtime_millimeter>("mm");
+			check(units::formula::compile("2 * 500 * mm / 1000", schema, meter).size() == 2, "Constant factors must fold");
+
+			// A factor of 0 must not be divided by.
+			check(equals(evaluate_formula("0*x + mm", meter), { 1, 0.5 }), "Incorrect sum with a zero factor");
+			check(equals(evaluate_formula("mm + 0*x", meter), { 1, 0.5 }), "Incorrect sum with a zero factor");
+			check(equals(evaluate_formula("0*x/mm + 1", none), { 1, 1 }), "Incorrect sum of a constant and a zero factor");
+			check(equals(evaluate_formula("0*x - 0*mm", meter), { 0, 0 }), "Incorrect difference of zero factors");
+
+			check(formula_error_position("1.2.3*x", meter) == 0, "A number with two points must be an error");
+			check(formula_error_position(".", meter) == 0, "A lone point must be a formula_error");
+			check(formula_error_position("x * 1e", meter) == 4, "A number without exponent digits must be an error");
+			check(formula_error_position("x ^ 99999999999", meter) == 4, "An exponent too large for an integer must be an error, not overflow");
+			check(formula_error_position("x/x + x^-65", meter) == 9, "An exponent above the limit must be an error");
+			check(formula_error_position("(x^8)^9", meter) == 5, "A dimension exponent above the limit must be an error at the '^'");
+			check(formula_error_position("(x^8)^8 / x^63", meter) == -1, "Exponents up to the limit must be accepted");
+		}
+
+		void level_tests()
+		{
+			const double nan = std::numeric_limits<double>::quiet_NaN();
+			check(std::isnan(units::detail::fast_exp(nan)), "fast_exp must propagate NaN");
+			check(units::detail::fast_exp(-1000.0) == units::detail::fast_exp(-708.0), "fast_exp must clamp large negative inputs");
+			check(std::isfinite(units::detail::fast_exp(1000.0)), "fast_exp must clamp large positive inputs");
+			for (const double x : { -700.0, -20.5, -1.0, 0.0, 1e-3, 2.0, 300.25, 709.0 })
+				check(std::abs(units::detail::fast_exp(x) / std::exp(x) - 1.0) < 1e-14, "fast_exp must be within 1e-14 of std::exp");
+		}
+
+		void shared_ring_tests()
+		{
+			using ring = units::shared_quantity_ring<runtime_meter>;
+			constexpr std::size_t capacity = 8;
+			alignas(units::detail::cache_line_size) std::byte memory[ring::required_bytes(capacity)];
+
+			ring producer = ring::create(memory, sizeof(memory), capacity);
+			const std::vector<units::quantity<runtime_meter>> values{ units::quantity<runtime_meter>{ 1.0 }, units::quantity<runtime_meter>{ 2.0 }, units::quantity<runtime_meter>{ 3.0 }, units::quantity<runtime_meter>{ 4.0 }, units::quantity<runtime_meter>{ 5.0 } };
+			check(producer.try_push(values), "Incorrect shared ring push");
+
+			{
+				ring consumer = ring::attach(memory, sizeof(memory));
+				const auto ready = consumer.peek();
+				check(ready.size() == 5 && ready[0].value() == 1.0 && ready[4].value() == 5.0, "Incorrect shared ring peek");
+				consumer.consume(ready.size());
+				check(consumer.empty() && consumer.peek().empty(), "A consumed shared ring must be empty");
+			}
+
+			// A consumer that attaches after values were consumed must start from the header's indices.
+			ring consumer = ring::attach(memory, sizeof(memory));
+			check(consumer.empty() && consumer.peek().empty(), "A re-attached consumer must not see consumed values");
+			check(producer.try_push(std::span{ values }.first(4)), "Incorrect shared ring push");
+			auto ready = consumer.peek();
+			check(ready.size() == 3 && ready[0].value() == 1.0, "A push that wraps must be read up to the end of the ring first");
+			consumer.consume(ready.size());
+			ready = consumer.peek();
+			check(ready.size() == 1 && ready[0].value() == 4.0, "Incorrect shared ring peek after wrapping");
+			consumer.consume(ready.size());
+			check(!producer.try_push(std::vector<units::quantity<runtime_meter>>(capacity + 1)), "A push larger than the ring must fail");
+
+			bool rejected = false;
+			try
+			{
+				units::shared_quantity_ring<runtime_tick>::attach(memory, sizeof(memory));
+			}
+			catch (std::invalid_argument const&)
+			{
+				rejected = true;
+			}
+			check(rejected, "Attaching with a different unit must fail");
+
+			// Several producer threads push numbered batches; the consumer must see each producer's values in order.
+			using shared_ring = units::shared_quantity_ring<runtime_meter, units::ring_producers::multiple>;
+			constexpr std::size_t shared_capacity = 64;
+			constexpr int producers = 4;
+			constexpr int batches = 2000;
+			constexpr int batch_size = 3;
+			alignas(units::detail::cache_line_size) static std::byte shared_memory[shared_ring::required_bytes(shared_capacity)];
+			shared_ring mpsc = shared_ring::create(shared_memory, sizeof(shared_memory), shared_capacity);
+			std::vector<std::thread> writers;
+			for (int p = 0; p < producers; ++p)
+				writers.emplace_back([p]
+				{
+					shared_ring writer = shared_ring::attach(shared_memory, sizeof(shared_memory));
+					for (int b = 0; b < batches; ++b)
+					{
+						std::array<units::quantity<runtime_meter>, batch_size> batch;
+						for (int i = 0; i < batch_size; ++i)
+							batch[i] = units::quantity<runtime_meter>{ p * 1e6 + b * batch_size + i };
+						while (!writer.try_push(batch))
+							std::this_thread::yield();
+					}
+				});
+			std::array<int, producers> next{};
+			bool ordered = true;
+			for (int received = 0; received < producers * batches * batch_size;)
+			{
+				const auto ready = mpsc.peek();
+				for (auto const& value : ready)
+				{
+					const int p = static_cast<int>(value.value() / 1e6);
+					ordered = ordered && p >= 0 && p < producers && value.value() - p * 1e6 == next[p];
+					if (p >= 0 && p < producers)
+						++next[p];
+				}
+				received += static_cast<int>(ready.size());
+				mpsc.consume(ready.size());
+				if (ready.empty())
+					std::this_thread::yield();
+			}
+			for (auto& writer : writers)
+				writer.join();
+			check(ordered, "Each producer's values must be read in the order pushed");
+			check(std::all_of(next.begin(), next.end(), [](int n) { return n == batches * batch_size; }) && mpsc.empty(), "Every pushed value must be read exactly once");
+
+#ifdef CPP_UNITS_HAS_POSIX_SHARED_MEMORY
+			// A ring in a named shared memory object, written through one mapping and read through another.
+			const std::string name = "/cpp_units_runtime_tests_" + std::to_string(::getpid());
+			{
+				units::shared_memory_region created = units::shared_memory_region::create(name, ring::required_bytes(capacity));
+				ring writer = ring::create(created.data(), created.size(), capacity);
+				check(writer.try_push(std::span{ values }.first(2)), "Incorrect push into shared memory");
+
+				units::shared_memory_region opened = units::shared_memory_region::open(name);
+				ring reader = ring::attach(opened.data(), opened.size());
+				const auto shared = reader.peek();
+				check(opened.size() >= ring::required_bytes(capacity) && shared.size() == 2 && shared[1].value() == 2.0, "A second mapping must see the pushed values");
+				reader.consume(shared.size());
+
+				rejected = false;
+				try
+				{
+					units::shared_memory_region::create(name, ring::required_bytes(capacity));
+				}
+				catch (std::system_error const&)
+				{
+					rejected = true;
+				}
+				check(rejected, "Creating an existing shared memory object must fail");
+
+				units::shared_memory_region::unlink(name);
+				check(writer.try_push(std::span{ values }.first(1)) && reader.peek().size() == 1, "Mappings must stay valid after unlink");
+			}
+			rejected = false;
+			try
+			{
+				units::shared_memory_region::open(name);
+			}
+			catch (std::system_error const&)
+			{
+				rejected = true;
+			}
+			check(rejected, "Opening an unlinked shared memory object must fail");
+#endif
+		}
+
+		void trigonometry_tests()
+		{
+			using units::angles;
+			using units::quantity;
+			using bam16 = angles::binary_angle<std::uint16_t>;
+			constexpr long double pi = 3.141592653589793238462643383279502884L;
+
+			// Quarter turns are exact in every unit.
+			check(units::sin(quantity<angles::degree>{ 180.0 }) == 0.0 && units::cos(quantity<angles::degree>{ 180.0 }) == -1.0, "sin and cos of 180 degrees must be exact");
+			check(units::sin(quantity<angles::degree>{ 90.0 }) == 1.0 && units::cos(quantity<angles::degree>{ 90.0 }) == 0.0, "sin and cos of 90 degrees must be exact");
+			check(units::sin(quantity<angles::degree>{ -90.0 }) == -1.0 && units::sin(quantity<angles::degree>{ 270.0 }) == -1.0, "sin of -90 and 270 degrees must be exact");
+			check(units::sin(quantity<angles::turn>{ 0.5 }) == 0.0 && units::cos(quantity<angles::gradian>{ 300.0 }) == 0.0, "Quarter turns must be exact in turns and gradians");
+			check(units::sin(quantity<angles::degree>{ 1e7 }) == units::sin(quantity<angles::degree>{ 280.0 }), "Large degree angles must reduce exactly");
+
+			check(units::sin(quantity<bam16>{ 16384 }) == 1.0 && units::cos(quantity<bam16>{ 16384 }) == 0.0, "Incorrect binary angle quarter turn");
+			check(units::sin(quantity<bam16>{ 32768 }) == 0.0 && units::cos(quantity<bam16>{ 49152 }) == 0.0, "Incorrect binary angle half turn");
+			check(std::abs(units::sin(quantity<bam16>{ 8192 }) - std::numbers::sqrt2 / 2) < 2.5e-16, "Incorrect binary angle sin");
+			check(std::abs(units::sin(quantity<bam16>{ 60000 }) - static_cast<double>(std::sin(60000.0L / 65536.0L * 2 * pi))) < 2.5e-16, "Incorrect binary angle sin");
+
+			for (const double x : { 1.0, -2.5, 0.7853981633974483, 100.25, 123456.789, -999999.5 })
+			{
+				const units::sin_cos result = units::sincos(quantity<angles::radian>{ x });
+				check(std::abs(result.sin - static_cast<double>(std::sin(static_cast<long double>(x)))) < 2.5e-16, "Incorrect radian sin");
+				check(std::abs(result.cos - static_cast<double>(std::cos(static_cast<long double>(x)))) < 2.5e-16, "Incorrect radian cos");
+			}
+			for (const double x : { 33.3, -1234.5678, 9800000.123456789, -9999999.7 })
+			{
+				const long double reduced = std::fmod(static_cast<long double>(x), 360.0L) * pi / 180.0L;
+				check(std::abs(units::sin(quantity<angles::degree>{ x }) - static_cast<double>(std::sin(reduced))) < 2.5e-16, "Incorrect degree sin");
+				check(std::abs(units::cos(quantity<angles::degree>{ x }) - static_cast<double>(std::cos(reduced))) < 2.5e-16, "Incorrect degree cos");
+			}
+
+			const std::vector<quantity<angles::degree>> headings{ quantity<angles::degree>{ 0.0 }, quantity<angles::degree>{ 30.0 }, quantity<angles::degree>{ 180.0 }, quantity<angles::degree>{ -45.0 } };
+			std::vector<double> sines(headings.size()), cosines(headings.size());
+			units::sincos(std::span<const quantity<angles::degree>>{ headings }, std::span<double>{ sines }, std::span<double>{ cosines });
+			bool batch_matches = true;
+			for (std::size_t i = 0; i < headings.size(); ++i)
+				batch_matches &= sines[i] == units::sin(headings[i]) && cosines[i] == units::cos(headings[i]);
+			check(batch_matches, "The batch sincos must match the scalar one");
+
+			bool rejected = false;
+			try
+			{
+				units::sin(std::span<const quantity<angles::degree>>{ headings }, std::span<double>{ sines }.first(2));
+			}
+			catch (std::invalid_argument const&)
+			{
+				rejected = true;
+			}
+			check(rejected, "The batch sin must reject spans of different lengths");
+		}
+
+		void histogram_tests()
+		{
+			using units::si;
+			using units::delta;
+			using microsecond = units::micro<si::second>;
+			using histogram = units::hdr_histogram<microsecond>;
+
+			histogram latencies;
+			check(latencies.count() == 0 && latencies.quantile(0.99).value() == 0.0, "An empty histogram must have zero quantiles");
+			for (int i = 1; i <= 1000; ++i)
+				latencies.record(delta<units::milli<si::second>>{ static_cast<double>(i) });
+			check(latencies.count() == 1000, "Incorrect histogram count");
+			check(latencies.min().value() == 1000.0 && latencies.max().value() == 1000000.0, "Incorrect histogram min and max");
+			// Values are exact to 2^-7, and a quantile reports the top of its bucket.
+			const double p50 = latencies.quantile(0.5).value();
+			const double p99 = latencies.quantile(0.99).value();
+			check(p50 >= 500000.0 && p50 <= 500000.0 * (1.0 + 1.0 / 128), "Incorrect histogram median");
+			check(p99 >= 990000.0 && p99 <= 990000.0 * (1.0 + 1.0 / 128), "Incorrect histogram p99");
+			check(latencies.quantile(1.0).value() == 1000000.0 && latencies.quantile(0.0).value() <= 1000.0 * (1.0 + 1.0 / 128), "Incorrect histogram extremes");
+
+			bool rejected = false;
+			try
+			{
+				latencies.quantile(1.5);
+			}
+			catch (std::out_of_range const&)
+			{
+				rejected = true;
+			}
+			check(rejected, "A quantile outside [0, 1] must throw");
+
+			using integer_nanosecond = units::nano<units::si_system_t<std::int64_t>::second>;
+			units::hdr_histogram<integer_nanosecond> overflowing;
+			overflowing.record(delta<si::second>{ 1e30 });
+			overflowing.record(delta<si::second>{ std::numeric_limits<double>::quiet_NaN() });
+			check(overflowing.bucket(units::hdr_histogram<integer_nanosecond>::bucket_count - 1) == 1 && overflowing.bucket(0) == 1, "Out-of-range integer ticks must land in the end buckets");
+
+			// Threads record locally and merge into one shared histogram concurrently.
+			units::shared_hdr_histogram<microsecond> shared;
+			std::vector<std::thread> workers;
+			for (int t = 0; t < 4; ++t)
+				workers.emplace_back([&shared, t]
+				{
+					histogram local;
+					for (int i = 0; i < 250; ++i)
+						local.record(delta<microsecond>{ static_cast<double>(t * 250 + i + 1) });
+					shared.merge(local);
+				});
+			for (auto& worker : workers)
+				worker.join();
+			const histogram merged = shared.snapshot();
+			check(merged.count() == 1000, "Incorrect shared histogram count");
+			check(merged.min().value() == 1.0 && merged.max().value() == 1000.0, "Incorrect shared histogram min and max");
+			check(merged.quantile(0.25).value() >= 250.0 && merged.quantile(0.25).value() <= 250.0 * (1.0 + 1.0 / 128), "Incorrect shared histogram quantile");
+
+			histogram copy = merged;
+			copy.merge(merged);
+			check(copy.count() == 2000 && copy.quantile(0.5).value() == merged.quantile(0.5).value(), "Merging a histogram into itself must double every count");
+		}
+
+		template<class Q>
+		bool sorts_like_std_sort(std::vector<Q> values)
+		{
+			std::vector<Q> expected = values;
+			std::sort(expected.begin(), expected.end(), [](Q const& a, Q const& b) { return a.value() < b.value(); });
+			units::sort(std::span<Q>{ values });
+			for (std::size_t i = 0; i < values.size(); ++i)
+			{
+				if (values[i].value() != expected[i].value())
+					return false;
+			}
+			return true;
+		}
+
+		void algorithm_tests()
+		{
+			using units::quantity;
+			using units::delta;
+
+			// Enough values to take the radix path, with negatives, both zeros and infinities mixed in.
+			std::vector<quantity<runtime_meter>> meters;
+			std::vector<quantity<units::si_system_t<float>::meter>> floats;
+			std::vector<delta<runtime_count>> counts;
+			for (int i = 0; i < 1000; ++i)
+			{
+				const double value = (i * 7919 % 1000 - 500) * 0.37;
+				meters.push_back(quantity<runtime_meter>{ i % 10 == 0 ? -0.0 : i % 10 == 1 ? 0.0 : value });
+				floats.push_back(quantity<units::si_system_t<float>::meter>{ static_cast<float>(i % 97 == 0 ? -std::numeric_limits<double>::infinity() : value) });
+				counts.push_back(delta<runtime_count>{ static_cast<std::int8_t>(i * 37 % 256 - 128) });
+			}
+			floats.back() = quantity<units::si_system_t<float>::meter>{ std::numeric_limits<float>::infinity() };
+			check(sorts_like_std_sort(meters), "Radix sort of doubles must match std::sort");
+			check(sorts_like_std_sort(floats), "Radix sort of floats must match std::sort");
+			check(sorts_like_std_sort(counts), "Radix sort of int8 must match std::sort");
+			check(sorts_like_std_sort(std::vector<delta<runtime_count>>{ delta<runtime_count>{ 5 }, delta<runtime_count>{ -128 }, delta<runtime_count>{ 127 }, delta<runtime_count>{ -1 } }), "Small sorts must match std::sort");
+
+			std::vector<quantity<runtime_meter>> zeros(300, quantity<runtime_meter>{ 0.0 });
+			for (std::size_t i = 0; i < zeros.size(); i += 2)
+				zeros[i] = quantity<runtime_meter>{ -0.0 };
+			units::sort(std::span<quantity<runtime_meter>>{ zeros });
+			check(std::signbit(zeros[149].value()) && !std::signbit(zeros[150].value()), "Radix sort must order -0 before +0");
+
+			// lower_bound converts the key to the unit of the span.
+			const std::vector<quantity<runtime_meter>> sorted{ quantity<runtime_meter>{ -1.0 }, quantity<runtime_meter>{ 0.5 }, quantity<runtime_meter>{ 1.5 }, quantity<runtime_meter>{ 1.5 }, quantity<runtime_meter>{ 3.0 } };
+			const std::span<const quantity<runtime_meter>> view{ sorted };
+			check(units::lower_bound(view, quantity<runtime_millimeter>{ 1500.0 }) - view.begin() == 2, "lower_bound must find the first equal element across units");
+			check(units::lower_bound(view, quantity<runtime_millimeter>{ 1499.0 }) - view.begin() == 2, "lower_bound must find the first greater element across units");
+			check(units::lower_bound(view, quantity<runtime_millimeter>{ -5000.0 }) == view.begin(), "lower_bound below the range must return begin");
+			check(units::lower_bound(view, quantity<runtime_millimeter>{ 3001.0 }) == view.end(), "lower_bound above the range must return end");
+			check(units::lower_bound(std::span<const quantity<runtime_meter>>{}, quantity<runtime_meter>{ 0.0 }) == std::span<const quantity<runtime_meter>>{}.end(), "lower_bound of an empty span must return end");
+
+			std::vector<quantity<runtime_meter>> mixed{ quantity<runtime_meter>{ 2.0 }, quantity<runtime_meter>{ -1.0 }, quantity<runtime_meter>{ 0.75 }, quantity<runtime_meter>{ 4.0 }, quantity<runtime_meter>{ 0.25 } };
+			const std::span<quantity<runtime_meter>> unsorted{ mixed };
+			const auto middle = units::partition(unsorted, quantity<runtime_millimeter>{ 1000.0 });
+			check(middle - unsorted.begin() == 3 && std::all_of(unsorted.begin(), middle, [](auto const& q) { return q.value() < 1.0; })
+				&& std::all_of(middle, unsorted.end(), [](auto const& q) { return q.value() >= 1.0; }), "partition must split at the converted pivot");
+			const auto negative = units::partition(unsorted, [](quantity<runtime_meter> const& q) { return q.value() < 0.0; });
+			check(negative - unsorted.begin() == 1 && unsorted.front().value() == -1.0, "partition must split by the predicate");
+
+			// Equal values hash equally.
+			std::hash<quantity<runtime_meter>> hash_quantity;
+			std::hash<delta<runtime_meter>> hash_delta;
+			check(hash_quantity(quantity<runtime_meter>{ 0.0 }) == hash_quantity(quantity<runtime_meter>{ -0.0 }), "+0 and -0 quantities must hash equally");
+			check(hash_delta(delta<runtime_meter>{ 0.0 }) == hash_delta(delta<runtime_meter>{ -0.0 }), "+0 and -0 deltas must hash equally");
+			check(hash_quantity(quantity<runtime_meter>{ 2.5 }) == hash_quantity(quantity<runtime_meter>{ 5.0 / 2 }), "Equal quantities must hash equally");
+			check(std::hash<delta<runtime_count>>{}(delta<runtime_count>{ -3 }) == std::hash<delta<runtime_count>>{}(delta<runtime_count>{ -3 }), "Equal deltas must hash equally");
+		}
+
+		void parallel_transform_tests()
+		{
+			using units::quantity;
+
+			// An odd-sized range with a small grain, so every worker steals; each index must be visited exactly once.
+			units::thread_pool pool{ 4 };
+			constexpr std::size_t count = 100003;
+			std::vector<std::atomic<int>> visits(count);
+			bool covered = true;
+			for (int run = 0; run < 5; ++run)
+			{
+				for (auto& v : visits)
+					v.store(0, std::memory_order_relaxed);
+				pool.for_each_chunk(count, [&](std::size_t begin, std::size_t end)
+				{
+					for (std::size_t i = begin; i < end; ++i)
+						visits[i].fetch_add(1, std::memory_order_relaxed);
+				}, 7);
+				covered = covered && std::all_of(visits.begin(), visits.end(), [](auto const& v) { return v.load() == 1; });
+			}
+			check(covered, "for_each_chunk must visit every index exactly once");
+
+			std::vector<quantity<runtime_meter>> in(count);
+			for (std::size_t i = 0; i < count; ++i)
+				in[i] = quantity<runtime_meter>{ static_cast<double>(i) * 0.5 };
+			std::vector<quantity<runtime_millimeter>> out(count);
+			const auto convert = [&]
+			{
+				units::parallel_transform(pool, std::span<const quantity<runtime_meter>>{ in }, std::span<quantity<runtime_millimeter>>{ out },
+					[](quantity<runtime_meter> const& x) { return x; }, 13);
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					if (out[i].value() != static_cast<double>(i) * 500.0)
+						return false;
+				}
+				return true;
+			};
+			check(convert(), "parallel_transform must convert every element");
+
+			// An exception stops the loop and is rethrown on the calling thread; the pool stays usable.
+			bool rethrown = false;
+			try
+			{
+				pool.for_each_chunk(count, [](std::size_t begin, std::size_t end)
+				{
+					if (begin <= 50000 && 50000 < end)
+						throw std::runtime_error("chunk failed");
+				}, 7);
+			}
+			catch (std::runtime_error const&)
+			{
+				rethrown = true;
+			}
+			check(rethrown, "for_each_chunk must rethrow an exception from a worker");
+			std::fill(out.begin(), out.end(), quantity<runtime_millimeter>{ -1.0 });
+			check(convert(), "A pool must be reusable after an exception");
+
+			// Parts are contiguous, in worker order, and their boundaries are multiples of align.
+			constexpr std::size_t align = 512;
+			std::vector<std::pair<std::size_t, std::size_t>> parts(pool.size());
+			std::mutex parts_mutex;
+			pool.for_each_part(count, [&](std::size_t begin, std::size_t end)
+			{
+				std::lock_guard lock{ parts_mutex };
+				for (std::size_t w = 0; w < pool.size(); ++w)
+				{
+					if (pool.partition(w, count, align).first == begin)
+						parts[w] = { begin, end };
+				}
+			}, align);
+			bool aligned = parts.front().first == 0 && parts.back().second == count;
+			for (std::size_t w = 0; w < parts.size(); ++w)
+			{
+				aligned = aligned && parts[w] == pool.partition(w, count, align) && parts[w].first % align == 0;
+				if (w + 1 < parts.size())
+					aligned = aligned && parts[w].second == parts[w + 1].first;
+			}
+			check(aligned, "for_each_part must hand each worker its aligned part");
+
+			std::vector<double> touched(count, -1.0);
+			units::first_touch(pool, std::span<double>{ touched }, 2.5);
+			check(std::all_of(touched.begin(), touched.end(), [](double x) { return x == 2.5; }), "first_touch must write every element");
+			const auto fresh = units::make_first_touch_array(pool, 1001, quantity<runtime_meter>{ 3.0 });
+			check(std::all_of(fresh.get(), fresh.get() + 1001, [](auto const& x) { return x.value() == 3.0; }), "make_first_touch_array must initialize every element");
+
+			// A pool of one runs everything inline, in order, on the calling thread.
+			units::thread_pool single{ 1 };
+			const auto caller = std::this_thread::get_id();
+			std::vector<std::size_t> begins;
+			bool inline_thread = true;
+			single.for_each_chunk(100, [&](std::size_t begin, std::size_t end)
+			{
+				inline_thread = inline_thread && std::this_thread::get_id() == caller && end - begin <= 30;
+				begins.push_back(begin);
+			}, 30);
+			check(single.size() == 1 && inline_thread && begins == std::vector<std::size_t>{ 0, 30, 60, 90 }, "A pool of one must run chunks in order");
+			bool on_caller = false;
+			single.for_each_worker([&](std::size_t worker) { on_caller = worker == 0 && std::this_thread::get_id() == caller; });
+			check(on_caller, "A pool of one must run on the calling thread");
+			rethrown = false;
+			try
+			{
+				single.for_each_chunk(10, [](std::size_t, std::size_t) { throw std::runtime_error("inline"); });
+			}
+			catch (std::runtime_error const&)
+			{
+				rethrown = true;
+			}
+			check(rethrown, "A pool of one must propagate exceptions");
+		}
+
+		void thermocouple_tests()
+		{
+			using units::si;
+			using units::quantity;
+			using type_k = units::thermocouples::type_k;
+
+			// The batch agrees with the scalar conversion, including 60 mV, which is above the published range.
+			const std::vector<quantity<type_k>> readings{ quantity<type_k>{ -1.0 }, quantity<type_k>{ 4.096 }, quantity<type_k>{ 30.0 }, quantity<type_k>{ 41.276 }, quantity<type_k>{ 60.0 } };
+			std::vector<quantity<si::kelvin>> kelvins(readings.size());
+			units::evaluate(std::span<const quantity<type_k>>{ readings }, std::span<quantity<si::kelvin>>{ kelvins });
+			bool agrees = true;
+			for (std::size_t i = 0; i < readings.size(); ++i)
+				agrees = agrees && std::abs(kelvins[i].value() - quantity<si::kelvin>{ readings[i] }.value()) < 1e-9;
+			check(agrees, "Batch evaluate must match the scalar conversion");
+			check(std::abs(kelvins.back().value() - 1803.46) < 0.01, "Batch evaluate must extrapolate like the scalar conversion");
+
+			std::vector<quantity<si::celsius>> celsius(readings.size());
+			bool rejected = false;
+			try
+			{
+				units::evaluate_checked(std::span<const quantity<type_k>>{ readings }, std::span<quantity<si::celsius>>{ celsius });
+			}
+			catch (std::out_of_range const&)
+			{
+				rejected = true;
+			}
+			check(rejected && std::abs(celsius.back().value() + 273.15 - kelvins.back().value()) < 1e-9, "evaluate_checked must reject readings outside the curve after filling the batch");
+			units::evaluate_checked(std::span<const quantity<type_k>>{ readings }.first(4), std::span<quantity<si::celsius>>{ celsius }.first(4));
+			check(std::abs(celsius[1].value() - 100.0) < 0.06, "evaluate_checked must convert readings within the curve");
+
+			rejected = false;
+			try
+			{
+				units::evaluate(std::span<const quantity<type_k>>{ readings }, std::span<quantity<si::kelvin>>{ kelvins }.first(2));
+			}
+			catch (std::invalid_argument const&)
+			{
+				rejected = true;
+			}
+			check(rejected, "Batch evaluate must reject spans of different lengths");
+		}
+
+		void lut_tests()
+		{
+			using units::si;
+			using units::quantity;
+			using units::delta;
+			using temperature_axis = units::uniform_axis<si::kelvin, 5>;
+			using length_axis = units::grid_axis<si::meter, 3>;
+
+			// Batches match the scalar lookups, with inputs in another unit and outside the axes.
+			const auto line = units::quantity_lut<si::meter, temperature_axis>::generate(temperature_axis{ quantity<si::kelvin>{ 273.15 }, delta<si::kelvin>{ 25.0 } },
+				[](quantity<si::kelvin> t) { return quantity<si::meter>{ 2 * t.value() }; });
+			const std::vector<quantity<si::celsius>> temperatures{ quantity<si::celsius>{ -40.0 }, quantity<si::celsius>{ 0.0 }, quantity<si::celsius>{ 12.5 }, quantity<si::celsius>{ 50.0 }, quantity<si::celsius>{ 99.9 }, quantity<si::celsius>{ 500.0 } };
+			std::vector<quantity<si::meter>> lengths(temperatures.size());
+			line.evaluate(std::span<const quantity<si::celsius>>{ temperatures }, std::span<quantity<si::meter>>{ lengths });
+			bool matches = true;
+			for (std::size_t i = 0; i < temperatures.size(); ++i)
+				matches = matches && std::abs(lengths[i].value() - line(temperatures[i]).value()) < 1e-9;
+			check(matches, "1D batch lookups must match the scalar lookup");
+			check(std::abs(lengths[3].value() - 646.3) < 1e-9 && lengths[0].value() == line.values()[0] && lengths[5].value() == line.values()[4], "Incorrect 1D batch lookup");
+
+			const auto plane = units::quantity_lut<si::meter, temperature_axis, length_axis>::generate(temperature_axis{ quantity<si::kelvin>{ 0.0 }, delta<si::kelvin>{ 10.0 } },
+				length_axis{ { 0.0, 1.0, 4.0 } }, [](quantity<si::kelvin> t, quantity<si::meter> x) { return quantity<si::meter>{ t.value() + 3 * x.value() }; });
+			const std::vector<quantity<si::kelvin>> xs{ quantity<si::kelvin>{ 15.0 }, quantity<si::kelvin>{ 0.0 }, quantity<si::kelvin>{ 39.0 }, quantity<si::kelvin>{ -5.0 } };
+			const std::vector<quantity<units::milli<si::meter>>> ys{ quantity<units::milli<si::meter>>{ 2500.0 }, quantity<units::milli<si::meter>>{ 1000.0 }, quantity<units::milli<si::meter>>{ 3999.0 }, quantity<units::milli<si::meter>>{ 9000.0 } };
+			std::vector<quantity<si::meter>> heights(xs.size());
+			plane.evaluate(std::span<const quantity<si::kelvin>>{ xs }, std::span<const quantity<units::milli<si::meter>>>{ ys }, std::span<quantity<si::meter>>{ heights });
+			matches = true;
+			for (std::size_t i = 0; i < xs.size(); ++i)
+				matches = matches && std::abs(heights[i].value() - plane(xs[i], ys[i]).value()) < 1e-9;
+			check(matches, "2D batch lookups must match the scalar lookup");
+			check(std::abs(heights[0].value() - 22.5) < 1e-12 && std::abs(heights[3].value() - 12.0) < 1e-12, "Incorrect 2D batch lookup");
+
+			bool rejected = false;
+			try
+			{
+				line.evaluate(std::span<const quantity<si::celsius>>{ temperatures }, std::span<quantity<si::meter>>{ lengths }.first(2));
+			}
+			catch (std::invalid_argument const&)
+			{
+				rejected = true;
+			}
+			check(rejected, "A 1D batch with spans of different lengths must throw");
+			rejected = false;
+			try
+			{
+				plane.evaluate(std::span<const quantity<si::kelvin>>{ xs }, std::span<const quantity<units::milli<si::meter>>>{ ys }.first(3), std::span<quantity<si::meter>>{ heights });
+			}
+			catch (std::invalid_argument const&)
+			{
+				rejected = true;
+			}
+			check(rejected, "A 2D batch with spans of different lengths must throw");
+		}
+
+		void calibration_tests()
+		{
+			using units::si;
+			using units::quantity;
+			using calibration = units::affine_calibration<si::kelvin>;
+
+			// Three channels do not divide the coefficient block, and 50 frames leave a tail after the whole blocks.
+			const std::vector<calibration> channels{ calibration{ 0.5, 273.15 }, calibration{ -0.25, 300.0 }, calibration::from_points(0.0, quantity<si::celsius>{ 0.0 }, 1000.0, quantity<si::celsius>{ 100.0 }) };
+			units::channel_calibration<si::kelvin> calibrations{ channels };
+			constexpr std::size_t frames = 50;
+			std::vector<std::int16_t> raw(frames * channels.size());
+			for (std::size_t i = 0; i < raw.size(); ++i)
+				raw[i] = static_cast<std::int16_t>(static_cast<int>(i * 97 % 2001) - 1000);
+			std::vector<quantity<si::kelvin>> kelvins(raw.size());
+			calibrations.apply(std::span<const std::int16_t>{ raw }, std::span<quantity<si::kelvin>>{ kelvins });
+			bool matches = true;
+			for (std::size_t i = 0; i < raw.size(); ++i)
+				matches = matches && std::abs(kelvins[i].value() - channels[i % channels.size()](raw[i]).value()) < 1e-9;
+			check(calibrations.channels() == 3 && matches, "Interleaved calibration must use each sample's channel, including in the tail");
+
+			calibrations.set(1, calibration{ 2.0, 0.0 });
+			calibrations.apply(std::span<const std::int16_t>{ raw }, std::span<quantity<si::kelvin>>{ kelvins });
+			check(kelvins[raw.size() - 2].value() == 2.0 * raw[raw.size() - 2] && kelvins[4].value() == 2.0 * raw[4], "set must replace a channel in every block");
+
+			const units::channel_calibration<si::celsius> celsius = calibrations.to<si::celsius>();
+			std::vector<quantity<si::celsius>> celsius_values(raw.size());
+			celsius.apply(std::span<const std::int16_t>{ raw }, std::span<quantity<si::celsius>>{ celsius_values });
+			matches = celsius.channels() == 3;
+			for (std::size_t i = 0; i < raw.size(); ++i)
+				matches = matches && std::abs(celsius_values[i].value() - (kelvins[i].value() - 273.15)) < 1e-9;
+			check(matches, "Converted channel calibrations must match the converted results");
+
+			bool rejected = false;
+			try
+			{
+				calibrations.apply(std::span<const std::int16_t>{ raw }.first(raw.size() - 1), std::span<quantity<si::kelvin>>{ kelvins }.first(raw.size() - 1));
+			}
+			catch (std::invalid_argument const&)
+			{
+				rejected = true;
+			}
+			check(rejected, "A partial frame must be rejected");
+			rejected = false;
+			try
+			{
+				calibrations.apply(std::span<const std::int16_t>{ raw }, std::span<quantity<si::kelvin>>{ kelvins }.first(3));
+			}
+			catch (std::invalid_argument const&)
+			{
+				rejected = true;
+			}
+			check(rejected, "Spans of different lengths must be rejected");
+		}
+
+		template<units::overflow_policy Policy>
+		using checked_byte = typename units::data_system_t<units::checked<std::int32_t, Policy>>::byte;
+
+		template<units::overflow_policy Policy>
+		std::vector<units::quantity<checked_byte<Policy>>> checked_bytes(std::initializer_list<std::int32_t> values)
+		{
+			std::vector<units::quantity<checked_byte<Policy>>> result;
+			for (const std::int32_t value : values)
+				result.push_back(units::quantity<checked_byte<Policy>>{ value });
+			return result;
+		}
+
+		template<units::overflow_policy Policy>
+		std::vector<units::delta<checked_byte<Policy>>> checked_byte_deltas(std::initializer_list<std::int32_t> values)
+		{
+			std::vector<units::delta<checked_byte<Policy>>> result;
+			for (const std::int32_t value : values)
+				result.push_back(units::delta<checked_byte<Policy>>{ value });
+			return result;
+		}
+
+		template<class Q>
+		bool checked_values_are(std::vector<Q> const& values, std::initializer_list<std::int32_t> expected)
+		{
+			return std::equal(values.begin(), values.end(), expected.begin(), expected.end(), [](Q const& q, std::int32_t e) { return q.value().value() == e; });
+		}
+
+		void checked_value_tests()
+		{
+			using units::overflow_policy;
+			constexpr std::int32_t max = std::numeric_limits<std::int32_t>::max();
+			constexpr std::int32_t min = std::numeric_limits<std::int32_t>::min();
+
+			// Saturation clamps to whichever end the true result is beyond.
+			{
+				using byte = checked_byte<overflow_policy::saturate>;
+				const auto a = checked_bytes<overflow_policy::saturate>({ max, min, 5, max - 1, -7 });
+				const auto b = checked_byte_deltas<overflow_policy::saturate>({ 1, -1, -8, 1, min });
+				std::vector<units::quantity<byte>> out(a.size());
+				units::checked_add(std::span<const units::quantity<byte>>{ a }, std::span<const units::delta<byte>>{ b }, std::span<units::quantity<byte>>{ out });
+				check(checked_values_are(out, { max, min, -3, max, min }), "checked_add must saturate at both ends");
+				units::checked_scale(std::span<const units::quantity<byte>>{ a }, -2, std::span<units::quantity<byte>>{ out });
+				check(checked_values_are(out, { min, max, -10, min, 14 }), "checked_scale must saturate at both ends");
+			}
+
+			// A trap throws once the batch has been written, and not at all when nothing overflows.
+			{
+				using byte = checked_byte<overflow_policy::trap>;
+				const auto a = checked_bytes<overflow_policy::trap>({ 1, max, 3 });
+				const auto b = checked_byte_deltas<overflow_policy::trap>({ 1, 1, 1 });
+				std::vector<units::quantity<byte>> out(a.size());
+				bool trapped = false;
+				try
+				{
+					units::checked_add(std::span<const units::quantity<byte>>{ a }, std::span<const units::delta<byte>>{ b }, std::span<units::quantity<byte>>{ out });
+				}
+				catch (std::overflow_error const&)
+				{
+					trapped = true;
+				}
+				check(trapped && checked_values_are(out, { 2, min, 4 }), "checked_add must trap after writing wrapped values");
+				units::checked_scale(std::span<const units::quantity<byte>>{ a }.first(1), 7, std::span<units::quantity<byte>>{ out }.first(1));
+				check(out[0].value().value() == 7, "checked_scale must not trap without an overflow");
+				trapped = false;
+				try
+				{
+					units::checked_scale(std::span<const units::quantity<byte>>{ a }, 2, std::span<units::quantity<byte>>{ out });
+				}
+				catch (std::overflow_error const&)
+				{
+					trapped = true;
+				}
+				check(trapped, "checked_scale must trap on an overflow");
+				trapped = false;
+				try
+				{
+					(void)(units::quantity<byte>{ min } - units::delta<byte>{ 1 });
+				}
+				catch (std::overflow_error const&)
+				{
+					trapped = true;
+				}
+				check(trapped, "Scalar checked arithmetic must trap on an overflow");
+			}
+
+			// A report sets the calling thread's flag, which stays set until it is cleared.
+			{
+				using byte = checked_byte<overflow_policy::report>;
+				const auto a = checked_bytes<overflow_policy::report>({ 10, max });
+				const auto b = checked_byte_deltas<overflow_policy::report>({ -20, 0 });
+				std::vector<units::quantity<byte>> out(a.size());
+				units::clear_overflow_report();
+				units::checked_add(std::span<const units::quantity<byte>>{ a }, std::span<const units::delta<byte>>{ b }, std::span<units::quantity<byte>>{ out });
+				check(!units::overflow_reported() && checked_values_are(out, { -10, max }), "checked_add must not report without an overflow");
+				units::checked_scale(std::span<const units::quantity<byte>>{ a }, 3, std::span<units::quantity<byte>>{ out });
+				check(units::overflow_reported() && out[0].value().value() == 30, "checked_scale must report an overflow");
+				bool other_thread = true;
+				std::thread{ [&] { other_thread = units::overflow_reported(); } }.join();
+				check(!other_thread, "The overflow report must be per thread");
+				units::checked_add(std::span<const units::quantity<byte>>{ a }, std::span<const units::delta<byte>>{ b }, std::span<units::quantity<byte>>{ out });
+				check(units::overflow_reported(), "The overflow report must stay set until it is cleared");
+				units::clear_overflow_report();
+				check(!units::overflow_reported(), "clear_overflow_report must clear the report");
+			}
+		}
+
+		void atomic_quantity_tests()
+		{
+			using units::quantity;
+			using units::delta;
+			constexpr int threads = 8;
+			constexpr int iterations = 10000;
+
+			// Floating point fetch_add is a CAS loop: every thread must see a distinct previous value.
+			units::atomic_quantity<runtime_meter> distance;
+			std::vector<std::vector<double>> previous(threads);
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; ++t)
+				workers.emplace_back([&, t]
+				{
+					for (int i = 0; i < iterations; ++i)
+						previous[t].push_back(distance.fetch_add(delta<runtime_millimeter>{ 500.0 }).value());
+				});
+			for (auto& worker : workers)
+				worker.join();
+			workers.clear();
+			std::vector<double> seen;
+			for (auto const& values : previous)
+				seen.insert(seen.end(), values.begin(), values.end());
+			std::sort(seen.begin(), seen.end());
+			bool distinct = true;
+			for (std::size_t i = 0; i < seen.size(); ++i)
+				distinct = distinct && seen[i] == 0.5 * static_cast<double>(i);
+			check(distance.load().value() == 0.5 * threads * iterations && distinct, "Concurrent fetch_add must not lose or repeat updates");
+
+			for (int t = 0; t < threads; ++t)
+				workers.emplace_back([&, t]
+				{
+					for (int i = 0; i < iterations; ++i)
+					{
+						if (t % 2 == 0)
+							distance.fetch_sub(delta<runtime_millimeter>{ 750.0 });
+						else
+							distance += delta<runtime_meter>{ 0.25 };
+					}
+				});
+			for (auto& worker : workers)
+				worker.join();
+			workers.clear();
+			check(distance.load().value() == 0.5 * threads * iterations - 0.5 * (threads / 2) * iterations, "Concurrent fetch_sub and fetch_add must both apply");
+
+			units::atomic_quantity<runtime_tick> ticks{ quantity<runtime_tick>{ 5 } };
+			for (int t = 0; t < threads; ++t)
+				workers.emplace_back([&, t]
+				{
+					for (int i = 0; i < iterations; ++i)
+					{
+						if (t % 2 == 0)
+							ticks.fetch_add(delta<runtime_tick>{ 3 });
+						else
+							ticks.fetch_sub(delta<runtime_tick>{ 1 });
+					}
+				});
+			for (auto& worker : workers)
+				worker.join();
+			workers.clear();
+			check(ticks.load().value() == 5 + 2 * (threads / 2) * iterations, "Concurrent integer fetch_add and fetch_sub must both apply");
+
+			// More threads than shards, so some share a slot; a reader sees a total that never goes down.
+			units::sharded_quantity_counter<runtime_meter, 4> counter;
+			std::atomic<bool> done{ false };
+			bool monotonic = true;
+			std::thread reader{ [&]
+			{
+				double last = 0;
+				while (!done.load())
+				{
+					const double total = counter.total().value();
+					monotonic = monotonic && total >= last;
+					last = total;
+				}
+			} };
+			for (int t = 0; t < threads; ++t)
+				workers.emplace_back([&]
+				{
+					for (int i = 0; i < iterations; ++i)
+						counter += delta<runtime_millimeter>{ 250.0 };
+				});
+			for (auto& worker : workers)
+				worker.join();
+			done.store(true);
+			reader.join();
+			check(monotonic, "A sharded counter's total must not go down while it is being added to");
+			check(counter.total().value() == 0.25 * threads * iterations, "A sharded counter must not lose updates");
+			check(counter.exchange_total().value() == 0.25 * threads * iterations && counter.total().value() == 0.0, "exchange_total must return and reset the total");
+		}
+
+		void arrow_tests()
+		{
+			using units::si;
+			using units::quantity;
+			using kilometer = units::kilo<si::meter>;
+
+			// Same unit: the imported column is a view of the exported storage, which stays alive until it is released.
+			auto storage = std::make_shared<std::vector<quantity<si::meter>>>(std::vector<quantity<si::meter>>{ quantity<si::meter>{ 1.0 }, quantity<si::meter>{ 2.5 }, quantity<si::meter>{ -4.0 } });
+			{
+				ArrowSchema schema;
+				ArrowArray array;
+				units::export_column<si::meter>("distance", std::span<const quantity<si::meter>>{ *storage }, storage, &schema, &array);
+				check(storage.use_count() == 2, "An exported array must hold its owner");
+				{
+					auto column = units::import_column<si::meter>(schema, &array);
+					check(array.release == nullptr, "Importing must move the array");
+					check(!column.converted() && column.values().data() == storage->data() && column.values().size() == 3, "Importing the same unit must not copy");
+					check(storage.use_count() == 2, "A zero-copy column must keep the array alive");
+				}
+				check(storage.use_count() == 1, "Destroying a zero-copy column must release the array");
+				schema.release(&schema);
+				check(schema.release == nullptr, "Releasing a schema must mark it released");
+			}
+
+			// Different scale and value type: the values are converted and the array released straight away.
+			{
+				ArrowSchema schema;
+				ArrowArray array;
+				units::export_column<kilometer>("distance", std::vector<quantity<kilometer>>{ quantity<kilometer>{ 1.5 }, quantity<kilometer>{ -0.25 } }, &schema, &array);
+				auto column = units::import_column<units::si_system_t<float>::meter>(schema, &array);
+				check(column.converted() && column.values().size() == 2, "Importing another unit must convert");
+				check(column.values()[0].value() == 1500.0f && column.values()[1].value() == -250.0f, "Incorrect converted Arrow values");
+				schema.release(&schema);
+			}
+
+			// Wrong dimension: nothing is taken, so the caller still owns the array.
+			{
+				ArrowSchema schema;
+				ArrowArray array;
+				units::export_column<si::second>("elapsed", std::vector<quantity<si::second>>{ quantity<si::second>{ 1.0 } }, &schema, &array);
+				bool rejected = false;
+				try
+				{
+					units::import_column<si::meter>(schema, &array);
+				}
+				catch (std::invalid_argument const&)
+				{
+					rejected = true;
+				}
+				check(rejected, "Importing a different dimension must throw");
+				check(array.release != nullptr, "A rejected import must leave the array with the caller");
+				array.release(&array);
+				schema.release(&schema);
+			}
+
+			// Struct of arrays: children are found by name and imported one by one.
+			{
+				const std::vector<quantity<si::meter>> heights{ quantity<si::meter>{ 10.0 }, quantity<si::meter>{ 20.0 } };
+				const std::vector<quantity<si::second>> times{ quantity<si::second>{ 0.5 }, quantity<si::second>{ 1.5 } };
+				auto owner = std::make_shared<int>(0);
+				ArrowSchema schema;
+				ArrowArray array;
+				units::export_struct("samples", owner, &schema, &array,
+					units::arrow_field<si::meter>{ "height", heights }, units::arrow_field<si::second>{ "time", times });
+				check(std::string_view{ schema.format } == "+s" && schema.n_children == 2 && array.length == 2, "Incorrect Arrow struct");
+				check(owner.use_count() == 3, "Each struct child must hold the owner");
+				const std::ptrdiff_t time = units::arrow_child_index(schema, "time");
+				check(time == 1 && units::arrow_child_index(schema, "missing") == -1, "Incorrect Arrow child lookup");
+				{
+					auto column = units::import_column<units::milli<si::second>>(*schema.children[time], array.children[time]);
+					check(column.values()[1].value() == 1500.0, "Incorrect imported struct child");
+				}
+				check(owner.use_count() == 2, "A converted child must be released on import");
+				array.release(&array);
+				schema.release(&schema);
+				check(owner.use_count() == 1 && array.release == nullptr, "Releasing a struct must release the remaining children");
+			}
+		}
+
+		void pipeline_tests()
+		{
+			using batch = units::quantity_batch<runtime_meter, 4>;
+			batch full;
+			for (int i = 0; i < 4; ++i)
+				full.push_back(1.0);
+			bool threw = false;
+			try
+			{
+				full.push_back(1.0);
+			}
+			catch (std::length_error const&)
+			{
+				threw = true;
+			}
+			check(threw && full.size() == 4, "pushing to a full quantity_batch must throw");
+
+			// Nothing reads the output, so the stage blocks on it; stop must still return.
+			units::spsc_queue<batch> input{ 8 };
+			units::spsc_queue<batch> output{ 2 };
+			units::pipeline_stage<batch, batch, units::normalise_to<runtime_meter>> stage{ input, output };
+			for (int i = 0; i < 6; ++i)
+				input.push(full);
+			stage.stop(std::chrono::milliseconds{ 20 });
+			const units::stage_statistics statistics = stage.statistics();
+			check(statistics.batches == 2 && statistics.dropped == 1, "stopping a stage blocked on its output must drop the batch it holds");
+
+			// A consumer that is slow, but slower than the patience only some of the time: every batch is
+			// either delivered or counted as dropped, never both, and a delivered batch is never counted as dropped.
+			for (int run = 0; run < 3; ++run)
+			{
+				constexpr std::size_t inputs = 16;
+				units::spsc_queue<batch> slow_input{ inputs };
+				units::spsc_queue<batch> slow_output{ 1 };
+				std::atomic<bool> consuming{ true };
+				std::size_t received = 0;
+				units::pipeline_stage<batch, batch, units::normalise_to<runtime_meter>> slow_stage{ slow_input, slow_output };
+				std::thread consumer{ [&]
+				{
+					batch value;
+					int pops = 0;
+					while (consuming.load())
+					{
+						if (slow_output.try_pop(value))
+						{
+							++received;
+							std::this_thread::sleep_for(std::chrono::milliseconds{ ++pops % 3 == 0 ? 4 : 1 });
+						}
+						else
+							std::this_thread::yield();
+					}
+					while (slow_output.try_pop(value))
+						++received;
+				} };
+				for (std::size_t i = 0; i < inputs; ++i)
+					slow_input.push(full);
+				slow_stage.stop(std::chrono::milliseconds{ 2 });
+				consuming.store(false);
+				consumer.join();
+
+				std::size_t left = 0;
+				batch value;
+				while (slow_input.try_pop(value))
+					++left;
+				const units::stage_statistics slow = slow_stage.statistics();
+				check(slow.batches == received, "Every batch counted as delivered must reach the consumer");
+				check(slow.batches + slow.dropped + left == inputs, "Every input batch must be delivered, dropped or left in the input");
+			}
+
+			// A consumer that keeps up within the patience loses nothing.
+			{
+				units::spsc_queue<batch> steady_input{ 8 };
+				units::spsc_queue<batch> steady_output{ 1 };
+				std::atomic<bool> consuming{ true };
+				units::pipeline_stage<batch, batch, units::normalise_to<runtime_meter>> steady_stage{ steady_input, steady_output };
+				std::thread consumer{ [&]
+				{
+					batch value;
+					while (consuming.load() || !steady_output.empty())
+						if (steady_output.try_pop(value))
+							std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+				} };
+				for (int i = 0; i < 8; ++i)
+					steady_input.push(full);
+				steady_stage.stop(std::chrono::milliseconds{ 500 });
+				consuming.store(false);
+				consumer.join();
+				const units::stage_statistics steady = steady_stage.statistics();
+				check(steady.batches == 8 && steady.dropped == 0, "A slow consumer within the patience must not lose batches");
+			}
+		}
+	}
+}
+
+int main()
+{
+	tests::series_compression_tests();
+	tests::pipeline_tests();
+	tests::formula_tests();
+	tests::level_tests();
+	tests::shared_ring_tests();
+	tests::trigonometry_tests();
+	tests::histogram_tests();
+	tests::arrow_tests();
+	tests::algorithm_tests();
+	tests::parallel_transform_tests();
+	tests::thermocouple_tests();
+	tests::lut_tests();
+	tests::calibration_tests();
+	tests::checked_value_tests();
+	tests::atomic_quantity_tests();
+	tests::conversion_trace_tests();
+	if (tests::runtime_failures() == 0)
+		std::printf("runtime tests passed\n");
+	return tests::runtime_failures();
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdio>
+
+namespace tests
+{
+	/*!
+	 * Run-time checks, for the parts of the library that cannot be evaluated at compile time (allocation,
+	 * parsing, threads, shared memory). Each failed check is printed; runtime_tests.cpp returns the number
+	 * of failures from main.
+	 */
+	inline int& runtime_failures()
+	{
+		static int failures = 0;
+		return failures;
+	}
+
+	inline void check(bool condition, const char* message)
+	{
+		if (!condition)
+		{
+			std::fprintf(stderr, "FAILED: %s\n", message);
+			++runtime_failures();
+		}
+	}
+
+	//! Defined in conversion_trace_tests.cpp, which is compiled with CPP_UNITS_TRACE_CONVERSIONS.
+	void conversion_trace_tests();
+}
@@ -1,5 +1,15 @@
 #include "../units/systems/si.hpp"
 #include "../units/quantity.hpp"
+#include "../units/simd_pack.hpp"
+#include "../units/arrow.hpp"
+#include "../units/shared_ring.hpp"
+#include "../units/quantity_lut.hpp"
+#include "../units/hdr_histogram.hpp"
+#include "../units/unit_mdspan.hpp"
+#include "../units/systems/si_constants.hpp"
+#include "../units/calibration.hpp"
+#include "../units/quantized_unit.hpp"
+#include "../units/parallel_transform.hpp"
 
 namespace tests
 {
@@ -16,4 +26,161 @@ namespace tests
 	using namespace units::literals;
 
 	constexpr quantity<si::length> freefall = position(10._sec, quantity<si::acceleration>{-9.8}, quantity<si::velocity>{}, 5000_meter);
-}
\ No newline at end of file
+
+	static_assert(units::similar_units_v<si::meter, units::si_system_t<float>::meter>, "si tags must be shared across value types");
+
+	using pack = units::simd_pack<double, 4>;
+	using vsi = units::si_system_t<pack>;
+	constexpr quantity<vsi::meter> packed = quantity<units::milli<vsi::meter>>{ pack{ 1500.0 } };
+	static_assert(packed.value()[3] == 1.5, "Incorrect packed conversion");
+	constexpr quantity<vsi::length> packed_freefall = quantity<vsi::length>{ pack{ 5000.0 } } + quantity<vsi::acceleration>{ pack{ -9.8 } } * delta<vsi::time>{ pack{ 10.0 } } * delta<vsi::time>{ pack{ 10.0 } };
+	static_assert(packed_freefall.value() == pack{ freefall.value() }, "Incorrect packed arithmetic");
+	static_assert(packed == quantity<units::milli<vsi::meter>>{ pack{ 1500.0 } }, "Packed quantities must compare equal when every lane is equal");
+	static_assert(!(packed == quantity<vsi::meter>{ pack{ 1.0 } }), "Packed quantities must compare unequal when a lane differs");
+	static_assert(!std::three_way_comparable<quantity<vsi::meter>>, "Packed quantities must not be ordered");
+
+	constexpr bool normalizes_to(std::string_view name, std::string_view expected)
+	{
+		std::array<char, 64> buffer{};
+		const std::size_t size = units::detail::normalize_type_name(name, buffer.data());
+		return std::string_view{ buffer.data(), size } == expected;
+	}
+
+	constexpr std::string_view kilometer_metadata{ units::detail::arrow_metadata<units::kilo<si::meter>>.data(), units::detail::arrow_metadata<units::kilo<si::meter>>.size() };
+	static_assert(std::string_view{ units::arrow::format_of<si::meter::value_type>() } == "g", "Incorrect Arrow format");
+	static_assert(kilometer_metadata.find("0x1.f4p+9") != std::string_view::npos, "Incorrect Arrow scale metadata");
+	static_assert(kilometer_metadata.find("tags::meter^1") != std::string_view::npos, "Incorrect Arrow dimension metadata");
+	static_assert(kilometer_metadata.find("units::si_system::tags::meter^1") != std::string_view::npos, "Arrow dimension metadata must use the portable tag name");
+	static_assert(units::detail::portable_type_name<units::tag_of_t<si::meter>>() == "units::si_system::tags::meter", "Portable type names must not depend on the compiler");
+	static_assert(normalizes_to("struct units::si_system::tags::meter", "units::si_system::tags::meter"), "MSVC class keywords must be removed");
+	static_assert(normalizes_to("std::pair<unsigned int, class std::vector<struct x> >", "std::pair<unsigned int,std::vector<x>>"), "Only spaces between identifiers must be kept");
+
+	static_assert(units::unit_fingerprint<si::meter>() == units::unit_fingerprint<units::si_system_t<double>::length>(), "Identical units must share a fingerprint");
+	static_assert(units::unit_fingerprint<si::meter>() != units::unit_fingerprint<units::milli<si::meter>>(), "Fingerprint must include the scale");
+	static_assert(units::unit_fingerprint<si::meter>() != units::unit_fingerprint<units::si_system_t<float>::meter>(), "Fingerprint must include the value type");
+	static_assert(units::unit_fingerprint<si::velocity>() != units::unit_fingerprint<si::acceleration>(), "Fingerprint must include the exponents");
+	static_assert(units::shared_quantity_ring<si::meter>::required_bytes(1024) == units::detail::shared_ring_data_offset + 1024 * sizeof(double), "Incorrect shared ring size");
+
+	constexpr bool close(double a, double b, double tolerance)
+	{
+		return (a < b ? b - a : a - b) <= tolerance;
+	}
+
+	using temperature_axis = units::uniform_axis<si::kelvin, 5>;
+	using length_axis = units::grid_axis<si::meter, 3>;
+	constexpr auto doubled = units::quantity_lut<si::meter, temperature_axis>::generate(temperature_axis{ quantity<si::kelvin>{ 273.15 }, delta<si::kelvin>{ 25.0 } },
+		[](quantity<si::kelvin> t) { return quantity<si::meter>{ 2 * t.value() }; });
+	static_assert(close(doubled(quantity<si::celsius>{ 50.0 }).value(), 646.3, 1e-9), "Incorrect interpolation with a converted input");
+	static_assert(doubled(quantity<si::kelvin>{ 1000.0 }).value() == doubled.values()[4], "Inputs past the axis must clamp");
+
+	constexpr auto plane = units::quantity_lut<si::meter, temperature_axis, length_axis>::generate(temperature_axis{ quantity<si::kelvin>{ 0.0 }, delta<si::kelvin>{ 10.0 } },
+		length_axis{ { 0.0, 1.0, 4.0 } }, [](quantity<si::kelvin> t, quantity<si::meter> x) { return quantity<si::meter>{ t.value() + 3 * x.value() }; });
+	static_assert(close(plane(quantity<si::kelvin>{ 15.0 }, quantity<units::milli<si::meter>>{ 2500.0 }).value(), 22.5, 1e-12), "Incorrect bilinear interpolation");
+
+	using latency_layout = units::detail::hdr_layout<7, 64>;
+	static_assert(latency_layout::index_of(255) == 255 && latency_layout::index_of(256) == 256, "Values below 2^8 must have their own buckets");
+	static_assert(latency_layout::lowest_value(latency_layout::index_of(123456)) <= 123456 && latency_layout::highest_value(latency_layout::index_of(123456)) >= 123456, "Incorrect bucket bounds");
+	static_assert(latency_layout::index_of(~std::uint64_t{ 0 }) == latency_layout::bucket_count - 1, "The largest value must land in the last bucket");
+	static_assert(units::detail::hdr_ticks<units::milli<si::second>>(delta<si::second>{ 0.5 }) == 500, "Incorrect histogram tick conversion");
+	static_assert(units::detail::hdr_ticks<si::second>(delta<si::second>{ std::numeric_limits<double>::quiet_NaN() }) == 0, "NaN must be recorded as zero");
+	static_assert(units::detail::hdr_ticks<si::second>(delta<si::second>{ -std::numeric_limits<double>::infinity() }) == 0, "Negative values must be recorded as zero");
+	static_assert(units::detail::hdr_ticks<si::second>(delta<si::second>{ std::numeric_limits<double>::infinity() }) == ~std::uint64_t{ 0 }, "Infinity must be recorded in the last bucket");
+	static_assert(units::detail::hdr_ticks<units::nano<si::second>>(delta<si::second>{ 1e12 }) == ~std::uint64_t{ 0 }, "Values of 2^63 ticks or more must be recorded in the last bucket");
+	static_assert(units::detail::hdr_ticks<si::second>(delta<si::second>{ 0x1p62 }) == std::uint64_t{ 1 } << 62, "Incorrect large histogram tick conversion");
+	using integer_nanosecond = units::nano<units::si_system_t<std::int64_t>::second>;
+	static_assert(units::detail::hdr_ticks<integer_nanosecond>(delta<si::second>{ 0.5 }) == 500000000, "Incorrect integer histogram tick conversion");
+	static_assert(units::detail::hdr_ticks<integer_nanosecond>(delta<si::second>{ 1e30 }) == ~std::uint64_t{ 0 }, "Values beyond int64 must be clamped before the integer conversion");
+	static_assert(units::detail::hdr_ticks<integer_nanosecond>(delta<si::second>{ std::numeric_limits<double>::quiet_NaN() }) == 0, "NaN must be clamped before the integer conversion");
+	static_assert(units::detail::hdr_ticks<integer_nanosecond>(delta<si::second>{ -std::numeric_limits<double>::infinity() }) == 0, "Negative infinity must be clamped before the integer conversion");
+
+	constexpr double kelvin_field[] = { 273.15, 283.15, 293.15 };
+	static_assert(units::unit_accessor<si::kelvin, si::celsius>{}.access(kelvin_field, 2).value() == 20.0, "Incorrect converting accessor");
+	static_assert(units::quantity_accessor<si::kelvin>{}.access(units::quantity_accessor<si::kelvin>{}.offset(kelvin_field, 1), 0).value() == 283.15, "Incorrect accessor offset");
+	constexpr units::grid_geometry<si::meter, si::second> field_grid{ { quantity<si::meter>{ 1.0 }, quantity<si::second>{ 0.0 } }, { delta<si::meter>{ 0.5 }, delta<si::second>{ 2.0 } } };
+	static_assert(field_grid.coordinate<0>(4).value() == 3.0 && field_grid.coordinate<1>(3).value() == 6.0, "Incorrect grid coordinate");
+	static_assert(field_grid.index<0>(quantity<units::milli<si::meter>>{ 2250.0 }) == 2.5, "Incorrect grid index from a converted coordinate");
+	static_assert(units::similar_units_v<units::derivative_unit_t<si::celsius, si::meter>, units::make_compound_t<si::kelvin, units::inverse_unit<si::meter>>>, "Incorrect derivative unit");
+
+	//! A minimal row-major mdspan stand-in, for compilers without <mdspan>.
+	template<class Accessor, std::size_t Columns>
+	struct grid_view
+	{
+		using element_type = typename Accessor::element_type;
+
+		typename Accessor::data_handle_type data;
+		Accessor accessor{};
+
+		constexpr typename Accessor::reference operator[](std::array<std::size_t, 2> index) const
+		{
+			return accessor.access(data, index[0] * Columns + index[1]);
+		}
+	};
+
+	// T(i, j) = 273.15 K + i^2 + 3 j, on rows 0.5 m apart and columns 2 s apart.
+	constexpr double stencil_field[] = { 273.15, 276.15, 279.15, 274.15, 277.15, 280.15, 277.15, 280.15, 283.15 };
+	constexpr grid_view<units::unit_accessor<si::kelvin, si::celsius>, 3> celsius_view{ stencil_field };
+	static_assert(std::is_same_v<decltype(celsius_view[{ 0, 0 }]), quantity<si::celsius>>, "A read-only accessor must return quantities by value");
+	static_assert(close(celsius_view[{ 2, 1 }].value(), 7.0, 1e-12), "Incorrect read-only converted view");
+	constexpr auto space_derivative = units::central_difference<0>(celsius_view, std::array<std::size_t, 2>{ 1, 1 }, field_grid);
+	static_assert(std::is_same_v<decltype(space_derivative), const delta<units::derivative_unit_t<si::celsius, si::meter>>>, "Incorrect central difference unit");
+	static_assert(close(space_derivative.value(), 4.0, 1e-12), "Incorrect central difference");
+	static_assert(close(units::central_difference<1>(celsius_view, std::array<std::size_t, 2>{ 1, 1 }, field_grid).value(), 1.5, 1e-12), "Incorrect central difference along the second dimension");
+	static_assert(close(units::second_difference<0>(celsius_view, std::array<std::size_t, 2>{ 1, 1 }, field_grid).value(), 8.0, 1e-9), "Incorrect second difference");
+	static_assert(close(units::second_difference<1>(celsius_view, std::array<std::size_t, 2>{ 1, 1 }, field_grid).value(), 0.0, 1e-9), "Incorrect second difference of a linear field");
+
+	constexpr std::array<double, 4> written_field = []
+	{
+		std::array<double, 4> field{ 273.15, 274.15, 275.15, 276.15 };
+		const grid_view<units::unit_accessor<si::kelvin, si::celsius, double>, 2> view{ field.data() };
+		view[{ 0, 1 }] = quantity<si::celsius>{ 100.0 };
+		view[{ 1, 0 }] = view[{ 0, 0 }];
+		return field;
+	}();
+	static_assert(close(written_field[1], 373.15, 1e-12) && close(written_field[2], 273.15, 1e-12), "Writes through converted_reference must convert back to the stored unit");
+	static_assert([]
+	{
+		std::array<quantity<si::kelvin>, 4> field;
+		const grid_view<units::unit_accessor<si::kelvin, si::celsius, quantity<si::kelvin>>, 2> view{ field.data() };
+		view[{ 1, 1 }] = quantity<si::celsius>{ -273.15 };
+		view[{ 1, 0 }] = quantity<si::celsius>{ 0.0 };
+		return field[3].value() == 0.0 && close(field[2].value(), 273.15, 1e-12) && view[{ 1, 0 }].get().value() == 0.0;
+	}(), "Writes through converted_reference must store quantities in the stored unit");
+
+	using molar_gas_unit = units::make_compound_t<si::energy, units::make_inverse_t<units::make_compound_t<si::mole, si::kelvin>>>;
+	static_assert(std::is_empty_v<units::si_constants_t<double>::speed_of_light>, "Constants must take no storage");
+	static_assert(units::similar_units_v<units::si_constants_t<double>::molar_gas::unit_type, molar_gas_unit>, "Products of constants must stay constants");
+	static_assert(close(units::si_constants::r.value(), 8.314462618, 1e-9), "Incorrect molar gas constant");
+	static_assert(quantity<units::make_compound_t<units::kilo<si::meter>, units::inverse_unit<si::second>>>{ units::si_constants::c }.value() == 299792.458, "Incorrect constant conversion");
+	static_assert((quantity<si::meter>{ 599584916.0 } / units::si_constants::c).value() == 2.0, "Incorrect division by a constant");
+	static_assert((delta<si::second>{ 2.0 } * units::si_constants::g_n).value() == 19.6133, "Incorrect delta times a constant");
+
+	constexpr auto thermistor = units::affine_calibration<si::kelvin>::from_points(0.0, quantity<si::celsius>{ 0.0 }, 1000.0, quantity<si::celsius>{ 100.0 });
+	static_assert(close(thermistor(500).value(), 323.15, 1e-9), "Incorrect two-point calibration");
+	static_assert(close(thermistor.to<si::celsius>()(500).value(), 50.0, 1e-9), "Calibration must compose with the static conversion");
+	static_assert(thermistor.to<units::milli<si::kelvin>>().gain == 100.0, "Incorrect composed calibration gain");
+
+	using position_tick = units::quantized_unit<si::meter, units::ratio<10000>, std::int16_t>;
+	static_assert(units::quantize<position_tick>(quantity<si::meter>{ 1.23456 }).value() == 12346, "quantize must round to the nearest tick");
+	static_assert(units::quantize<position_tick>(quantity<units::milli<si::meter>>{ -0.25 }).value() == -3, "quantize must round half away from zero");
+	static_assert(units::quantize<position_tick>(quantity<si::meter>{ 100.0 }).value() == 32767, "quantize must saturate by default");
+	static_assert(units::quantize<position_tick, units::overflow_policy::wrap>(quantity<si::meter>{ 3.2768 }).value() == -32768, "Incorrect wrapping quantize");
+	static_assert(std::is_same_v<decltype((quantity<position_tick>{ 5 } - quantity<position_tick>{ 2 }).value()), std::int16_t>, "Arithmetic on one quantum must stay in the storage type");
+	static_assert(quantity<units::milli<si::meter>>{ quantity<position_tick>{ 15 } }.value() == 1.5, "Incorrect conversion from ticks");
+	static_assert(close(units::dequantize<si::meter>(quantity<position_tick>{ -12346 }).value(), -1.2346, 1e-15), "Incorrect dequantize");
+	using temperature_tick = units::quantized_unit<si::kelvin, units::ratio<100>, std::int32_t>;
+	static_assert(close(quantity<si::celsius>{ quantity<temperature_tick>{ 27315 } }.value(), 0.0, 1e-12), "Offset conversions from ticks must not truncate to whole kelvin");
+	static_assert(units::quantize<temperature_tick>(quantity<si::celsius>{ 25.0 }).value() == 29815, "Incorrect offset conversion to ticks");
+
+	struct identity_transform
+	{
+		template<class Q>
+		constexpr Q operator()(Q value) const { return value; }
+	};
+
+	template<class Out>
+	constexpr bool transforms_meters = requires(units::thread_pool& pool, std::span<const quantity<si::meter>> in, std::span<Out> out)
+	{
+		units::parallel_transform(pool, in, out, identity_transform{});
+	};
+	static_assert(transforms_meters<quantity<units::milli<si::meter>>> && !transforms_meters<quantity<si::second>>, "parallel_transform must check the output unit");
+}
@@ -4,6 +4,13 @@
 #include "../units/exponent_unit.hpp"
 #include "../units/compound_unit.hpp"
 #include "../units/quantity.hpp"
+#include "../units/quantity_stats.hpp"
+#include "../units/group_by.hpp"
+#include "../units/atomic_quantity.hpp"
+#include "../units/series_compression.hpp"
+#include "../units/unit_matrix.hpp"
+#include "../units/pipeline.hpp"
+#include "../units/formula.hpp"
 
 template<class Unit> requires units::Unit<Unit>
 constexpr auto to_fundamental(auto val) { return Unit::to_fundamental(val); }
@@ -104,4 +111,128 @@ namespace static_tests
 	static_assert(p1_sum::value == 0, "Incorrect exponent sum");
 	static_assert(units::similar_units_v<typename p1_t::unit_type, meter>, "Incorrect position type");
 	static_assert(units::similar_units_v<typename p2_t::unit_type, meter>, "Incorrect position type");
+
+	constexpr units::quantity_stats<meter> s1 = []()
+	{
+		units::quantity_stats<meter> stats;
+		stats.add(quantity<meter>{ 1 });
+		stats.add(quantity<meter>{ 2 });
+		stats.add(quantity<millimeter>{ 3000 });
+		stats.add(quantity<meter>{ 4 });
+		return stats;
+	}();
+	static_assert(s1.count() == 4, "Incorrect stats count");
+	static_assert(s1.mean().value() == 2.5, "Incorrect stats mean");
+	static_assert(s1.variance().value() == 1.25, "Incorrect stats variance");
+	static_assert(s1.min().value() == 1 && s1.max().value() == 4, "Incorrect stats range");
+	static_assert(units::similar_units_v<typename decltype(s1.variance())::unit_type, sq_meter>, "Incorrect variance unit");
+
+	constexpr std::array<quantity<meter>, 11> s2_samples{ quantity<meter>{ 4 }, quantity<meter>{ 1 }, quantity<meter>{ 2 }, quantity<meter>{ 3 },
+		quantity<meter>{ 4 }, quantity<meter>{ 1 }, quantity<meter>{ 2 }, quantity<meter>{ 3 }, quantity<meter>{ 4 }, quantity<meter>{ 1 }, quantity<meter>{ 2 } };
+	constexpr units::quantity_stats<meter> s2 = []()
+	{
+		units::quantity_stats<meter> merged;
+		units::quantity_stats<meter> batch;
+		batch.add(std::span<const quantity<meter>>{ s2_samples }.subspan(1));
+		merged.add(s2_samples[0]);
+		merged.merge(batch);
+		return merged;
+	}();
+	static_assert(s2.count() == 11 && s2.sum().value() == 27, "Incorrect merged stats");
+	static_assert(static_abs(s2.mean().value() - 27.0 / 11) < 1e-12, "Incorrect merged mean");
+	static_assert(static_abs(s2.variance().value() - 1.3388429752066118) < 1e-12, "Incorrect merged variance");
+
+	constexpr std::array<std::uint32_t, 6> g_keys{ 7, 3, 7, 3, 7, 9 };
+	constexpr std::array<quantity<meter>, 6> g_values{ quantity<meter>{ 1 }, quantity<meter>{ 2 }, quantity<meter>{ 3 },
+		quantity<meter>{ 4 }, quantity<meter>{ 5 }, quantity<meter>{ 6 } };
+	constexpr units::group_sum<meter> g_sum = units::sum_of(std::span<const quantity<meter>>{ g_values });
+	constexpr units::group_variance<meter> g_variance = units::variance_of(std::span<const quantity<meter>>{ g_values });
+	using g_result = units::group_by_result<std::uint32_t, units::group_sum<meter>, units::group_variance<meter>>;
+	constexpr bool has_group(g_result const& result, std::uint32_t key, std::uint64_t count, double sum, double variance)
+	{
+		for (std::size_t i = 0; i < result.size(); ++i)
+		{
+			if (result.keys()[i] == key)
+				return result.counts()[i] == count && result.column<0>()[i].value() == sum && static_abs(result.column<1>()[i].value() - variance) < 1e-12;
+		}
+		return false;
+	}
+	static_assert([]()
+	{
+		const g_result result = units::group_by(std::span<const std::uint32_t>{ g_keys }, g_sum, g_variance);
+		return result.size() == 3 && has_group(result, 7, 3, 9, 8.0 / 3) && has_group(result, 3, 2, 6, 1) && has_group(result, 9, 1, 6, 0);
+	}(), "Incorrect group_by");
+	static_assert([]()
+	{
+		units::group_table<std::uint32_t, units::group_sum<meter>, units::group_variance<meter>> first;
+		units::group_table<std::uint32_t, units::group_sum<meter>, units::group_variance<meter>> second;
+		first.add(0, 3, std::span<const std::uint32_t>{ g_keys }, g_sum, g_variance);
+		second.add(3, 6, std::span<const std::uint32_t>{ g_keys }, g_sum, g_variance);
+		first.merge(second);
+		return has_group(first.result(), 7, 3, 9, 8.0 / 3) && has_group(first.result(), 3, 2, 6, 1);
+	}(), "Incorrect group_table merge");
+	static_assert(units::similar_units_v<units::group_variance<meter>::result_type::unit_type, sq_meter>, "Incorrect grouped variance unit");
+
+	static_assert(sizeof(units::sharded_quantity_counter<meter, 4>) == 4 * units::detail::cache_line_size, "Incorrect shard padding");
+	static_assert(units::atomic_quantity<meter>::is_always_lock_free == std::atomic<double>::is_always_lock_free, "Incorrect atomic quantity");
+
+	static_assert(quantity<meter>{ 1 } == quantity<millimeter>{ 1000 }, "Incorrect quantity equality");
+	static_assert(quantity<millimeter>{ 999 } < quantity<meter>{ 1 }, "Incorrect quantity ordering");
+	static_assert(quantity<fahrenheit>{ 50 } == quantity<celsius>{ 10 }, "Incorrect offset unit equality");
+	static_assert(delta<fahrenheit>{ 18 } > delta<celsius>{ 9 }, "Incorrect delta ordering");
+	static_assert((quantity<sq_meter>{ 1 } <=> quantity<millimeters2>{ 1000000 }) == 0, "Incorrect compound comparison");
+
+	// Integer comparisons whose cross products overflow are still exact.
+	struct int_meter : units::fundamental_unit<int_meter, std::int64_t> {};
+	using int_kilometer = units::scaled_unit<int_meter, units::ratio<1, 1000>>;
+	using int_sevenths = units::scaled_unit<int_meter, units::ratio<7, 3>>;
+	static_assert(quantity<int_kilometer>{ 9300000000000000 } > quantity<int_meter>{ std::numeric_limits<std::int64_t>::max() }, "Incorrect overflowing comparison");
+	static_assert(quantity<int_meter>{ std::numeric_limits<std::int64_t>::min() } > quantity<int_kilometer>{ -9300000000000000 }, "Incorrect overflowing comparison");
+	static_assert(quantity<int_sevenths>{ 7000000000000000000 } == quantity<int_meter>{ 3000000000000000000 }, "Incorrect overflowing equality");
+	static_assert(quantity<int_sevenths>{ 7000000000000000001 } > quantity<int_meter>{ 3000000000000000000 }, "Incorrect overflowing comparison");
+	static_assert(quantity<int_meter>{ 3000000000000000000 } > quantity<int_sevenths>{ 6999999999999999999 }, "Incorrect overflowing comparison");
+
+	static_assert(units::detail::zigzag_encode(static_cast<std::uint64_t>(-3)) == 5 && units::detail::zigzag_decode(5) == static_cast<std::uint64_t>(-3), "Incorrect zigzag encoding");
+	static_assert(units::detail::series_fingerprint<quantity<meter>>() != units::detail::series_fingerprint<quantity<millimeter>>(), "Series fingerprints must differ by unit");
+	static_assert(units::detail::series_fingerprint<quantity<meter>>() != units::detail::series_fingerprint<units::delta<meter>>(), "Series fingerprints must differ between quantities and deltas");
+	static_assert(sizeof(units::detail::series_block_header) == 24, "Incorrect series block header size");
+
+	using meters_per_second = units::make_compound_t<meter, units::inverse_unit<second>>;
+	using state_units = units::unit_pack<meter, meters_per_second>;
+	using transition = units::unit_matrix<state_units, state_units>;
+	static_assert(units::similar_units_v<transition::element_unit<0, 1>, second>, "Incorrect matrix element unit");
+	static_assert(units::similar_units_v<units::make_inverse_t<units::make_inverse_t<meters_per_second>>, meters_per_second>, "Incorrect double inverse");
+	constexpr auto predicted = []()
+	{
+		transition f = transition::identity();
+		f.set<0, 1>(quantity<second>{ 0.5 });
+		const units::unit_vector<units::unit_pack<millimeter, meters_per_second>> x{ quantity<millimeter>{ 1000 }, quantity<meters_per_second>{ 2 } };
+		return f * x;
+	}();
+	static_assert(predicted.get<0>().value() == 2 && predicted.get<1>().value() == 2, "Incorrect matrix-vector product");
+	constexpr auto covariance = []()
+	{
+		using covariance_type = units::unit_matrix<state_units, units::inverse_pack_t<state_units>>;
+		transition f = transition::identity();
+		f.set<0, 1>(quantity<second>{ 1 });
+		covariance_type p;
+		p.set<1, 1>(quantity<covariance_type::element_unit<1, 1>>{ 4 });
+		return f * p * f.transpose();
+	}();
+	static_assert(covariance.get<0, 0>().value() == 4 && covariance.get<0, 1>().value() == 4, "Incorrect covariance propagation");
+
+	constexpr auto normalised = []()
+	{
+		units::quantity_batch<fahrenheit, 4> batch;
+		batch.push_back(32.0);
+		batch.push_back(212.0);
+		return units::normalise<celsius>(batch);
+	}();
+	static_assert(normalised.size() == 2 && normalised[0].value() == 0 && normalised[1].value() == 100, "Incorrect batch normalisation");
+
+	static_assert(units::runtime_dimension::of<meters2>() == units::runtime_dimension::of<sq_meter>(), "Incorrect runtime dimension");
+	static_assert(units::runtime_dimension::of<meters_per_second>() == units::runtime_dimension::of<meter>() / units::runtime_dimension::of<second>(), "Incorrect runtime dimension");
+	static_assert(!(units::runtime_dimension::of<sq_meter>() == units::runtime_dimension::of<meter>()), "Incorrect runtime dimension");
+	static_assert(units::runtime_unit::of<sq_millimeter>().scale == 1e-6, "Incorrect runtime unit scale");
+	static_assert(static_abs(units::runtime_unit::of<fahrenheit>().to_fundamental(212) - 100) < 1e-12, "Incorrect runtime unit offset");
 }
\ No newline at end of file
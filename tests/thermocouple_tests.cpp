@@ -0,0 +1,41 @@
+#include "../units/systems/thermocouples.hpp"
+#include "../units/systems/si.hpp"
+#include "../units/quantity.hpp"
+#include "../units/polynomial_unit.hpp"
+
+namespace tests
+{
+	using units::thermocouples;
+	using units::si;
+	using units::quantity;
+
+	template<class T>
+	constexpr T thermocouple_abs(T value)
+	{
+		return value < 0 ? -value : value;
+	}
+
+	using type_k = thermocouples::type_k;
+
+	static_assert(units::similar_units_v<type_k, si::kelvin>, "A reading must be similar to the quantity it measures");
+	static_assert(!units::similar_units_v<type_k, thermocouples::millivolt>, "A reading must not be similar to its input unit");
+	static_assert(std::is_same_v<units::difference_unit_t<type_k>, units::difference_unit_t<thermocouples::millivolt>>, "Differences of readings must be in the input unit");
+
+	// ITS-90 reference values: 4.096 mV is 100 celsius, 41.276 mV is 1000 celsius.
+	static_assert(thermocouple_abs(quantity<si::celsius>{ quantity<type_k>{ 4.096 } }.value() - 100.0) < 0.06, "Incorrect type K temperature");
+	static_assert(thermocouple_abs(quantity<si::kelvin>{ quantity<type_k>{ 41.276 } }.value() - 1273.15) < 0.06, "Incorrect type K temperature");
+	static_assert(thermocouples::type_k_curve::piece(-1.0) == 0 && thermocouples::type_k_curve::piece(30.0) == 2, "Incorrect polynomial piece");
+	static_assert(!thermocouples::type_k_curve::contains(60.0), "A reading above the last range must be out of range");
+
+	// Temperatures convert to readings by solving the curve.
+	static_assert(thermocouple_abs(quantity<type_k>{ quantity<si::celsius>{ 500.0 } }.value() - 20.644) < 0.003, "Incorrect type K reading");
+	static_assert(thermocouple_abs(quantity<type_k>{ quantity<si::kelvin>{ quantity<type_k>{ 12.5 } } }.value() - 12.5) < 1e-9, "Readings must round-trip");
+
+	// Coefficients are converted to the natural unit of each term.
+	using kilometer = units::prefixes::kilo<si::meter>;
+	using distance = units::polynomial<si::second, si::meter,
+		units::constant_quantity<kilometer, 1.0>,
+		units::constant_quantity<units::make_compound_t<kilometer, units::inverse_unit<si::second>>, 2.0>>;
+	static_assert(distance::coefficients[0] == 1000.0 && distance::coefficients[1] == 2000.0, "Incorrect polynomial coefficients");
+	static_assert(distance::evaluate(3.0) == 7000.0, "Incorrect polynomial value");
+}
@@ -0,0 +1,171 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "units.hpp"
+#include "quantity.hpp"
+
+namespace units
+{
+	namespace detail
+	{
+		//! Below this size, sort falls back to std::sort.
+		constexpr const std::size_t radix_sort_threshold = 256;
+
+		/*!
+		 * Maps values to unsigned keys whose unsigned order matches the numeric order of the values.
+		 * For floating point values, negative numbers have every bit flipped and positive numbers have
+		 * their sign bit set. NaNs sort after +infinity (or before -infinity if their sign bit is set).
+		 */
+		template<class T>
+		struct radix_key
+		{
+			using key_type = std::conditional_t<sizeof(T) <= 4, std::uint32_t, std::uint64_t>;
+			constexpr static const key_type sign_bit = key_type{ 1 } << (sizeof(T) * 8 - 1);
+
+			static key_type encode(T value)
+			{
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					const auto bits = std::bit_cast<std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>(value);
+					const key_type key = bits;
+					return key ^ (static_cast<key_type>(-static_cast<std::make_signed_t<key_type>>(key >> (sizeof(T) * 8 - 1))) | sign_bit);
+				}
+				else if constexpr (std::is_signed_v<T>)
+					return static_cast<key_type>(static_cast<std::make_unsigned_t<T>>(value)) ^ sign_bit;
+				else
+					return static_cast<key_type>(value);
+			}
+
+			static T decode(key_type key)
+			{
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					const key_type bits = key ^ (((key >> (sizeof(T) * 8 - 1)) - 1) | sign_bit);
+					return std::bit_cast<T>(static_cast<std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>(bits));
+				}
+				else if constexpr (std::is_signed_v<T>)
+					return static_cast<T>(static_cast<std::make_unsigned_t<T>>(key ^ sign_bit));
+				else
+					return static_cast<T>(key);
+			}
+		};
+
+		/*!
+		 * Least significant digit radix sort of keys, 11 bits per pass (6 passes for 64-bit keys,
+		 * 3 for 32-bit keys). Passes where every key has the same digit are skipped, so narrow
+		 * ranges of values only pay for the digits that differ.
+		 */
+		template<class Key>
+		void radix_sort_keys(std::vector<Key>& keys)
+		{
+			constexpr std::size_t digit_bits = 11;
+			constexpr std::size_t buckets = std::size_t{ 1 } << digit_bits;
+			constexpr std::size_t passes = (sizeof(Key) * 8 + digit_bits - 1) / digit_bits;
+			constexpr Key mask = static_cast<Key>(buckets - 1);
+
+			std::vector<std::array<std::size_t, buckets>> histograms(passes);
+			for (const Key key : keys)
+				for (std::size_t pass = 0; pass < passes; ++pass)
+					++histograms[pass][(key >> (pass * digit_bits)) & mask];
+
+			std::vector<Key> buffer(keys.size());
+			for (std::size_t pass = 0; pass < passes; ++pass)
+			{
+				auto& histogram = histograms[pass];
+				if (histogram[(keys.front() >> (pass * digit_bits)) & mask] == keys.size())
+					continue;
+
+				std::size_t offset = 0;
+				for (auto& count : histogram)
+				{
+					const std::size_t current = count;
+					count = offset;
+					offset += current;
+				}
+				for (const Key key : keys)
+					buffer[histogram[(key >> (pass * digit_bits)) & mask]++] = key;
+				keys.swap(buffer);
+			}
+		}
+	}
+
+	/*!
+	 * Sorts a span of quantities or deltas in ascending order. Large arithmetic spans are sorted with
+	 * an LSD radix sort on order-preserving keys, which is O(n) and branch-free per element; small spans
+	 * use std::sort. Unlike std::sort, NaN values are allowed and are placed at the ends.
+	 */
+	template<detail::QuantityOrDelta Q>
+	void sort(std::span<Q> values)
+	{
+		using value_type = typename Q::value_type;
+
+		if constexpr (std::is_arithmetic_v<value_type>)
+		{
+			if (values.size() >= detail::radix_sort_threshold)
+			{
+				using key = detail::radix_key<value_type>;
+				std::vector<typename key::key_type> keys(values.size());
+				for (std::size_t i = 0; i < values.size(); ++i)
+					keys[i] = key::encode(values[i].value());
+				detail::radix_sort_keys(keys);
+				for (std::size_t i = 0; i < values.size(); ++i)
+					values[i] = Q{ key::decode(keys[i]) };
+				return;
+			}
+		}
+
+		std::sort(values.begin(), values.end(), [](Q const& a, Q const& b) { return a.value() < b.value(); });
+	}
+
+	/*!
+	 * Returns an iterator to the first element of the sorted span values that is not less than key.
+	 * The key may be in any SimilarUnits; it is converted to the unit of the span once, then a
+	 * branch-free binary search is done on the raw values.
+	 */
+	template<detail::QuantityOrDelta Q, detail::QuantityOrDelta K>
+	requires std::is_constructible_v<std::remove_cv_t<Q>, K>
+	constexpr typename std::span<Q>::iterator lower_bound(std::span<Q> values, K key)
+	{
+		if (values.empty())
+			return values.end();
+
+		const auto target = std::remove_cv_t<Q>{ key }.value();
+		std::size_t base = 0;
+		std::size_t length = values.size();
+		while (length > 1)
+		{
+			const std::size_t half = length / 2;
+			base = values[base + half].value() < target ? base + half : base;
+			length -= half;
+		}
+		return values.begin() + static_cast<std::ptrdiff_t>(base + (values[base].value() < target ? 1 : 0));
+	}
+
+	/*!
+	 * Reorders values so that every element for which pred returns true precedes every element for
+	 * which it returns false. Returns an iterator to the first element of the second group.
+	 */
+	template<detail::QuantityOrDelta Q, class Predicate>
+	requires std::is_invocable_r_v<bool, Predicate, Q const&>
+	constexpr typename std::span<Q>::iterator partition(std::span<Q> values, Predicate pred)
+	{
+		return std::partition(values.begin(), values.end(), pred);
+	}
+
+	/*!
+	 * Reorders values so that every element less than pivot precedes every other element.
+	 * The pivot may be in any SimilarUnits; it is converted to the unit of the span once.
+	 */
+	template<detail::QuantityOrDelta Q, detail::QuantityOrDelta K>
+	requires std::is_constructible_v<std::remove_cv_t<Q>, K>
+	constexpr typename std::span<Q>::iterator partition(std::span<Q> values, K pivot)
+	{
+		const auto target = std::remove_cv_t<Q>{ pivot }.value();
+		return std::partition(values.begin(), values.end(), [target](Q const& value) { return value.value() < target; });
+	}
+}
@@ -0,0 +1,622 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "runtime_unit.hpp"
+#include "detail/type_name.hpp"
+
+/*!
+ * The Arrow C Data Interface structures, as specified at https://arrow.apache.org/docs/format/CDataInterface.html.
+ * They are guarded with the same macro as Arrow's own abi.h, so this header can be used together with Arrow.
+ */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+	const char* format;
+	const char* name;
+	const char* metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema** children;
+	struct ArrowSchema* dictionary;
+	void (*release)(struct ArrowSchema*);
+	void* private_data;
+};
+
+struct ArrowArray
+{
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void** buffers;
+	struct ArrowArray** children;
+	struct ArrowArray* dictionary;
+	void (*release)(struct ArrowArray*);
+	void* private_data;
+};
+
+#endif
+
+namespace units
+{
+	namespace arrow
+	{
+		/*!
+		 * Metadata key holding the dimension, as "tag^exponent" entries separated by ';'. The tags are
+		 * detail::portable_type_name, so files written by one compiler import with another; see there for
+		 * the names that are still compiler-specific.
+		 */
+		constexpr const std::string_view dimension_key = "cpp_units.dimension";
+		//! Metadata key holding the scale to the fundamental units, as a hexadecimal floating point literal.
+		constexpr const std::string_view scale_key = "cpp_units.scale";
+		//! Metadata key holding the offset to the fundamental units, as a hexadecimal floating point literal.
+		constexpr const std::string_view offset_key = "cpp_units.offset";
+		//! Metadata key holding the name of the unit type, for people reading the schema.
+		constexpr const std::string_view unit_key = "cpp_units.unit";
+
+		/*!
+		 * Meta-function, returns the Arrow format string for a value type. Only arithmetic types have one.
+		 */
+		template<class T>
+		constexpr const char* format_of()
+		{
+			if constexpr (std::is_same_v<T, double>) return "g";
+			else if constexpr (std::is_same_v<T, float>) return "f";
+			else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 8) return "l";
+			else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == 8) return "L";
+			else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4) return "i";
+			else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == 4) return "I";
+			else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 2) return "s";
+			else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == 2) return "S";
+			else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 1) return "c";
+			else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == 1) return "C";
+			else return nullptr;
+		}
+
+		/*!
+		 * Satisfied by units whose quantities can be exported: the value_type has an Arrow format and a
+		 * quantity is laid out exactly like its value.
+		 */
+		template<class UnitType>
+		concept ArrowUnit = Unit<UnitType>
+			&& (format_of<typename UnitType::value_type>() != nullptr)
+			&& sizeof(quantity<UnitType>) == sizeof(typename UnitType::value_type);
+	}
+
+	namespace detail
+	{
+		/*!
+		 * Writes Arrow metadata: an int32 pair count, then each key and value as an int32 length and bytes.
+		 * Integers are native-endian, as the specification requires. With a null out it only counts, which is
+		 * how the size of the compile-time buffer is found.
+		 */
+		struct arrow_metadata_writer
+		{
+			char* out = nullptr;
+			std::size_t size = 0;
+
+			constexpr void put(char c)
+			{
+				if (out)
+					out[size] = c;
+				++size;
+			}
+
+			constexpr void put(std::string_view text)
+			{
+				for (const char c : text)
+					put(c);
+			}
+
+			constexpr void put_int32(std::int32_t value)
+			{
+				const auto bits = static_cast<std::uint32_t>(value);
+				for (int i = 0; i < 4; ++i)
+				{
+					const int byte = std::endian::native == std::endian::little ? i : 3 - i;
+					put(static_cast<char>((bits >> (8 * byte)) & 0xff));
+				}
+			}
+
+			constexpr void patch_int32(std::size_t position, std::int32_t value)
+			{
+				if (!out)
+					return;
+				const std::size_t end = size;
+				size = position;
+				put_int32(value);
+				size = end;
+			}
+
+			constexpr void put_decimal(std::int64_t value)
+			{
+				if (value < 0)
+				{
+					put('-');
+					value = -value;
+				}
+				char digits[20]{};
+				int count = 0;
+				do
+				{
+					digits[count++] = static_cast<char>('0' + value % 10);
+					value /= 10;
+				} while (value != 0);
+				while (count > 0)
+					put(digits[--count]);
+			}
+
+			/*!
+			 * Writes value in the C99 %a form, for example 0x1.8p+0. The text is exact and can be read back
+			 * with std::from_chars, strtod or Python's float.fromhex.
+			 */
+			constexpr void put_hexfloat(double value)
+			{
+				const auto bits = std::bit_cast<std::uint64_t>(value);
+				const auto biased = static_cast<std::int64_t>((bits >> 52) & 0x7ff);
+				std::uint64_t mantissa = bits & ((std::uint64_t{ 1 } << 52) - 1);
+				if (biased == 0x7ff)
+					throw std::domain_error("unit scale and offset must be finite");
+
+				if (bits >> 63)
+					put('-');
+				put("0x");
+				put(biased == 0 ? '0' : '1');
+				if (mantissa != 0)
+				{
+					put('.');
+					for (int digit = 12; digit >= 0 && mantissa != 0; --digit)
+					{
+						put("0123456789abcdef"[(mantissa >> (4 * digit)) & 0xf]);
+						mantissa &= (std::uint64_t{ 1 } << (4 * digit)) - 1;
+					}
+				}
+				const std::int64_t exponent = biased == 0 ? (bits << 1 == 0 ? 0 : -1022) : biased - 1023;
+				put('p');
+				if (exponent >= 0)
+					put('+');
+				put_decimal(exponent);
+			}
+
+			template<class Fn>
+			constexpr void put_pair(std::string_view key, Fn value)
+			{
+				put_int32(static_cast<std::int32_t>(key.size()));
+				put(key);
+				const std::size_t length_at = size;
+				put_int32(0);
+				const std::size_t begin = size;
+				value();
+				patch_int32(length_at, static_cast<std::int32_t>(size - begin));
+			}
+		};
+
+		template<Unit UnitType>
+		constexpr std::size_t write_arrow_metadata(char* out)
+		{
+			constexpr runtime_unit unit = runtime_unit::of<UnitType>();
+			arrow_metadata_writer writer{ out };
+			writer.put_int32(4);
+			writer.put_pair(arrow::dimension_key, [&]
+			{
+				for (std::size_t i = 0; i < unit.dimension.size(); ++i)
+				{
+					if (i != 0)
+						writer.put(';');
+					writer.put(unit.dimension[i].name);
+					writer.put('^');
+					writer.put_decimal(unit.dimension[i].exponent);
+				}
+			});
+			writer.put_pair(arrow::scale_key, [&] { writer.put_hexfloat(unit.scale); });
+			writer.put_pair(arrow::offset_key, [&] { writer.put_hexfloat(unit.offset); });
+			writer.put_pair(arrow::unit_key, [&] { writer.put(portable_type_name<UnitType>()); });
+			return writer.size;
+		}
+
+		/*!
+		 * The schema metadata for UnitType, built at compile time. It has static storage duration, so exported
+		 * schemas point at it directly.
+		 */
+		template<Unit UnitType>
+		inline constexpr auto arrow_metadata = []
+		{
+			std::array<char, write_arrow_metadata<UnitType>(nullptr)> buffer{};
+			write_arrow_metadata<UnitType>(buffer.data());
+			return buffer;
+		}();
+
+		inline std::int32_t read_arrow_int32(const char*& cursor)
+		{
+			std::int32_t value;
+			std::memcpy(&value, cursor, sizeof(value));
+			cursor += sizeof(value);
+			return value;
+		}
+
+		/*!
+		 * Returns the value for key in Arrow metadata, or an empty view if it is absent.
+		 */
+		inline std::string_view find_arrow_metadata(const char* metadata, std::string_view key)
+		{
+			if (!metadata)
+				return {};
+			const char* cursor = metadata;
+			const std::int32_t pairs = read_arrow_int32(cursor);
+			for (std::int32_t i = 0; i < pairs; ++i)
+			{
+				const std::int32_t key_size = read_arrow_int32(cursor);
+				const std::string_view name{ cursor, static_cast<std::size_t>(key_size) };
+				cursor += key_size;
+				const std::int32_t value_size = read_arrow_int32(cursor);
+				const std::string_view value{ cursor, static_cast<std::size_t>(value_size) };
+				cursor += value_size;
+				if (name == key)
+					return value;
+			}
+			return {};
+		}
+
+		inline double parse_hexfloat(std::string_view text)
+		{
+			const bool negative = !text.empty() && text.front() == '-';
+			if (negative)
+				text.remove_prefix(1);
+			if (text.starts_with("0x") || text.starts_with("0X"))
+				text.remove_prefix(2);
+			double value = 0;
+			const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, std::chars_format::hex);
+			if (error != std::errc{} || end != text.data() + text.size())
+				throw std::invalid_argument("malformed unit metadata value '" + std::string{ text } + "'");
+			return negative ? -value : value;
+		}
+
+		/*!
+		 * Reads the runtime_unit of an Arrow field from its metadata. Tag hashes are recomputed from the
+		 * names, the same way runtime_dimension computes them, so the result compares equal to
+		 * runtime_unit::of for the unit that wrote it. The entry names point into the metadata.
+		 *
+		 * @throws std::invalid_argument If the field has no unit metadata or it is malformed.
+		 */
+		inline runtime_unit read_arrow_unit(const ArrowSchema& schema)
+		{
+			const std::string_view dimension = find_arrow_metadata(schema.metadata, arrow::dimension_key);
+			const std::string_view scale = find_arrow_metadata(schema.metadata, arrow::scale_key);
+			const std::string_view offset = find_arrow_metadata(schema.metadata, arrow::offset_key);
+			if (scale.empty() || offset.empty())
+				throw std::invalid_argument("Arrow field has no unit metadata");
+
+			runtime_unit unit;
+			unit.scale = parse_hexfloat(scale);
+			unit.offset = parse_hexfloat(offset);
+			std::string_view rest = dimension;
+			while (!rest.empty())
+			{
+				const std::size_t end = rest.find(';');
+				const std::string_view entry = rest.substr(0, end);
+				rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end + 1);
+
+				const std::size_t caret = entry.rfind('^');
+				if (caret == std::string_view::npos)
+					throw std::invalid_argument("malformed unit dimension '" + std::string{ entry } + "'");
+				const std::string_view name = entry.substr(0, caret);
+				std::int32_t exponent = 0;
+				const auto [ptr, error] = std::from_chars(entry.data() + caret + 1, entry.data() + entry.size(), exponent);
+				if (error != std::errc{} || ptr != entry.data() + entry.size())
+					throw std::invalid_argument("malformed unit dimension '" + std::string{ entry } + "'");
+				unit.dimension.add(fnv1a(name), name, exponent);
+			}
+			return unit;
+		}
+
+		/*!
+		 * Everything an exported schema or array owns. The release callbacks delete it.
+		 */
+		struct arrow_private
+		{
+			std::string name;
+			std::shared_ptr<const void> owner;
+			std::array<const void*, 2> buffers{};
+			std::vector<ArrowSchema> child_schemas;
+			std::vector<ArrowSchema*> child_schema_pointers;
+			std::vector<ArrowArray> child_arrays;
+			std::vector<ArrowArray*> child_array_pointers;
+		};
+
+		inline void release_arrow_schema(ArrowSchema* schema)
+		{
+			for (std::int64_t i = 0; i < schema->n_children; ++i)
+				if (schema->children[i]->release)
+					schema->children[i]->release(schema->children[i]);
+			delete static_cast<arrow_private*>(schema->private_data);
+			schema->release = nullptr;
+		}
+
+		inline void release_arrow_array(ArrowArray* array)
+		{
+			for (std::int64_t i = 0; i < array->n_children; ++i)
+				if (array->children[i]->release)
+					array->children[i]->release(array->children[i]);
+			delete static_cast<arrow_private*>(array->private_data);
+			array->release = nullptr;
+		}
+
+		template<arrow::ArrowUnit UnitType>
+		void export_arrow_field(std::string name, ArrowSchema* schema)
+		{
+			auto data = std::make_unique<arrow_private>();
+			data->name = std::move(name);
+			*schema = ArrowSchema{};
+			schema->format = arrow::format_of<typename UnitType::value_type>();
+			schema->name = data->name.c_str();
+			schema->metadata = arrow_metadata<UnitType>.data();
+			schema->release = &release_arrow_schema;
+			schema->private_data = data.release();
+		}
+
+		template<arrow::ArrowUnit UnitType>
+		void export_arrow_values(std::span<const quantity<UnitType>> values, std::shared_ptr<const void> owner, ArrowArray* array)
+		{
+			auto data = std::make_unique<arrow_private>();
+			data->owner = std::move(owner);
+			data->buffers = { nullptr, values.data() };
+			*array = ArrowArray{};
+			array->length = static_cast<std::int64_t>(values.size());
+			array->n_buffers = 2;
+			array->buffers = data->buffers.data();
+			array->release = &release_arrow_array;
+			array->private_data = data.release();
+		}
+	}
+
+	/*!
+	 * A named column of quantities, for export_struct.
+	 */
+	template<arrow::ArrowUnit UnitType>
+	struct arrow_field
+	{
+		std::string name;
+		std::span<const quantity<UnitType>> values;
+	};
+
+	/*!
+	 * Exports a span of quantities as an Arrow primitive array without copying. The field metadata carries
+	 * the unit (see the arrow:: keys) and is generated at compile time from UnitType.
+	 *
+	 * The array points into values; owner is kept alive until the consumer calls the array's release
+	 * callback, so pass whatever owns the storage. Passing no owner means the caller guarantees values
+	 * outlives the array.
+	 */
+	template<arrow::ArrowUnit UnitType>
+	void export_column(std::string name, std::span<const quantity<UnitType>> values, std::shared_ptr<const void> owner, ArrowSchema* schema, ArrowArray* array)
+	{
+		detail::export_arrow_field<UnitType>(std::move(name), schema);
+		detail::export_arrow_values<UnitType>(values, std::move(owner), array);
+	}
+
+	/*!
+	 * Exports a vector of quantities, moving it into the array so the consumer's release callback frees it.
+	 */
+	template<arrow::ArrowUnit UnitType>
+	void export_column(std::string name, std::vector<quantity<UnitType>>&& values, ArrowSchema* schema, ArrowArray* array)
+	{
+		auto owner = std::make_shared<const std::vector<quantity<UnitType>>>(std::move(values));
+		const std::span<const quantity<UnitType>> view{ *owner };
+		export_column<UnitType>(std::move(name), view, std::move(owner), schema, array);
+	}
+
+	/*!
+	 * Exports structure-of-arrays columns as an Arrow struct array (format "+s") with one child per field.
+	 * The children are zero-copy exactly as in export_column, and each holds a reference to owner.
+	 *
+	 * @throws std::invalid_argument If the fields have different lengths.
+	 */
+	template<arrow::ArrowUnit... UnitTypes>
+	void export_struct(std::string name, std::shared_ptr<const void> owner, ArrowSchema* schema, ArrowArray* array, arrow_field<UnitTypes>... fields)
+	{
+		constexpr std::size_t count = sizeof...(UnitTypes);
+		std::size_t length = 0;
+		((length = fields.values.size()), ...);
+		if (((fields.values.size() != length) || ...))
+			throw std::invalid_argument("export_struct fields must have the same length");
+
+		auto schema_data = std::make_unique<detail::arrow_private>();
+		auto array_data = std::make_unique<detail::arrow_private>();
+		schema_data->name = std::move(name);
+		schema_data->child_schemas.resize(count);
+		array_data->child_arrays.resize(count);
+
+		std::size_t i = 0;
+		((detail::export_arrow_field<UnitTypes>(std::move(fields.name), &schema_data->child_schemas[i]),
+			detail::export_arrow_values<UnitTypes>(fields.values, owner, &array_data->child_arrays[i]), ++i), ...);
+
+		for (auto& child : schema_data->child_schemas)
+			schema_data->child_schema_pointers.push_back(&child);
+		for (auto& child : array_data->child_arrays)
+			array_data->child_array_pointers.push_back(&child);
+
+		*schema = ArrowSchema{};
+		schema->format = "+s";
+		schema->name = schema_data->name.c_str();
+		schema->n_children = static_cast<std::int64_t>(count);
+		schema->children = schema_data->child_schema_pointers.data();
+		schema->release = &detail::release_arrow_schema;
+		schema->private_data = schema_data.release();
+
+		*array = ArrowArray{};
+		array->length = static_cast<std::int64_t>(length);
+		array->n_buffers = 1;
+		array->buffers = array_data->buffers.data();
+		array->n_children = static_cast<std::int64_t>(count);
+		array->children = array_data->child_array_pointers.data();
+		array->release = &detail::release_arrow_array;
+		array->private_data = array_data.release();
+	}
+
+	/*!
+	 * Returns the index of the child of a struct schema with the given name, or -1 if there is none.
+	 */
+	inline std::ptrdiff_t arrow_child_index(const ArrowSchema& schema, std::string_view name)
+	{
+		for (std::int64_t i = 0; i < schema.n_children; ++i)
+			if (schema.children[i]->name && name == schema.children[i]->name)
+				return static_cast<std::ptrdiff_t>(i);
+		return -1;
+	}
+
+	/*!
+	 * An imported Arrow column of quantities. When the field's unit and value type match UnitType the values
+	 * are a view of the Arrow buffer, and the array is released when the column is destroyed; otherwise the
+	 * values were converted into storage owned by the column and the array was released immediately.
+	 */
+	template<arrow::ArrowUnit UnitType>
+	class arrow_column
+	{
+	public:
+
+		arrow_column() = default;
+		arrow_column(arrow_column const&) = delete;
+		arrow_column& operator=(arrow_column const&) = delete;
+
+		arrow_column(arrow_column&& other) noexcept
+			: array_{ std::exchange(other.array_, ArrowArray{}) }, converted_{ std::move(other.converted_) }, values_{ std::exchange(other.values_, {}) }
+		{}
+
+		arrow_column& operator=(arrow_column&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				array_ = std::exchange(other.array_, ArrowArray{});
+				converted_ = std::move(other.converted_);
+				values_ = std::exchange(other.values_, {});
+			}
+			return *this;
+		}
+
+		~arrow_column()
+		{
+			reset();
+		}
+
+		std::span<const quantity<UnitType>> values() const { return values_; }
+
+		//! True if the values had to be converted (and so were copied) on import.
+		bool converted() const { return array_.release == nullptr && !values_.empty(); }
+
+	private:
+
+		template<arrow::ArrowUnit U>
+		friend arrow_column<U> import_column(const ArrowSchema& schema, ArrowArray* array);
+
+		void reset()
+		{
+			if (array_.release)
+				array_.release(&array_);
+			values_ = {};
+		}
+
+		ArrowArray array_{};
+		std::vector<quantity<UnitType>> converted_;
+		std::span<const quantity<UnitType>> values_;
+	};
+
+	namespace detail
+	{
+		template<class Source, arrow::ArrowUnit UnitType>
+		void convert_arrow_values(const void* buffer, std::size_t offset, std::size_t length, runtime_unit const& from, std::vector<quantity<UnitType>>& out)
+		{
+			using value_type = typename UnitType::value_type;
+			constexpr runtime_unit to = runtime_unit::of<UnitType>();
+			const Source* source = static_cast<const Source*>(buffer) + offset;
+			out.resize(length);
+			if (from.scale == to.scale && from.offset == to.offset)
+			{
+				for (std::size_t i = 0; i < length; ++i)
+					out[i] = quantity<UnitType>{ static_cast<value_type>(source[i]) };
+				return;
+			}
+			// Fold both affine maps into one: to = from_value * a + b.
+			const double a = from.scale / to.scale;
+			const double b = (from.offset - to.offset) / to.scale;
+			for (std::size_t i = 0; i < length; ++i)
+				out[i] = quantity<UnitType>{ static_cast<value_type>(static_cast<double>(source[i]) * a + b) };
+		}
+	}
+
+	/*!
+	 * Imports an Arrow primitive array as quantities of UnitType. The dimension recorded in the field metadata
+	 * must match UnitType. If the scale, offset and value type also match, the values are used in place;
+	 * otherwise they are converted, through double, into a new buffer.
+	 *
+	 * Ownership of array moves to the returned column, following the C Data Interface move semantics:
+	 * array->release is set to null. The schema is only read.
+	 *
+	 * @throws std::invalid_argument If the field has no unit metadata, a different dimension, an unsupported
+	 * format, or null values.
+	 */
+	template<arrow::ArrowUnit UnitType>
+	arrow_column<UnitType> import_column(const ArrowSchema& schema, ArrowArray* array)
+	{
+		using value_type = typename UnitType::value_type;
+		constexpr runtime_unit expected = runtime_unit::of<UnitType>();
+
+		const runtime_unit unit = detail::read_arrow_unit(schema);
+		if (unit.dimension != expected.dimension)
+			throw std::invalid_argument("Arrow field '" + std::string{ schema.name ? schema.name : "" } + "' has dimension "
+				+ unit.dimension.to_string() + ", expected " + expected.dimension.to_string());
+		if (array->n_buffers != 2 || (array->buffers[0] != nullptr && array->null_count != 0))
+			throw std::invalid_argument("Arrow field '" + std::string{ schema.name ? schema.name : "" } + "' is not a primitive array without nulls");
+
+		arrow_column<UnitType> column;
+		column.array_ = std::exchange(*array, ArrowArray{});
+		const auto length = static_cast<std::size_t>(column.array_.length);
+		const auto offset = static_cast<std::size_t>(column.array_.offset);
+		const void* buffer = column.array_.buffers[1];
+		const std::string_view format = schema.format ? schema.format : "";
+
+		if (format == arrow::format_of<value_type>() && unit == expected)
+		{
+			column.values_ = { reinterpret_cast<const quantity<UnitType>*>(buffer) + offset, length };
+			return column;
+		}
+
+		if (format == "g") detail::convert_arrow_values<double>(buffer, offset, length, unit, column.converted_);
+		else if (format == "f") detail::convert_arrow_values<float>(buffer, offset, length, unit, column.converted_);
+		else if (format == "l") detail::convert_arrow_values<std::int64_t>(buffer, offset, length, unit, column.converted_);
+		else if (format == "L") detail::convert_arrow_values<std::uint64_t>(buffer, offset, length, unit, column.converted_);
+		else if (format == "i") detail::convert_arrow_values<std::int32_t>(buffer, offset, length, unit, column.converted_);
+		else if (format == "I") detail::convert_arrow_values<std::uint32_t>(buffer, offset, length, unit, column.converted_);
+		else if (format == "s") detail::convert_arrow_values<std::int16_t>(buffer, offset, length, unit, column.converted_);
+		else if (format == "S") detail::convert_arrow_values<std::uint16_t>(buffer, offset, length, unit, column.converted_);
+		else if (format == "c") detail::convert_arrow_values<std::int8_t>(buffer, offset, length, unit, column.converted_);
+		else if (format == "C") detail::convert_arrow_values<std::uint8_t>(buffer, offset, length, unit, column.converted_);
+		else
+			throw std::invalid_argument("unsupported Arrow format '" + std::string{ format } + "'");
+
+		column.array_.release(&column.array_);
+		column.values_ = column.converted_;
+		return column;
+	}
+}
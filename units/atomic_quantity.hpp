@@ -0,0 +1,238 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include "units.hpp"
+#include "quantity.hpp"
+
+namespace units
+{
+	namespace detail
+	{
+		/*!
+		 * Size used to pad per-thread data onto separate cache lines. std::hardware_destructive_interference_size
+		 * is not provided by every standard library, and 64 bytes covers the common targets.
+		 */
+		constexpr const std::size_t cache_line_size = 64;
+
+		/*!
+		 * Adds value to target and returns the previous value. Integer types use the native fetch_add.
+		 * Floating point types use a compare-exchange loop, which is what the hardware provides anyway and
+		 * does not depend on library support for floating point fetch_add.
+		 */
+		template<class T>
+		inline T atomic_fetch_add(std::atomic<T>& target, T value, std::memory_order order)
+		{
+			if constexpr (std::is_integral_v<T>)
+				return target.fetch_add(value, order);
+			else
+			{
+				T expected = target.load(std::memory_order_relaxed);
+				while (!target.compare_exchange_weak(expected, expected + value, order, std::memory_order_relaxed))
+					;
+				return expected;
+			}
+		}
+
+		//! Returns a small index for the calling thread, assigned round-robin on first use.
+		inline std::size_t thread_shard_index()
+		{
+			static std::atomic<std::size_t> next{ 0 };
+			thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+			return index;
+		}
+	}
+
+	/*!
+	 * atomic_quantity is the atomic form of quantity<UnitType>. The value is stored as a
+	 * std::atomic<value_type>, so the unit is never separated from the value. Quantities and deltas
+	 * of SimilarUnits are converted to UnitType before the atomic operation is performed.
+	 */
+	template<Unit UnitType>
+	class atomic_quantity
+	{
+	public:
+
+		using value_type = typename UnitType::value_type;
+		using unit_type = UnitType;
+
+		static constexpr bool is_always_lock_free = std::atomic<value_type>::is_always_lock_free;
+
+		/*!
+		 * Default constructor. Takes an optional initial quantity, otherwise the value is value initialized.
+		 */
+		constexpr explicit atomic_quantity(quantity<UnitType> initial = quantity<UnitType>{})
+			: value_{ initial.value() }
+		{}
+
+		atomic_quantity(atomic_quantity const&) = delete;
+		atomic_quantity& operator=(atomic_quantity const&) = delete;
+
+		/*!
+		 * Atomically loads the current quantity.
+		 */
+		quantity<UnitType> load(std::memory_order order = std::memory_order_seq_cst) const
+		{
+			return quantity<UnitType>{ value_.load(order) };
+		}
+
+		/*!
+		 * Atomically replaces the current quantity with desired, converted to UnitType.
+		 */
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		void store(quantity<unit> desired, std::memory_order order = std::memory_order_seq_cst)
+		{
+			value_.store(quantity<UnitType>{ desired }.value(), order);
+		}
+
+		/*!
+		 * Atomically replaces the current quantity with desired and returns the previous quantity.
+		 */
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		quantity<UnitType> exchange(quantity<unit> desired, std::memory_order order = std::memory_order_seq_cst)
+		{
+			return quantity<UnitType>{ value_.exchange(quantity<UnitType>{ desired }.value(), order) };
+		}
+
+		/*!
+		 * Compares the current quantity with expected and replaces it with desired if they are equal.
+		 * Otherwise, expected is updated with the current quantity. As with std::atomic, the comparison
+		 * is bitwise, so expected should come from a previous load rather than a computed value.
+		 */
+		bool compare_exchange_weak(quantity<UnitType>& expected, quantity<UnitType> desired, std::memory_order order = std::memory_order_seq_cst)
+		{
+			value_type raw = expected.value();
+			const bool exchanged = value_.compare_exchange_weak(raw, desired.value(), order);
+			expected = quantity<UnitType>{ raw };
+			return exchanged;
+		}
+
+		bool compare_exchange_strong(quantity<UnitType>& expected, quantity<UnitType> desired, std::memory_order order = std::memory_order_seq_cst)
+		{
+			value_type raw = expected.value();
+			const bool exchanged = value_.compare_exchange_strong(raw, desired.value(), order);
+			expected = quantity<UnitType>{ raw };
+			return exchanged;
+		}
+
+		/*!
+		 * Atomically adds amount to the current quantity and returns the previous quantity.
+		 *
+		 * @param amount The delta to add. Must satisfy SimilarUnits<UnitType, unit>; the conversion is done before the atomic operation.
+		 */
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		quantity<UnitType> fetch_add(delta<unit> amount, std::memory_order order = std::memory_order_seq_cst)
+		{
+			return quantity<UnitType>{ detail::atomic_fetch_add(value_, delta<UnitType>{ amount }.value(), order) };
+		}
+
+		/*!
+		 * Atomically subtracts amount from the current quantity and returns the previous quantity.
+		 */
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		quantity<UnitType> fetch_sub(delta<unit> amount, std::memory_order order = std::memory_order_seq_cst)
+		{
+			if constexpr (std::is_integral_v<value_type>)
+				return quantity<UnitType>{ value_.fetch_sub(delta<UnitType>{ amount }.value(), order) };
+			else
+				return quantity<UnitType>{ detail::atomic_fetch_add(value_, -delta<UnitType>{ amount }.value(), order) };
+		}
+
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		quantity<UnitType> operator+=(delta<unit> amount)
+		{
+			return fetch_add(amount) + delta<UnitType>{ amount };
+		}
+
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		quantity<UnitType> operator-=(delta<unit> amount)
+		{
+			return fetch_sub(amount) - delta<UnitType>{ amount };
+		}
+
+	private:
+
+		std::atomic<value_type> value_;
+	};
+
+	/*!
+	 * sharded_quantity_counter accumulates deltas from many threads without contending on a single
+	 * cache line. Each thread is assigned one of Shards padded slots on first use and adds into it
+	 * with relaxed atomics; reading the counter sums every slot. Reads are therefore more expensive
+	 * than writes, which suits instrumentation counters that are updated on hot paths and read rarely.
+	 *
+	 * @tparam UnitType The unit the counter accumulates in.
+	 * @tparam Shards The number of slots. Threads beyond this number share slots.
+	 */
+	template<Unit UnitType, std::size_t Shards = 64>
+	class sharded_quantity_counter
+	{
+	public:
+
+		using value_type = typename UnitType::value_type;
+		using unit_type = UnitType;
+
+		sharded_quantity_counter() = default;
+		sharded_quantity_counter(sharded_quantity_counter const&) = delete;
+		sharded_quantity_counter& operator=(sharded_quantity_counter const&) = delete;
+
+		/*!
+		 * Adds amount to the calling thread's slot.
+		 *
+		 * @param amount The delta to add. Must satisfy SimilarUnits<UnitType, unit>.
+		 */
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		void add(delta<unit> amount)
+		{
+			auto& shard = shards_[detail::thread_shard_index() % Shards].value;
+			detail::atomic_fetch_add(shard, delta<UnitType>{ amount }.value(), std::memory_order_relaxed);
+		}
+
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		sharded_quantity_counter& operator+=(delta<unit> amount)
+		{
+			add(amount);
+			return *this;
+		}
+
+		/*!
+		 * Returns the total of every slot. Concurrent adds may or may not be included.
+		 */
+		delta<UnitType> total() const
+		{
+			value_type sum{};
+			for (auto const& shard : shards_)
+				sum += shard.value.load(std::memory_order_relaxed);
+			return delta<UnitType>{ sum };
+		}
+
+		/*!
+		 * Returns the total of every slot and resets each slot to zero.
+		 */
+		delta<UnitType> exchange_total()
+		{
+			value_type sum{};
+			for (auto& shard : shards_)
+				sum += shard.value.exchange(value_type{}, std::memory_order_relaxed);
+			return delta<UnitType>{ sum };
+		}
+
+	private:
+
+		struct alignas(detail::cache_line_size) shard_type
+		{
+			std::atomic<value_type> value{};
+		};
+
+		std::array<shard_type, Shards> shards_;
+	};
+}
\ No newline at end of file
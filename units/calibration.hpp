@@ -0,0 +1,181 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "unit_conversion.hpp"
+
+namespace units
+{
+	/*!
+	 * affine_calibration is a run-time affine map from raw readings to quantity<UnitType>:
+	 * value = raw * gain + offset, with gain and offset in UnitType. The dimension stays a compile-time
+	 * property, so a calibrated thermocouple channel is an affine_calibration<si::kelvin> whatever its
+	 * coefficients are.
+	 *
+	 * to<Other>() folds a static unit conversion into the coefficients, so calibrating and converting
+	 * is still one multiply-add per reading.
+	 *
+	 * @tparam UnitType The unit calibrated values are in. Its value_type must be floating point.
+	 */
+	template<Unit UnitType>
+	requires std::is_floating_point_v<typename UnitType::value_type>
+	struct affine_calibration
+	{
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+
+		value_type gain = 1;
+		value_type offset = 0;
+
+		/*!
+		 * Returns the calibration through two reference points: raw_a reads as a and raw_b reads as b.
+		 *
+		 * @throws std::invalid_argument If raw_a == raw_b.
+		 */
+		template<Unit Other>
+		requires SimilarUnits<UnitType, Other>
+		constexpr static affine_calibration from_points(value_type raw_a, quantity<Other> a, value_type raw_b, quantity<Other> b)
+		{
+			if (raw_a == raw_b)
+				throw std::invalid_argument("affine_calibration reference points must have different raw values");
+			const value_type va = quantity<UnitType>{ a }.value();
+			const value_type vb = quantity<UnitType>{ b }.value();
+			const value_type gain = (vb - va) / (raw_b - raw_a);
+			return affine_calibration{ gain, va - raw_a * gain };
+		}
+
+		template<class Raw>
+		requires std::is_arithmetic_v<Raw>
+		constexpr quantity<UnitType> operator()(Raw raw) const
+		{
+			return quantity<UnitType>{ static_cast<value_type>(raw) * gain + offset };
+		}
+
+		/*!
+		 * The same calibration with results in Other: the static conversion from UnitType to Other is
+		 * applied to the coefficients once, here, instead of to every reading.
+		 */
+		template<Unit Other>
+		requires SimilarUnits<UnitType, Other> && std::is_floating_point_v<typename Other::value_type>
+		constexpr affine_calibration<Other> to() const
+		{
+			constexpr detail::affine_coefficients c = detail::affine_conversion<UnitType, Other>();
+			using other_value = typename Other::value_type;
+			return affine_calibration<Other>{ static_cast<other_value>(gain * c.scale), static_cast<other_value>(offset * c.scale + c.offset) };
+		}
+
+		constexpr bool operator==(affine_calibration const&) const = default;
+	};
+
+	/*!
+	 * channel_calibration applies one affine_calibration per channel to interleaved multi-channel frames,
+	 * where sample i belongs to channel i % channels().
+	 *
+	 * The coefficients are stored repeated over a block of whole frames at least block_samples long, so
+	 * the kernel is a contiguous multiply-add over raw samples and coefficient arrays, with no gather and no
+	 * modulo in the loop, and vectorises for any number of channels.
+	 *
+	 * @tparam UnitType The unit calibrated values are in. Its value_type must be floating point.
+	 */
+	template<Unit UnitType>
+	requires std::is_floating_point_v<typename UnitType::value_type>
+	class channel_calibration
+	{
+	public:
+
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+
+		//! The minimum length of the repeated coefficient block.
+		constexpr static const std::size_t block_samples = 32;
+
+		/*!
+		 * @throws std::invalid_argument If channels is empty.
+		 */
+		explicit channel_calibration(std::span<const affine_calibration<UnitType>> channels)
+			: channels_{ channels.size() }
+		{
+			if (channels_ == 0)
+				throw std::invalid_argument("channel_calibration needs at least one channel");
+			const std::size_t frames = std::max<std::size_t>(1, (block_samples + channels_ - 1) / channels_);
+			gains_.resize(frames * channels_);
+			offsets_.resize(frames * channels_);
+			for (std::size_t i = 0; i < channels_; ++i)
+				set(i, channels[i]);
+		}
+
+		std::size_t channels() const { return channels_; }
+
+		affine_calibration<UnitType> operator[](std::size_t channel) const
+		{
+			return affine_calibration<UnitType>{ gains_[channel], offsets_[channel] };
+		}
+
+		/*!
+		 * Replaces the calibration of one channel, for example after reloading a calibration file.
+		 *
+		 * @throws std::out_of_range If channel >= channels().
+		 */
+		void set(std::size_t channel, affine_calibration<UnitType> calibration)
+		{
+			if (channel >= channels_)
+				throw std::out_of_range("channel_calibration channel out of range");
+			for (std::size_t i = channel; i < gains_.size(); i += channels_)
+			{
+				gains_[i] = calibration.gain;
+				offsets_[i] = calibration.offset;
+			}
+		}
+
+		/*!
+		 * The same calibrations with results in Other; see affine_calibration::to.
+		 */
+		template<Unit Other>
+		requires SimilarUnits<UnitType, Other> && std::is_floating_point_v<typename Other::value_type>
+		channel_calibration<Other> to() const
+		{
+			std::vector<affine_calibration<Other>> converted(channels_);
+			for (std::size_t i = 0; i < channels_; ++i)
+				converted[i] = (*this)[i].template to<Other>();
+			return channel_calibration<Other>{ converted };
+		}
+
+		/*!
+		 * Calibrates interleaved frames: out[i] = raw[i] * gain[i % channels()] + offset[i % channels()].
+		 *
+		 * @throws std::invalid_argument If raw and out have different lengths, or the length is not a whole number of frames.
+		 */
+		template<class Raw>
+		requires std::is_arithmetic_v<Raw>
+		void apply(std::span<const Raw> raw, std::span<quantity<UnitType>> out) const
+		{
+			if (raw.size() != out.size())
+				throw std::invalid_argument("channel_calibration::apply spans must have the same length");
+			if (raw.size() % channels_ != 0)
+				throw std::invalid_argument("channel_calibration::apply needs whole frames");
+
+			const std::size_t block = gains_.size();
+			const value_type* gains = gains_.data();
+			const value_type* offsets = offsets_.data();
+			const Raw* in = raw.data();
+			quantity<UnitType>* result = out.data();
+			std::size_t i = 0;
+			for (; i + block <= raw.size(); i += block)
+				for (std::size_t j = 0; j < block; ++j)
+					result[i + j] = quantity<UnitType>{ static_cast<value_type>(in[i + j]) * gains[j] + offsets[j] };
+			for (std::size_t j = 0; i + j < raw.size(); ++j)
+				result[i + j] = quantity<UnitType>{ static_cast<value_type>(in[i + j]) * gains[j] + offsets[j] };
+		}
+
+	private:
+
+		std::size_t channels_;
+		std::vector<value_type> gains_;
+		std::vector<value_type> offsets_;
+	};
+}
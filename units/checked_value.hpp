@@ -0,0 +1,357 @@
+#pragma once
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "units.hpp"
+#include "quantity.hpp"
+
+namespace units
+{
+	/*!
+	 * What a checked value does when an operation overflows.
+	 */
+	enum class overflow_policy
+	{
+		//! Wrap modulo 2^N, as unsigned arithmetic does. Defined for signed types as well.
+		wrap,
+		//! Clamp to the minimum or maximum value of the type.
+		saturate,
+		//! Throw std::overflow_error.
+		trap,
+		//! Wrap, and set the calling thread's overflow flag. See overflow_reported.
+		report,
+	};
+
+	namespace detail
+	{
+		inline bool& overflow_flag()
+		{
+			thread_local bool flag = false;
+			return flag;
+		}
+
+		template<std::integral T>
+		constexpr bool add_overflow(T a, T b, T& result)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_add_overflow(a, b, &result);
+#else
+			using unsigned_type = std::make_unsigned_t<T>;
+			result = static_cast<T>(static_cast<unsigned_type>(a) + static_cast<unsigned_type>(b));
+			if constexpr (std::is_signed_v<T>)
+				return (a >= 0) == (b >= 0) && (result >= 0) != (a >= 0);
+			else
+				return result < a;
+#endif
+		}
+
+		template<std::integral T>
+		constexpr bool sub_overflow(T a, T b, T& result)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_sub_overflow(a, b, &result);
+#else
+			using unsigned_type = std::make_unsigned_t<T>;
+			result = static_cast<T>(static_cast<unsigned_type>(a) - static_cast<unsigned_type>(b));
+			if constexpr (std::is_signed_v<T>)
+				return (a >= 0) != (b >= 0) && (result >= 0) != (a >= 0);
+			else
+				return b > a;
+#endif
+		}
+
+		template<std::integral T>
+		constexpr bool mul_overflow(T a, T b, T& result)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_mul_overflow(a, b, &result);
+#else
+			using unsigned_type = std::make_unsigned_t<T>;
+			result = static_cast<T>(static_cast<unsigned_type>(a) * static_cast<unsigned_type>(b));
+			if (a == 0 || b == 0)
+				return false;
+			if constexpr (std::is_signed_v<T>)
+			{
+				if ((a == -1 && b == std::numeric_limits<T>::min()) || (b == -1 && a == std::numeric_limits<T>::min()))
+					return true;
+				return result / b != a;
+			}
+			else
+				return a > std::numeric_limits<T>::max() / b;
+#endif
+		}
+
+		/*!
+		 * The value an operation saturates to. For addition and multiplication the sign of the true
+		 * result decides between min and max; negative_result is that sign.
+		 */
+		template<std::integral T>
+		constexpr T saturation_value(bool negative_result)
+		{
+			return negative_result ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+		}
+
+		/*!
+		 * Applies Policy to the result of an operation that may have overflowed. Everything except the
+		 * trap is a select, so when this is inlined into a loop the loop stays branch-free.
+		 */
+		template<overflow_policy Policy, std::integral T>
+		constexpr T resolve_overflow(bool overflowed, T wrapped, bool negative_result)
+		{
+			if constexpr (Policy == overflow_policy::saturate)
+				return overflowed ? saturation_value<T>(negative_result) : wrapped;
+			else if constexpr (Policy == overflow_policy::trap)
+			{
+				if (overflowed)
+					throw std::overflow_error("checked arithmetic overflowed");
+				return wrapped;
+			}
+			else if constexpr (Policy == overflow_policy::report)
+			{
+				if (!std::is_constant_evaluated())
+					overflow_flag() |= overflowed;
+				return wrapped;
+			}
+			else
+				return wrapped;
+		}
+	}
+
+	/*!
+	 * Returns true if a checked operation with overflow_policy::report has overflowed on the calling
+	 * thread since the last call to clear_overflow_report.
+	 */
+	inline bool overflow_reported()
+	{
+		return detail::overflow_flag();
+	}
+
+	inline void clear_overflow_report()
+	{
+		detail::overflow_flag() = false;
+	}
+
+	/*!
+	 * checked is an integer that applies an overflow_policy to +, -, * and /. It is meant to be used as the
+	 * value_type of a unit system, for example data_system_t<checked<std::uint64_t, overflow_policy::trap>>,
+	 * so every quantity and delta operation, and every scale conversion (which multiplies by the ratio of the
+	 * units), is checked without changes to quantity itself.
+	 *
+	 * Overflow is detected with the compiler's overflow builtins where they exist. Division only overflows
+	 * for min / -1 on signed types; division by zero always throws std::domain_error.
+	 *
+	 * @tparam T The underlying integer type.
+	 * @tparam Policy What happens on overflow.
+	 */
+	template<std::integral T, overflow_policy Policy>
+	class checked
+	{
+	public:
+
+		using value_type = T;
+
+		constexpr static const overflow_policy policy = Policy;
+
+		constexpr checked() = default;
+
+		//! Implicit, so literals such as the 1 passed to to_fundamental convert without a cast.
+		constexpr checked(T value)
+			: value_{ value }
+		{}
+
+		/*!
+		 * Converts from another integer type. Under saturate the value is clamped; under every other policy a
+		 * value that does not fit is treated as an overflow.
+		 */
+		template<std::integral Other>
+		requires (!std::is_same_v<Other, T>)
+		constexpr explicit checked(Other value)
+			: value_{ convert(value) }
+		{}
+
+		constexpr T value() const { return value_; }
+		constexpr explicit operator T() const { return value_; }
+
+		friend constexpr checked operator+(checked a, checked b)
+		{
+			T result{};
+			const bool overflowed = detail::add_overflow(a.value_, b.value_, result);
+			return checked{ detail::resolve_overflow<Policy>(overflowed, result, b.value_ < T{}) };
+		}
+
+		friend constexpr checked operator-(checked a, checked b)
+		{
+			T result{};
+			const bool overflowed = detail::sub_overflow(a.value_, b.value_, result);
+			// Subtracting a larger unsigned value, or a positive value, overflows towards the minimum.
+			const bool negative = std::is_signed_v<T> ? b.value_ > T{} : true;
+			return checked{ detail::resolve_overflow<Policy>(overflowed, result, negative) };
+		}
+
+		friend constexpr checked operator*(checked a, checked b)
+		{
+			T result{};
+			const bool overflowed = detail::mul_overflow(a.value_, b.value_, result);
+			return checked{ detail::resolve_overflow<Policy>(overflowed, result, (a.value_ < T{}) != (b.value_ < T{})) };
+		}
+
+		friend constexpr checked operator/(checked a, checked b)
+		{
+			if (b.value_ == T{})
+				throw std::domain_error("checked division by zero");
+			if constexpr (std::is_signed_v<T>)
+			{
+				if (a.value_ == std::numeric_limits<T>::min() && b.value_ == T{ -1 })
+					return checked{ detail::resolve_overflow<Policy>(true, a.value_, false) };
+			}
+			return checked{ static_cast<T>(a.value_ / b.value_) };
+		}
+
+		constexpr checked operator-() const
+		{
+			return checked{ T{} } - *this;
+		}
+
+		constexpr checked& operator+=(checked other) { return *this = *this + other; }
+		constexpr checked& operator-=(checked other) { return *this = *this - other; }
+		constexpr checked& operator*=(checked other) { return *this = *this * other; }
+		constexpr checked& operator/=(checked other) { return *this = *this / other; }
+
+		/*!
+		 * Mixed operations with plain integers, as used by ratio::apply (Num * value / Den). The integer is
+		 * converted to T under the same policy first.
+		 */
+		template<std::integral Other>
+		requires (!std::is_same_v<Other, T>)
+		friend constexpr checked operator*(Other a, checked b) { return checked{ a } * b; }
+
+		template<std::integral Other>
+		requires (!std::is_same_v<Other, T>)
+		friend constexpr checked operator*(checked a, Other b) { return a * checked{ b }; }
+
+		template<std::integral Other>
+		requires (!std::is_same_v<Other, T>)
+		friend constexpr checked operator/(checked a, Other b) { return a / checked{ b }; }
+
+		friend constexpr bool operator==(checked, checked) = default;
+		friend constexpr auto operator<=>(checked, checked) = default;
+
+	private:
+
+		template<std::integral Other>
+		static constexpr T convert(Other value)
+		{
+			if (std::in_range<T>(value))
+				return static_cast<T>(value);
+			const bool negative = value < Other{};
+			return detail::resolve_overflow<Policy>(true, static_cast<T>(value), negative);
+		}
+
+		T value_{};
+	};
+
+	namespace detail
+	{
+		template<class T>
+		struct is_checked : std::false_type {};
+
+		template<std::integral T, overflow_policy Policy>
+		struct is_checked<checked<T, Policy>> : std::true_type {};
+
+		/*!
+		 * Runs op over every element, applying the policy of the value type once for the whole batch.
+		 * op returns the overflow flag and writes the wrapped result and the sign of the true result; the loop
+		 * only selects and accumulates, so it has no branches and vectorises. A trap or report happens after
+		 * the loop, so with overflow_policy::trap the output has been written (with wrapped values) when the
+		 * exception is thrown.
+		 */
+		template<class Checked, class Op>
+		void checked_batch(std::size_t count, Checked* out, Op op)
+		{
+			using T = typename Checked::value_type;
+			bool any = false;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				T wrapped{};
+				bool negative = false;
+				const bool overflowed = op(i, wrapped, negative);
+				any |= overflowed;
+				if constexpr (Checked::policy == overflow_policy::saturate)
+					wrapped = overflowed ? saturation_value<T>(negative) : wrapped;
+				out[i] = Checked{ wrapped };
+			}
+			if constexpr (Checked::policy == overflow_policy::trap)
+			{
+				if (any)
+					throw std::overflow_error("checked arithmetic overflowed");
+			}
+			else if constexpr (Checked::policy == overflow_policy::report)
+				overflow_flag() |= any;
+		}
+	}
+
+	/*!
+	 * out[i] = a[i] + b[i] for quantities with a checked value_type. The policy is applied per batch: the
+	 * loop body is branch-free, and a trap or report happens once at the end.
+	 *
+	 * @throws std::invalid_argument If the spans have different lengths.
+	 */
+	template<Unit UnitType>
+	requires detail::is_checked<typename UnitType::value_type>::value
+	void checked_add(std::span<const quantity<UnitType>> a, std::span<const delta<UnitType>> b, std::span<quantity<UnitType>> out)
+	{
+		using checked_type = typename UnitType::value_type;
+		using T = typename checked_type::value_type;
+		if (a.size() != b.size() || a.size() != out.size())
+			throw std::invalid_argument("checked_add spans must have the same length");
+
+		static_assert(sizeof(quantity<UnitType>) == sizeof(checked_type));
+		detail::checked_batch(a.size(), reinterpret_cast<checked_type*>(out.data()), [&](std::size_t i, T& result, bool& negative)
+		{
+			const T rhs = b[i].value().value();
+			negative = rhs < T{};
+			return detail::add_overflow(a[i].value().value(), rhs, result);
+		});
+	}
+
+	/*!
+	 * out[i] = a[i] * factor for quantities with a checked value_type, with the policy applied per batch.
+	 *
+	 * @throws std::invalid_argument If the spans have different lengths.
+	 */
+	template<Unit UnitType>
+	requires detail::is_checked<typename UnitType::value_type>::value
+	void checked_scale(std::span<const quantity<UnitType>> a, typename UnitType::value_type::value_type factor, std::span<quantity<UnitType>> out)
+	{
+		using checked_type = typename UnitType::value_type;
+		using T = typename checked_type::value_type;
+		if (a.size() != out.size())
+			throw std::invalid_argument("checked_scale spans must have the same length");
+
+		static_assert(sizeof(quantity<UnitType>) == sizeof(checked_type));
+		detail::checked_batch(a.size(), reinterpret_cast<checked_type*>(out.data()), [&](std::size_t i, T& result, bool& negative)
+		{
+			const T value = a[i].value().value();
+			negative = (value < T{}) != (factor < T{});
+			return detail::mul_overflow(value, factor, result);
+		});
+	}
+}
+
+/*!
+ * std::hash for checked, so quantities with a checked value_type can be hashed.
+ */
+template<std::integral T, units::overflow_policy Policy>
+struct std::hash<units::checked<T, Policy>>
+{
+	std::size_t operator()(units::checked<T, Policy> const& value) const noexcept
+	{
+		return std::hash<T>{}(value.value());
+	}
+};
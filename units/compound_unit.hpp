@@ -5,6 +5,7 @@
 #include "detail/unit_comparisons.hpp"
 #include "exponent_unit.hpp"
 #include "difference_unit.hpp"
+#include "unit_scale.hpp"
 
 namespace units
 {
@@ -246,6 +247,32 @@ namespace units
 		using type = make_exponent_t<T, ExponentA::value + ExponentB::value>;
 	};
 
+	/*!
+	 * Meta-function for making the inverse of a unit. Unlike inverse_unit, which always wraps its
+	 * argument in an exponent_unit, make_inverse distributes over compound units and negates
+	 * existing exponents, so inverting twice gives back a unit the comparison meta-functions understand.
+	 */
+	template<Unit A>
+	struct make_inverse
+	{
+		using type = inverse_unit<A>;
+	};
+
+	template<Unit A>
+	using make_inverse_t = typename make_inverse<A>::type;
+
+	template<Unit T, class Exponent>
+	struct make_inverse<exponent_unit<T, Exponent>>
+	{
+		using type = std::conditional_t<Exponent::value == -1, T, make_exponent_t<T, -Exponent::value>>;
+	};
+
+	template<Unit ...Units>
+	struct make_inverse<compound_unit<Units...>>
+	{
+		using type = compound_unit<make_inverse_t<Units>...>;
+	};
+
 	/*!
 	 * Specialization for difference_unit. The difference unit of a compound unit
 	 * is compound_unit of the difference_unit of its types.
@@ -255,4 +282,13 @@ namespace units
 	{
 		using type = compound_unit<difference_unit_t<units>...>;
 	};
+
+	/*!
+	 * Specialization of unit_scale for compound_unit. The scale is the product of the scales of its units.
+	 */
+	template<Unit ...units>
+	struct unit_scale<compound_unit<units...>>
+	{
+		constexpr static const detail::scale_factor value = (detail::scale_factor{} * ... * unit_scale_v<units>);
+	};
 }
\ No newline at end of file
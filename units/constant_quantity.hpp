@@ -0,0 +1,128 @@
+#pragma once
+#include <type_traits>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "compound_unit.hpp"
+#include "exponent_unit.hpp"
+
+namespace units
+{
+	/*!
+	 * constant_quantity is a quantity whose value is part of its type, for physical constants and fixed
+	 * factors. It is empty, so it takes no storage in the objects that hold it, and arithmetic with it
+	 * folds at compile time:
+	 * - constant * constant and constant / constant are constants, so R = N_A * k_B is a type, not a product;
+	 * - constant * quantity is a single multiply by an immediate;
+	 * - quantity / constant is a multiply by the reciprocal, which is computed at compile time. A run-time
+	 *   divisor has to be divided by, because x / c and x * (1 / c) can differ in the last bit; the
+	 *   reciprocal is the rounding this type chooses, so the result may differ from quantity / quantity
+	 *   by one ulp for floating point value types.
+	 *
+	 * A constant converts to a quantity of any SimilarUnits; the converted value is a constant expression.
+	 *
+	 * @tparam UnitType The unit of the constant.
+	 * @tparam Value The value, as UnitType::value_type. Floating point template arguments need C++20.
+	 */
+	template<Unit UnitType, typename UnitType::value_type Value>
+	struct constant_quantity
+	{
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+
+		constexpr static value_type value() { return Value; }
+
+		template<Unit Other>
+		requires SimilarUnits<UnitType, Other>
+		constexpr operator quantity<Other>() const
+		{
+			return converted<Other>;
+		}
+
+		template<Unit Other>
+		requires SimilarUnits<UnitType, Other>
+		constexpr explicit operator delta<Other>() const
+		{
+			return delta<Other>{ delta<UnitType>{ Value } };
+		}
+
+	private:
+
+		template<Unit Other>
+		constexpr static const quantity<Other> converted = quantity<Other>{ quantity<UnitType>{ Value } };
+	};
+
+	namespace detail
+	{
+		/*!
+		 * 1 / Value, evaluated once at compile time. Integer value types have no useful reciprocal, so
+		 * dividing by an integer constant still divides.
+		 */
+		template<class T, T Value>
+		constexpr const T reciprocal = T{ 1 } / Value;
+	}
+
+	template<Unit A, typename A::value_type a, Unit B, typename B::value_type b>
+	constexpr inline auto operator*(constant_quantity<A, a>, constant_quantity<B, b>)
+	{
+		using result = make_compound_t<A, B>;
+		return constant_quantity<result, static_cast<typename result::value_type>(a * b)>{};
+	}
+
+	template<Unit A, typename A::value_type a, Unit B, typename B::value_type b>
+	constexpr inline auto operator/(constant_quantity<A, a>, constant_quantity<B, b>)
+	{
+		using result = make_compound_t<A, make_inverse_t<B>>;
+		return constant_quantity<result, static_cast<typename result::value_type>(a / b)>{};
+	}
+
+	template<Unit A, typename A::value_type a, Unit B>
+	constexpr inline quantity<make_compound_t<A, B>> operator*(constant_quantity<A, a>, quantity<B> b)
+	{
+		return quantity<make_compound_t<A, B>>{ static_cast<typename make_compound_t<A, B>::value_type>(a * b.value()) };
+	}
+
+	template<Unit A, Unit B, typename B::value_type b>
+	constexpr inline quantity<make_compound_t<A, B>> operator*(quantity<A> a, constant_quantity<B, b>)
+	{
+		return quantity<make_compound_t<A, B>>{ static_cast<typename make_compound_t<A, B>::value_type>(a.value() * b) };
+	}
+
+	template<Unit A, typename A::value_type a, Unit B>
+	constexpr inline delta<make_compound_t<A, B>> operator*(constant_quantity<A, a>, delta<B> b)
+	{
+		return delta<make_compound_t<A, B>>{ static_cast<typename make_compound_t<A, B>::value_type>(a * b.value()) };
+	}
+
+	template<Unit A, Unit B, typename B::value_type b>
+	constexpr inline delta<make_compound_t<A, B>> operator*(delta<A> a, constant_quantity<B, b>)
+	{
+		return delta<make_compound_t<A, B>>{ static_cast<typename make_compound_t<A, B>::value_type>(a.value() * b) };
+	}
+
+	template<Unit A, typename A::value_type a, Unit B>
+	constexpr inline quantity<make_compound_t<A, make_inverse_t<B>>> operator/(constant_quantity<A, a>, quantity<B> b)
+	{
+		using result = make_compound_t<A, make_inverse_t<B>>;
+		return quantity<result>{ static_cast<typename result::value_type>(a / b.value()) };
+	}
+
+	template<Unit A, Unit B, typename B::value_type b>
+	constexpr inline quantity<make_compound_t<A, make_inverse_t<B>>> operator/(quantity<A> a, constant_quantity<B, b>)
+	{
+		using result = make_compound_t<A, make_inverse_t<B>>;
+		if constexpr (std::is_floating_point_v<typename B::value_type>)
+			return quantity<result>{ static_cast<typename result::value_type>(a.value() * detail::reciprocal<typename B::value_type, b>) };
+		else
+			return quantity<result>{ static_cast<typename result::value_type>(a.value() / b) };
+	}
+
+	template<Unit A, Unit B, typename B::value_type b>
+	constexpr inline delta<make_compound_t<A, make_inverse_t<B>>> operator/(delta<A> a, constant_quantity<B, b>)
+	{
+		using result = make_compound_t<A, make_inverse_t<B>>;
+		if constexpr (std::is_floating_point_v<typename B::value_type>)
+			return delta<result>{ static_cast<typename result::value_type>(a.value() * detail::reciprocal<typename B::value_type, b>) };
+		else
+			return delta<result>{ static_cast<typename result::value_type>(a.value() / b) };
+	}
+}
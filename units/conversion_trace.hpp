@@ -0,0 +1,128 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "detail/type_name.hpp"
+
+/*!
+ * Conversion tracing. Define CPP_UNITS_TRACE_CONVERSIONS and every run-time call to
+ * unit_conversion<From, To>::convert increments a counter for the (From, To) pair. The converting constructors and assignments of quantity and delta,
+ * and the comparisons between different units, all go through unit_conversion, so they are counted too;
+ * a delta conversion is counted under the difference units. Conversions evaluated at compile time are
+ * not counted.
+ *
+ * Counters are thread_local, so counting is a plain increment; read them from the thread that did the
+ * work. Without CPP_UNITS_TRACE_CONVERSIONS unit_conversion does not include this header and the
+ * conversion code is unchanged.
+ *
+ * The macro changes the definition of unit_conversion<From, To>::convert, so it must be set for the whole
+ * program, on the compiler command line. If some translation units define it and others do not, a
+ * conversion used in both has two different definitions. That is an ODR violation: the linker keeps one of
+ * them, and counts go missing or the untraced code pays for tracing. Only conversions between units with
+ * internal linkage, such as units declared in an anonymous namespace, are safe to trace in one file.
+ */
+namespace units
+{
+	struct conversion_count
+	{
+		std::string_view from;
+		std::string_view to;
+		std::uint64_t count = 0;
+	};
+
+	namespace detail
+	{
+		inline std::vector<std::unique_ptr<conversion_count>>& conversion_counters()
+		{
+			thread_local std::vector<std::unique_ptr<conversion_count>> counters;
+			return counters;
+		}
+
+		inline conversion_count& register_conversion_counter(std::string_view from, std::string_view to)
+		{
+			auto& counters = conversion_counters();
+			counters.push_back(std::make_unique<conversion_count>(conversion_count{ from, to, 0 }));
+			return *counters.back();
+		}
+
+		/*!
+		 * Counts one conversion from From to To on the calling thread. The counter for each pair is
+		 * registered the first time the pair is converted on a thread, and cached in a thread_local reference.
+		 */
+		template<class From, class To>
+		inline void trace_conversion()
+		{
+			thread_local conversion_count& counter = register_conversion_counter(type_name<From>(), type_name<To>());
+			++counter.count;
+		}
+
+		inline std::string readable_unit_name(std::string_view name)
+		{
+			constexpr std::string_view prefix = "units::";
+			std::string result;
+			result.reserve(name.size());
+			for (std::size_t i = 0; i < name.size();)
+			{
+				if (name.substr(i, prefix.size()) == prefix)
+					i += prefix.size();
+				else
+					result += name[i++];
+			}
+			return result;
+		}
+	}
+
+	/*!
+	 * Returns the conversion counts of the calling thread, most frequent first.
+	 */
+	inline std::vector<conversion_count> conversion_counts()
+	{
+		std::vector<conversion_count> result;
+		for (auto const& counter : detail::conversion_counters())
+			if (counter->count != 0)
+				result.push_back(*counter);
+		std::stable_sort(result.begin(), result.end(), [](conversion_count const& a, conversion_count const& b) { return a.count > b.count; });
+		return result;
+	}
+
+	/*!
+	 * Sets every counter of the calling thread back to zero.
+	 */
+	inline void reset_conversion_counts()
+	{
+		for (auto& counter : detail::conversion_counters())
+			counter->count = 0;
+	}
+
+	/*!
+	 * Returns a report of the conversion counts of the calling thread, one pair per line, most frequent
+	 * first. Pairs that are also converted in the opposite direction (mm -> m -> mm) are marked as round trips,
+	 * since those are usually a value being stored in the wrong unit.
+	 */
+	inline std::string conversion_report()
+	{
+		const std::vector<conversion_count> counts = conversion_counts();
+		std::string report;
+		for (conversion_count const& entry : counts)
+		{
+			const bool round_trip = std::any_of(counts.begin(), counts.end(), [&](conversion_count const& other)
+			{
+				return other.from == entry.to && other.to == entry.from;
+			});
+			report += std::to_string(entry.count);
+			report += '\t';
+			report += detail::readable_unit_name(entry.from);
+			report += " -> ";
+			report += detail::readable_unit_name(entry.to);
+			if (round_trip)
+				report += "\t(round trip)";
+			report += '\n';
+		}
+		return report;
+	}
+}
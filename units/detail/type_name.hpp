@@ -0,0 +1,128 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace units
+{
+	namespace detail
+	{
+		/*!
+		 * Returns the name of T as spelled by the compiler, for example "units::quantity<meter>".
+		 * This is only intended for diagnostics; the exact spelling differs between compilers, so anything
+		 * written out for another build uses portable_type_name.
+		 */
+		template<class T>
+		constexpr std::string_view type_name()
+		{
+#if defined(__clang__)
+			constexpr std::string_view function = __PRETTY_FUNCTION__;
+			constexpr std::string_view prefix = "T = ";
+			constexpr auto begin = function.find(prefix) + prefix.size();
+			return function.substr(begin, function.rfind(']') - begin);
+#elif defined(__GNUC__)
+			constexpr std::string_view function = __PRETTY_FUNCTION__;
+			constexpr std::string_view prefix = "T = ";
+			constexpr auto begin = function.find(prefix) + prefix.size();
+			return function.substr(begin, function.find(';', begin) - begin);
+#elif defined(_MSC_VER)
+			constexpr std::string_view function = __FUNCSIG__;
+			constexpr std::string_view prefix = "type_name<";
+			constexpr auto begin = function.find(prefix) + prefix.size();
+			return function.substr(begin, function.rfind(">(void)") - begin);
+#else
+			return "unknown";
+#endif
+		}
+
+		constexpr bool is_identifier_char(char c)
+		{
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+		}
+
+		/*!
+		 * Writes name without the "struct ", "class ", "enum " and "union " keywords MSVC puts before class
+		 * names, and with spaces kept only between two identifier characters ("unsigned int"), so
+		 * "struct units::tags::meter" becomes "units::tags::meter" and "std::pair<int, x>" becomes
+		 * "std::pair<int,x>". With a null out it only counts. Returns the length written.
+		 */
+		constexpr std::size_t normalize_type_name(std::string_view name, char* out)
+		{
+			constexpr std::string_view keywords[] = { "struct ", "class ", "enum ", "union " };
+			std::size_t size = 0;
+			char previous = '\0';
+			std::size_t i = 0;
+			while (i < name.size())
+			{
+				bool keyword = false;
+				if (i == 0 || !is_identifier_char(name[i - 1]))
+				{
+					for (const std::string_view word : keywords)
+					{
+						if (name.substr(i).starts_with(word))
+						{
+							i += word.size();
+							keyword = true;
+							break;
+						}
+					}
+				}
+				if (keyword)
+					continue;
+
+				const char c = name[i++];
+				if (c == ' ' && !(is_identifier_char(previous) && i < name.size() && is_identifier_char(name[i])))
+					continue;
+				if (out)
+					out[size] = c;
+				++size;
+				previous = c;
+			}
+			return size;
+		}
+
+		template<class T>
+		inline constexpr auto portable_type_name_storage = []
+		{
+			std::array<char, normalize_type_name(type_name<T>(), nullptr)> buffer{};
+			normalize_type_name(type_name<T>(), buffer.data());
+			return buffer;
+		}();
+
+		/*!
+		 * Returns type_name<T>() normalized with normalize_type_name. For the unit tags this library expects,
+		 * classes at namespace scope, GCC, Clang and MSVC give the same text, so it can be written to files
+		 * that another build reads. Names involving anonymous namespaces, local classes, or template arguments
+		 * the compilers print differently (integer literal suffixes, __int64) are still compiler-specific.
+		 */
+		template<class T>
+		constexpr std::string_view portable_type_name()
+		{
+			return { portable_type_name_storage<T>.data(), portable_type_name_storage<T>.size() };
+		}
+
+		/*!
+		 * 64-bit FNV-1a hash, usable at compile time.
+		 */
+		constexpr std::uint64_t fnv1a(std::string_view text, std::uint64_t hash = 14695981039346656037ull)
+		{
+			for (const char c : text)
+			{
+				hash ^= static_cast<std::uint8_t>(c);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		/*!
+		 * Returns a hash of the name of T. Two different types get different hashes (barring collisions),
+		 * but the value is only stable for a given compiler.
+		 */
+		template<class T>
+		constexpr std::uint64_t type_hash()
+		{
+			return fnv1a(type_name<T>());
+		}
+	}
+}
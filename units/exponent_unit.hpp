@@ -2,6 +2,7 @@
 #include "units.hpp"
 #include <cstdint>
 #include "detail/unit_comparisons.hpp"
+#include "unit_scale.hpp"
 
 namespace units
 {
@@ -63,4 +64,13 @@ namespace units
 	{
 		using type = Exponent;
 	};
+
+	/*!
+	 * Specialization of unit_scale for exponent_unit. The scale is the scale of BaseUnit raised to the exponent.
+	 */
+	template<Unit BaseUnit, class Exponent>
+	struct unit_scale<exponent_unit<BaseUnit, Exponent>>
+	{
+		constexpr static const detail::scale_factor value = detail::power(unit_scale_v<BaseUnit>, Exponent::value);
+	};
 }
\ No newline at end of file
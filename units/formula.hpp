@@ -0,0 +1,696 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "units.hpp"
+#include "runtime_unit.hpp"
+
+namespace units
+{
+	/*!
+	 * Thrown when a formula cannot be parsed or its dimensions do not agree.
+	 */
+	class formula_error : public std::invalid_argument
+	{
+	public:
+
+		formula_error(std::string const& message, std::size_t position)
+			: std::invalid_argument{ message + " (at offset " + std::to_string(position) + ")" }, position_{ position }
+		{}
+
+		//! Offset into the formula text where the error was found.
+		std::size_t position() const { return position_; }
+
+	private:
+
+		std::size_t position_;
+	};
+
+	/*!
+	 * The named input columns a formula may refer to, each with the unit its values are stored in.
+	 */
+	class formula_schema
+	{
+	public:
+
+		struct column
+		{
+			std::string name;
+			runtime_unit unit;
+		};
+
+		void add_column(std::string name, runtime_unit unit)
+		{
+			columns_.push_back(column{ std::move(name), unit });
+		}
+
+		template<Unit UnitType>
+		void add_column(std::string name)
+		{
+			add_column(std::move(name), runtime_unit::of<UnitType>());
+		}
+
+		std::span<const column> columns() const { return columns_; }
+
+		//! Returns the index of the named column, or -1 if there is none.
+		std::ptrdiff_t find(std::string_view name) const
+		{
+			for (std::size_t i = 0; i < columns_.size(); ++i)
+				if (columns_[i].name == name)
+					return static_cast<std::ptrdiff_t>(i);
+			return -1;
+		}
+
+	private:
+
+		std::vector<column> columns_;
+	};
+
+	namespace detail
+	{
+		//! Number of rows evaluated per instruction. Each register holds this many values.
+		constexpr const std::size_t formula_chunk = 256;
+
+		enum class formula_op : std::uint8_t
+		{
+			load,		// r[dst] = column[a] * imm + imm2
+			add,		// r[dst] = r[a] + r[b]
+			sub,		// r[dst] = r[a] - r[b]
+			mul,		// r[dst] = r[a] * r[b]
+			div,		// r[dst] = r[a] / r[b]
+			affine,		// r[dst] = r[a] * imm + imm2
+			rdiv,		// r[dst] = imm / r[a]
+			constant,	// r[dst] = imm
+		};
+
+		struct formula_instruction
+		{
+			formula_op op;
+			std::uint16_t dst = 0;
+			std::uint16_t a = 0;
+			std::uint16_t b = 0;
+			double imm = 1.0;
+			double imm2 = 0.0;
+		};
+
+		enum class formula_node_kind : std::uint8_t { number, column, add, sub, mul, div, negate, power };
+
+		//! The largest exponent magnitude a formula may write after '^', and that '^' may raise a unit tag to.
+		constexpr const std::int32_t max_formula_exponent = 64;
+
+		//! Parsed expression node. Nodes are allocated from the parser's arena and never freed individually.
+		struct formula_node
+		{
+			formula_node_kind kind;
+			std::size_t position = 0;
+			runtime_dimension dimension;
+			double number = 0.0;
+			std::ptrdiff_t column = -1;
+			std::int32_t exponent = 0;
+			formula_node* lhs = nullptr;
+			formula_node* rhs = nullptr;
+		};
+
+		/*!
+		 * Recursive descent parser for
+		 * @code
+		 * formula    := [identifier '='] expression
+		 * expression := term (('+' | '-') term)*
+		 * term       := unary (('*' | '/') unary)*
+		 * unary      := '-' unary | power
+		 * power      := primary ['^' ['-'] integer]
+		 * primary    := number | identifier | '(' expression ')'
+		 * @endcode
+		 * Dimensions are computed as each node is built, so a mismatch is reported at the operator that causes it.
+		 * Exponents are limited to max_formula_exponent, so neither the literal nor the dimension can overflow.
+		 */
+		class formula_parser
+		{
+		public:
+
+			formula_parser(std::string_view text, formula_schema const& schema, std::pmr::memory_resource& arena)
+				: text_{ text }, schema_{ schema }, arena_{ &arena }
+			{}
+
+			formula_node* parse(std::string& name)
+			{
+				const std::size_t start = position_;
+				skip_space();
+				if (is_identifier_start(peek()))
+				{
+					const std::string_view identifier = read_identifier();
+					skip_space();
+					if (peek() == '=')
+					{
+						++position_;
+						name = identifier;
+					}
+					else
+						position_ = start;
+				}
+				else
+					position_ = start;
+
+				formula_node* root = expression();
+				skip_space();
+				if (position_ != text_.size())
+					throw formula_error("unexpected '" + std::string{ text_[position_] } + "'", position_);
+				return root;
+			}
+
+		private:
+
+			formula_node* make(formula_node_kind kind, std::size_t position)
+			{
+				formula_node* node = arena_.new_object<formula_node>();
+				node->kind = kind;
+				node->position = position;
+				return node;
+			}
+
+			formula_node* binary(formula_node_kind kind, std::size_t position, formula_node* lhs, formula_node* rhs)
+			{
+				formula_node* node = make(kind, position);
+				node->lhs = lhs;
+				node->rhs = rhs;
+				switch (kind)
+				{
+				case formula_node_kind::add:
+				case formula_node_kind::sub:
+					if (!(lhs->dimension == rhs->dimension))
+						throw formula_error("cannot add or subtract " + lhs->dimension.to_string() + " and " + rhs->dimension.to_string(), position);
+					node->dimension = lhs->dimension;
+					break;
+				case formula_node_kind::mul:
+					node->dimension = lhs->dimension * rhs->dimension;
+					break;
+				default:
+					node->dimension = lhs->dimension / rhs->dimension;
+					break;
+				}
+				return node;
+			}
+
+			formula_node* expression()
+			{
+				formula_node* lhs = term();
+				while (true)
+				{
+					skip_space();
+					const char c = peek();
+					if (c != '+' && c != '-')
+						return lhs;
+					const std::size_t position = position_++;
+					lhs = binary(c == '+' ? formula_node_kind::add : formula_node_kind::sub, position, lhs, term());
+				}
+			}
+
+			formula_node* term()
+			{
+				formula_node* lhs = unary();
+				while (true)
+				{
+					skip_space();
+					const char c = peek();
+					if (c != '*' && c != '/')
+						return lhs;
+					const std::size_t position = position_++;
+					lhs = binary(c == '*' ? formula_node_kind::mul : formula_node_kind::div, position, lhs, unary());
+				}
+			}
+
+			formula_node* unary()
+			{
+				skip_space();
+				if (peek() == '-')
+				{
+					formula_node* node = make(formula_node_kind::negate, position_++);
+					node->lhs = unary();
+					node->dimension = node->lhs->dimension;
+					return node;
+				}
+				return power();
+			}
+
+			formula_node* power()
+			{
+				formula_node* base = primary();
+				skip_space();
+				if (peek() != '^')
+					return base;
+
+				formula_node* node = make(formula_node_kind::power, position_++);
+				skip_space();
+				bool negative = false;
+				if (peek() == '-')
+				{
+					negative = true;
+					++position_;
+				}
+				const std::size_t digits = position_;
+				std::int32_t exponent = 0;
+				while (std::isdigit(static_cast<unsigned char>(peek())))
+				{
+					exponent = exponent * 10 + (text_[position_++] - '0');
+					if (exponent > max_formula_exponent)
+						throw formula_error("exponents must be at most " + std::to_string(max_formula_exponent), digits);
+				}
+				if (digits == position_)
+					throw formula_error("exponents must be integer literals", digits);
+				for (std::size_t i = 0; i < base->dimension.size(); ++i)
+				{
+					const std::int32_t tag_exponent = base->dimension[i].exponent;
+					if (exponent != 0 && (tag_exponent < 0 ? -tag_exponent : tag_exponent) > max_formula_exponent / exponent)
+						throw formula_error("dimension exponents must be at most " + std::to_string(max_formula_exponent), node->position);
+				}
+
+				node->lhs = base;
+				node->exponent = negative ? -exponent : exponent;
+				node->dimension = base->dimension.power(node->exponent);
+				return node;
+			}
+
+			formula_node* primary()
+			{
+				skip_space();
+				const char c = peek();
+				const std::size_t position = position_;
+				if (c == '(')
+				{
+					++position_;
+					formula_node* inner = expression();
+					skip_space();
+					if (peek() != ')')
+						throw formula_error("expected ')'", position_);
+					++position_;
+					return inner;
+				}
+				if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+				{
+					const std::string_view literal = read_number();
+					formula_node* node = make(formula_node_kind::number, position);
+					const auto [end, error] = std::from_chars(literal.data(), literal.data() + literal.size(), node->number);
+					if (error != std::errc{} || end != literal.data() + literal.size())
+						throw formula_error("malformed number '" + std::string{ literal } + "'", position);
+					return node;
+				}
+				if (is_identifier_start(c))
+				{
+					const std::string_view identifier = read_identifier();
+					const std::ptrdiff_t column = schema_.find(identifier);
+					if (column < 0)
+						throw formula_error("unknown column '" + std::string{ identifier } + "'", position);
+					formula_node* node = make(formula_node_kind::column, position);
+					node->column = column;
+					node->dimension = schema_.columns()[static_cast<std::size_t>(column)].unit.dimension;
+					return node;
+				}
+				throw formula_error(c == '\0' ? std::string{ "unexpected end of formula" } : "unexpected '" + std::string{ c } + "'", position);
+			}
+
+			char peek() const { return position_ < text_.size() ? text_[position_] : '\0'; }
+
+			void skip_space()
+			{
+				while (std::isspace(static_cast<unsigned char>(peek())))
+					++position_;
+			}
+
+			static bool is_identifier_start(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+
+			std::string_view read_identifier()
+			{
+				const std::size_t start = position_;
+				while (is_identifier_start(peek()) || std::isdigit(static_cast<unsigned char>(peek())))
+					++position_;
+				return text_.substr(start, position_ - start);
+			}
+
+			std::string_view read_number()
+			{
+				const std::size_t start = position_;
+				bool point = false;
+				while (std::isdigit(static_cast<unsigned char>(peek())) || peek() == '.')
+				{
+					if (peek() == '.')
+					{
+						if (point)
+							throw formula_error("malformed number", start);
+						point = true;
+					}
+					++position_;
+				}
+				if (peek() == 'e' || peek() == 'E')
+				{
+					++position_;
+					if (peek() == '+' || peek() == '-')
+						++position_;
+					while (std::isdigit(static_cast<unsigned char>(peek())))
+						++position_;
+				}
+				return text_.substr(start, position_ - start);
+			}
+
+			std::string_view text_;
+			formula_schema const& schema_;
+			std::pmr::polymorphic_allocator<> arena_;
+			std::size_t position_ = 0;
+		};
+	}
+
+	/*!
+	 * A compiled formula over the columns of a formula_schema. Compiling parses the text, checks that the
+	 * result has the dimension of the requested output unit, and lowers the expression to a short
+	 * register-based bytecode in which every unit scale factor has been folded into a constant. Evaluation
+	 * runs each instruction over a chunk of rows at a time, so there is no dispatch per row and the inner
+	 * loops are plain arithmetic over arrays that the compiler vectorises.
+	 */
+	class formula
+	{
+	public:
+
+		/*!
+		 * Compiles text against schema. The result is produced in output.
+		 *
+		 * @throws formula_error If the text does not parse or its dimension does not match output.
+		 */
+		static formula compile(std::string_view text, formula_schema const& schema, runtime_unit const& output)
+		{
+			std::array<std::byte, 4096> buffer;
+			std::pmr::monotonic_buffer_resource arena{ buffer.data(), buffer.size() };
+
+			formula result;
+			detail::formula_parser parser{ text, schema, arena };
+			const detail::formula_node* root = parser.parse(result.name_);
+			if (!(root->dimension == output.dimension))
+				throw formula_error("formula has dimension " + root->dimension.to_string() + " but the output is " + output.dimension.to_string(), root->position);
+
+			result.columns_ = schema.columns().size();
+			const value folded = result.lower(root, schema);
+			// Convert from fundamental units to the output unit in the last instruction.
+			result.finish(folded, 1.0 / output.scale, -output.offset / output.scale);
+			return result;
+		}
+
+		template<Unit Output>
+		static formula compile(std::string_view text, formula_schema const& schema)
+		{
+			return compile(text, schema, runtime_unit::of<Output>());
+		}
+
+		//! The name on the left of '=' in the formula text, if there was one.
+		std::string const& name() const { return name_; }
+
+		//! The number of bytecode instructions.
+		std::size_t size() const { return code_.size(); }
+
+		//! The number of registers the bytecode uses.
+		std::size_t registers() const { return registers_; }
+
+		/*!
+		 * Evaluates the formula for every row. columns must have one span per schema column, in schema order,
+		 * each at least as long as out.
+		 */
+		void evaluate(std::span<const std::span<const double>> columns, std::span<double> out) const
+		{
+			if (columns.size() != columns_)
+				throw std::invalid_argument("formula evaluated with the wrong number of columns");
+			for (auto const& column : columns)
+				if (column.size() < out.size())
+					throw std::invalid_argument("formula column is shorter than the output");
+
+			std::vector<double> storage(registers_ * detail::formula_chunk);
+			for (std::size_t row = 0; row < out.size(); row += detail::formula_chunk)
+			{
+				const std::size_t count = std::min(detail::formula_chunk, out.size() - row);
+				for (auto const& instruction : code_)
+					execute(instruction, storage.data(), columns, row, count);
+				const double* result = storage.data() + result_ * detail::formula_chunk;
+				std::copy(result, result + count, out.data() + row);
+			}
+		}
+
+	private:
+
+		/*!
+		 * The value of a lowered subexpression. Its fundamental value is reg * factor, or just factor when
+		 * reg is empty (a constant). Carrying the factor separately is what lets unit scales and numeric
+		 * literals fold together instead of becoming instructions.
+		 */
+		struct value
+		{
+			std::ptrdiff_t reg = -1;
+			double factor = 1.0;
+
+			bool constant() const { return reg < 0; }
+		};
+
+		std::uint16_t allocate()
+		{
+			std::uint16_t reg;
+			if (!free_.empty())
+			{
+				reg = free_.back();
+				free_.pop_back();
+			}
+			else
+				reg = static_cast<std::uint16_t>(registers_++);
+			return reg;
+		}
+
+		void release(value v)
+		{
+			if (!v.constant())
+				free_.push_back(static_cast<std::uint16_t>(v.reg));
+		}
+
+		std::uint16_t emit(detail::formula_op op, std::ptrdiff_t a, std::ptrdiff_t b, double imm, double imm2)
+		{
+			const std::uint16_t dst = allocate();
+			code_.push_back(detail::formula_instruction{ op, dst, static_cast<std::uint16_t>(a), static_cast<std::uint16_t>(b), imm, imm2 });
+			return dst;
+		}
+
+		//! Returns a register holding reg * factor exactly (factor folded into an instruction if it is not 1).
+		value materialise(value v)
+		{
+			if (v.constant())
+				return value{ emit(detail::formula_op::constant, 0, 0, v.factor, 0.0), 1.0 };
+			if (v.factor == 1.0)
+				return v;
+			release(v);
+			return value{ emit(detail::formula_op::affine, v.reg, 0, v.factor, 0.0), 1.0 };
+		}
+
+		value lower(const detail::formula_node* node, formula_schema const& schema)
+		{
+			using kind = detail::formula_node_kind;
+			using op = detail::formula_op;
+			switch (node->kind)
+			{
+			case kind::number:
+				return value{ -1, node->number };
+
+			case kind::column:
+			{
+				runtime_unit const& unit = schema.columns()[static_cast<std::size_t>(node->column)].unit;
+				if (unit.offset == 0.0)
+					return value{ emit(op::load, node->column, 0, 1.0, 0.0), unit.scale };
+				return value{ emit(op::load, node->column, 0, unit.scale, unit.offset), 1.0 };
+			}
+
+			case kind::negate:
+			{
+				value inner = lower(node->lhs, schema);
+				inner.factor = -inner.factor;
+				return inner;
+			}
+
+			case kind::mul:
+			case kind::div:
+			{
+				const value lhs = lower(node->lhs, schema);
+				const value rhs = lower(node->rhs, schema);
+				const bool multiply = node->kind == kind::mul;
+				const double factor = multiply ? lhs.factor * rhs.factor : lhs.factor / rhs.factor;
+				if (rhs.constant())
+					return value{ lhs.reg, factor };
+				if (lhs.constant())
+				{
+					if (multiply)
+						return value{ rhs.reg, factor };
+					release(rhs);
+					return value{ emit(op::rdiv, rhs.reg, 0, 1.0, 0.0), factor };
+				}
+				release(lhs);
+				release(rhs);
+				return value{ emit(multiply ? op::mul : op::div, lhs.reg, rhs.reg, 1.0, 0.0), factor };
+			}
+
+			case kind::add:
+			case kind::sub:
+			{
+				const value lhs = lower(node->lhs, schema);
+				value rhs = lower(node->rhs, schema);
+				if (node->kind == kind::sub)
+					rhs.factor = -rhs.factor;
+				if (lhs.constant() && rhs.constant())
+					return value{ -1, lhs.factor + rhs.factor };
+				// a*fa + b*fb = (a + b*(fb/fa)) * fa, so only one side needs rescaling. A side whose factor
+				// is 0 cannot be divided by, so it is the one rescaled, or folded into a plain affine.
+				if (rhs.constant() || lhs.constant())
+				{
+					const value& variable = rhs.constant() ? lhs : rhs;
+					const double constant = rhs.constant() ? rhs.factor : lhs.factor;
+					release(variable);
+					if (variable.factor == 0.0)
+						return value{ emit(op::affine, variable.reg, 0, 0.0, constant), 1.0 };
+					return value{ emit(op::affine, variable.reg, 0, 1.0, constant / variable.factor), variable.factor };
+				}
+				if (lhs.factor == rhs.factor)
+				{
+					release(lhs);
+					release(rhs);
+					return value{ emit(op::add, lhs.reg, rhs.reg, 1.0, 0.0), lhs.factor };
+				}
+				if (lhs.factor == -rhs.factor)
+				{
+					release(lhs);
+					release(rhs);
+					return value{ emit(op::sub, lhs.reg, rhs.reg, 1.0, 0.0), lhs.factor };
+				}
+				const value& kept = lhs.factor != 0.0 ? lhs : rhs;
+				const value& other = lhs.factor != 0.0 ? rhs : lhs;
+				release(other);
+				const value scaled{ emit(op::affine, other.reg, 0, other.factor / kept.factor, 0.0), 1.0 };
+				release(kept);
+				release(scaled);
+				return value{ emit(op::add, kept.reg, scaled.reg, 1.0, 0.0), kept.factor };
+			}
+
+			case kind::power:
+			{
+				const value base = lower(node->lhs, schema);
+				const std::int32_t n = node->exponent < 0 ? -node->exponent : node->exponent;
+				const double factor = std::pow(base.factor, node->exponent);
+				if (base.constant())
+					return value{ -1, factor };
+				if (n == 0)
+				{
+					release(base);
+					return value{ -1, 1.0 };
+				}
+
+				// Square-and-multiply on the register; the factor was already raised above.
+				value result{ -1, 1.0 };
+				value square{ base.reg, 1.0 };
+				for (std::int32_t remaining = n; remaining > 0; remaining >>= 1)
+				{
+					if (remaining & 1)
+					{
+						if (result.constant())
+							result = value{ emit(op::affine, square.reg, 0, 1.0, 0.0), 1.0 };
+						else
+						{
+							release(result);
+							result = value{ emit(op::mul, result.reg, square.reg, 1.0, 0.0), 1.0 };
+						}
+					}
+					if (remaining > 1)
+					{
+						release(square);
+						square = value{ emit(op::mul, square.reg, square.reg, 1.0, 0.0), 1.0 };
+					}
+				}
+				release(square);
+				if (node->exponent < 0)
+				{
+					release(result);
+					result = value{ emit(op::rdiv, result.reg, 0, 1.0, 0.0), 1.0 };
+				}
+				result.factor = factor;
+				return result;
+			}
+			}
+			return value{};
+		}
+
+		void finish(value v, double scale, double offset)
+		{
+			if (v.constant())
+				result_ = emit(detail::formula_op::constant, 0, 0, v.factor * scale + offset, 0.0);
+			else
+			{
+				release(v);
+				result_ = emit(detail::formula_op::affine, v.reg, 0, v.factor * scale, offset);
+			}
+			free_.clear();
+		}
+
+		static void execute(detail::formula_instruction const& instruction, double* registers, std::span<const std::span<const double>> columns, std::size_t row, std::size_t count)
+		{
+			using op = detail::formula_op;
+			double* dst = registers + instruction.dst * detail::formula_chunk;
+			const double* a = registers + instruction.a * detail::formula_chunk;
+			const double* b = registers + instruction.b * detail::formula_chunk;
+			const double imm = instruction.imm;
+			const double imm2 = instruction.imm2;
+
+			switch (instruction.op)
+			{
+			case op::load:
+			{
+				const double* column = columns[instruction.a].data() + row;
+				for (std::size_t i = 0; i < count; ++i)
+					dst[i] = column[i] * imm + imm2;
+				break;
+			}
+			case op::add:
+				for (std::size_t i = 0; i < count; ++i)
+					dst[i] = a[i] + b[i];
+				break;
+			case op::sub:
+				for (std::size_t i = 0; i < count; ++i)
+					dst[i] = a[i] - b[i];
+				break;
+			case op::mul:
+				for (std::size_t i = 0; i < count; ++i)
+					dst[i] = a[i] * b[i];
+				break;
+			case op::div:
+				for (std::size_t i = 0; i < count; ++i)
+					dst[i] = a[i] / b[i];
+				break;
+			case op::affine:
+				for (std::size_t i = 0; i < count; ++i)
+					dst[i] = a[i] * imm + imm2;
+				break;
+			case op::rdiv:
+				for (std::size_t i = 0; i < count; ++i)
+					dst[i] = imm / a[i];
+				break;
+			case op::constant:
+				std::fill(dst, dst + count, imm);
+				break;
+			}
+		}
+
+		std::string name_;
+		std::vector<detail::formula_instruction> code_;
+		std::vector<std::uint16_t> free_;
+		std::size_t registers_ = 0;
+		std::size_t columns_ = 0;
+		std::uint16_t result_ = 0;
+	};
+}
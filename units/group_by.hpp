@@ -0,0 +1,559 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "exponent_unit.hpp"
+#include "difference_unit.hpp"
+#include "parallel_transform.hpp"
+
+namespace units
+{
+	namespace detail
+	{
+		template<class ValueType>
+		using group_accumulator_t = std::conditional_t<std::is_floating_point_v<ValueType>, ValueType, double>;
+
+		//! The murmur3 finalizer: every bit of the key affects the low bits (tag, slot) and the high bits (partition).
+		constexpr std::uint64_t group_hash(std::uint64_t x)
+		{
+			x ^= x >> 33;
+			x *= 0xff51afd7ed558ccdull;
+			x ^= x >> 33;
+			x *= 0xc4ceb9fe1a85ec53ull;
+			x ^= x >> 33;
+			return x;
+		}
+
+		constexpr const std::size_t group_width = 8;
+		constexpr const std::uint8_t group_empty = 0x80;
+		constexpr const std::uint64_t group_lsbs = 0x0101010101010101ull;
+		constexpr const std::uint64_t group_msbs = 0x8080808080808080ull;
+
+		//! The control bytes of a probe group as one word, byte i in bits [8i, 8i + 8) on any byte order.
+		constexpr std::uint64_t load_group(const std::uint8_t* ctrl)
+		{
+			if (!std::is_constant_evaluated() && std::endian::native == std::endian::little)
+			{
+				std::uint64_t word;
+				std::memcpy(&word, ctrl, sizeof(word));
+				return word;
+			}
+			std::uint64_t word = 0;
+			for (std::size_t i = 0; i < group_width; ++i)
+				word |= std::uint64_t{ ctrl[i] } << (8 * i);
+			return word;
+		}
+
+		/*!
+		 * The bytes of word equal to tag, as the high bit of each byte: all eight slots of a group are
+		 * compared with a few integer instructions. A byte just above a true match can be reported too;
+		 * callers compare keys anyway, so that costs one extra comparison and is never wrong.
+		 */
+		constexpr std::uint64_t match_group(std::uint64_t word, std::uint8_t tag)
+		{
+			const std::uint64_t x = word ^ (group_lsbs * tag);
+			return (x - group_lsbs) & ~x & group_msbs;
+		}
+
+		//! The empty slots of a group, as the high bit of each byte. Exact, since tags are below 0x80.
+		constexpr std::uint64_t match_empty(std::uint64_t word)
+		{
+			return word & group_msbs;
+		}
+	}
+
+	/*!
+	 * group_sum aggregates a column to the sum of each group, in UnitType.
+	 */
+	template<Unit UnitType>
+	struct group_sum
+	{
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+		using accumulator_type = detail::group_accumulator_t<value_type>;
+		using result_type = quantity<UnitType>;
+
+		struct state
+		{
+			accumulator_type sum = 0;
+		};
+
+		std::span<const quantity<UnitType>> values;
+
+		constexpr static void add(state& s, value_type x, std::uint64_t) { s.sum += static_cast<accumulator_type>(x); }
+		constexpr static void merge(state& s, state const& other, std::uint64_t, std::uint64_t) { s.sum += other.sum; }
+		constexpr static result_type result(state const& s, std::uint64_t) { return result_type{ static_cast<value_type>(s.sum) }; }
+	};
+
+	/*!
+	 * group_mean aggregates a column to the arithmetic mean of each group, in UnitType.
+	 */
+	template<Unit UnitType>
+	struct group_mean
+	{
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+		using accumulator_type = detail::group_accumulator_t<value_type>;
+		using result_type = quantity<UnitType>;
+
+		struct state
+		{
+			accumulator_type sum = 0;
+		};
+
+		std::span<const quantity<UnitType>> values;
+
+		constexpr static void add(state& s, value_type x, std::uint64_t) { s.sum += static_cast<accumulator_type>(x); }
+		constexpr static void merge(state& s, state const& other, std::uint64_t, std::uint64_t) { s.sum += other.sum; }
+
+		constexpr static result_type result(state const& s, std::uint64_t count)
+		{
+			return result_type{ static_cast<value_type>(s.sum / static_cast<accumulator_type>(count)) };
+		}
+	};
+
+	/*!
+	 * group_min aggregates a column to the smallest value of each group.
+	 */
+	template<Unit UnitType>
+	struct group_min
+	{
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+		using result_type = quantity<UnitType>;
+
+		struct state
+		{
+			value_type min = std::numeric_limits<value_type>::max();
+		};
+
+		std::span<const quantity<UnitType>> values;
+
+		constexpr static void add(state& s, value_type x, std::uint64_t) { s.min = std::min(s.min, x); }
+		constexpr static void merge(state& s, state const& other, std::uint64_t, std::uint64_t) { s.min = std::min(s.min, other.min); }
+		constexpr static result_type result(state const& s, std::uint64_t) { return result_type{ s.min }; }
+	};
+
+	/*!
+	 * group_max aggregates a column to the largest value of each group.
+	 */
+	template<Unit UnitType>
+	struct group_max
+	{
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+		using result_type = quantity<UnitType>;
+
+		struct state
+		{
+			value_type max = std::numeric_limits<value_type>::lowest();
+		};
+
+		std::span<const quantity<UnitType>> values;
+
+		constexpr static void add(state& s, value_type x, std::uint64_t) { s.max = std::max(s.max, x); }
+		constexpr static void merge(state& s, state const& other, std::uint64_t, std::uint64_t) { s.max = std::max(s.max, other.max); }
+		constexpr static result_type result(state const& s, std::uint64_t) { return result_type{ s.max }; }
+	};
+
+	/*!
+	 * group_variance aggregates a column to the population variance of each group, in the square of the
+	 * difference unit of UnitType, as quantity_stats does. Groups are accumulated with Welford's update and
+	 * merged with the pairwise update of Chan et al.
+	 */
+	template<Unit UnitType>
+	struct group_variance
+	{
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+		using accumulator_type = detail::group_accumulator_t<value_type>;
+		using variance_unit = make_exponent_t<difference_unit_t<UnitType>, 2>;
+		using result_type = quantity<variance_unit>;
+
+		struct state
+		{
+			accumulator_type mean = 0;
+			accumulator_type m2 = 0;
+		};
+
+		std::span<const quantity<UnitType>> values;
+
+		constexpr static void add(state& s, value_type value, std::uint64_t count)
+		{
+			const accumulator_type x = static_cast<accumulator_type>(value);
+			const accumulator_type d = x - s.mean;
+			s.mean += d / static_cast<accumulator_type>(count);
+			s.m2 += d * (x - s.mean);
+		}
+
+		constexpr static void merge(state& s, state const& other, std::uint64_t count, std::uint64_t other_count)
+		{
+			const accumulator_type na = static_cast<accumulator_type>(count);
+			const accumulator_type nb = static_cast<accumulator_type>(other_count);
+			const accumulator_type d = other.mean - s.mean;
+			const accumulator_type d_n = d / (na + nb);
+			s.m2 += other.m2 + d * d_n * na * nb;
+			s.mean += d_n * nb;
+		}
+
+		constexpr static result_type result(state const& s, std::uint64_t count)
+		{
+			return result_type{ static_cast<typename variance_unit::value_type>(s.m2 / static_cast<accumulator_type>(count)) };
+		}
+	};
+
+	template<Unit UnitType>
+	constexpr group_sum<UnitType> sum_of(std::span<const quantity<UnitType>> values) { return { values }; }
+
+	template<Unit UnitType>
+	constexpr group_mean<UnitType> mean_of(std::span<const quantity<UnitType>> values) { return { values }; }
+
+	template<Unit UnitType>
+	constexpr group_min<UnitType> min_of(std::span<const quantity<UnitType>> values) { return { values }; }
+
+	template<Unit UnitType>
+	constexpr group_max<UnitType> max_of(std::span<const quantity<UnitType>> values) { return { values }; }
+
+	template<Unit UnitType>
+	constexpr group_variance<UnitType> variance_of(std::span<const quantity<UnitType>> values) { return { values }; }
+
+	/*!
+	 * GroupAggregate concept. Satisfied by the column aggregates above: a column of values, a per-group
+	 * state, and the functions that add a value to a state, merge two states and produce the typed result.
+	 */
+	template<class T>
+	concept GroupAggregate = requires(T const& aggregate, typename T::state& s, typename T::state const& other, typename T::value_type x, std::uint64_t n)
+	{
+		typename T::result_type;
+		{ aggregate.values.size() } -> std::convertible_to<std::size_t>;
+		T::add(s, x, n);
+		T::merge(s, other, n, n);
+		{ T::result(other, n) } -> std::same_as<typename T::result_type>;
+	};
+
+	template<std::integral Key, GroupAggregate... Aggregates>
+	class group_table;
+
+	/*!
+	 * The output of a group-by: one row per group, in no particular order, as structure-of-arrays columns.
+	 * column<I>() holds the results of the I-th aggregate, in its result_type: quantities for sums, means,
+	 * minima and maxima, and quantities of the squared unit for variances.
+	 */
+	template<std::integral Key, GroupAggregate... Aggregates>
+	class group_by_result
+	{
+	public:
+
+		constexpr group_by_result() = default;
+
+		constexpr std::size_t size() const { return keys_.size(); }
+
+		constexpr std::span<const Key> keys() const { return keys_; }
+
+		//! The number of rows in each group.
+		constexpr std::span<const std::uint64_t> counts() const { return counts_; }
+
+		template<std::size_t I>
+		constexpr auto column() const
+		{
+			return std::span{ std::as_const(std::get<I>(columns_)) };
+		}
+
+	private:
+
+		template<std::integral, GroupAggregate...>
+		friend class group_table;
+
+		template<std::integral K, GroupAggregate... A>
+		friend group_by_result<K, A...> group_by(thread_pool& pool, std::span<const K> keys, A const&... aggregates);
+
+		constexpr void resize(std::size_t size)
+		{
+			keys_.resize(size);
+			counts_.resize(size);
+			std::apply([size](auto&... column) { (column.resize(size), ...); }, columns_);
+		}
+
+		std::vector<Key> keys_;
+		std::vector<std::uint64_t> counts_;
+		std::tuple<std::vector<typename Aggregates::result_type>...> columns_;
+	};
+
+	/*!
+	 * group_table accumulates rows into per-key aggregate states: the streaming form of group_by.
+	 *
+	 * It is an open-addressing hash table. The slots are in groups of eight with one control byte each,
+	 * either empty or seven bits of the key's hash, and a probe compares the eight control bytes of a
+	 * group at once as one 64-bit word (see detail::match_group), so most lookups read one control word
+	 * and one entry. The entry holds the key, the row count and the state of every aggregate, so adding
+	 * a row to an existing group reads and writes one entry. The table grows by doubling at 7/8 full.
+	 */
+	template<std::integral Key, GroupAggregate... Aggregates>
+	class group_table
+	{
+	public:
+
+		using result_type = group_by_result<Key, Aggregates...>;
+
+		constexpr group_table() = default;
+
+		//! Reserves room for groups distinct keys, so the table does not grow until there are more.
+		constexpr explicit group_table(std::size_t groups)
+		{
+			reserve(groups);
+		}
+
+		constexpr void reserve(std::size_t groups)
+		{
+			const std::size_t slots = std::max<std::size_t>(2 * detail::group_width, std::bit_ceil(groups + groups / 7 + 1));
+			if (slots > ctrl_.size())
+				rehash(slots);
+		}
+
+		//! The number of groups.
+		constexpr std::size_t size() const { return size_; }
+
+		/*!
+		 * Adds every row: keys[i] and the i-th value of each aggregate's column.
+		 *
+		 * @throws std::invalid_argument If the columns and keys have different lengths.
+		 */
+		constexpr void add(std::span<const Key> keys, Aggregates const&... aggregates)
+		{
+			if (((aggregates.values.size() != keys.size()) || ...))
+				throw std::invalid_argument("group_by columns must have the same length as the keys");
+			add(0, keys.size(), keys, aggregates...);
+		}
+
+		//! Adds rows [begin, end). The lengths are not checked.
+		constexpr void add(std::size_t begin, std::size_t end, std::span<const Key> keys, Aggregates const&... aggregates)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				entry& e = find_or_insert(keys[i], detail::group_hash(static_cast<std::uint64_t>(keys[i])));
+				const std::uint64_t count = ++e.count;
+				add_row(e.states, i, count, std::index_sequence_for<Aggregates...>{}, aggregates...);
+			}
+		}
+
+		//! Merges every group of other into this table, as if its rows had been added here.
+		constexpr void merge(group_table const& other)
+		{
+			merge(other, 0, 1);
+		}
+
+		/*!
+		 * Merges the groups of other in hash partition part of parts. Merging every table into parts tables,
+		 * one partition each, merges them in parallel with no key in two of the results; see group_by.
+		 */
+		constexpr void merge(group_table const& other, std::size_t part, std::size_t parts)
+		{
+			for (std::size_t slot = 0; slot < other.ctrl_.size(); ++slot)
+			{
+				if (other.ctrl_[slot] == detail::group_empty)
+					continue;
+				entry const& source = other.entries_[slot];
+				const std::uint64_t hash = detail::group_hash(static_cast<std::uint64_t>(source.key));
+				if (partition(hash, parts) != part)
+					continue;
+				entry& e = find_or_insert(source.key, hash);
+				merge_states(e.states, source.states, e.count, source.count, std::index_sequence_for<Aggregates...>{});
+				e.count += source.count;
+			}
+		}
+
+		//! The aggregates of every group.
+		constexpr result_type result() const
+		{
+			result_type out;
+			out.resize(size_);
+			write(out, 0);
+			return out;
+		}
+
+		//! The partition of a key hash, in [0, parts), from its top bits; slots come from the low bits.
+		constexpr static std::size_t partition(std::uint64_t hash, std::size_t parts)
+		{
+			return static_cast<std::size_t>(((hash >> 32) * parts) >> 32);
+		}
+
+	private:
+
+		template<std::integral K, GroupAggregate... A>
+		friend group_by_result<K, A...> group_by(thread_pool& pool, std::span<const K> keys, A const&... aggregates);
+
+		using states_type = std::tuple<typename Aggregates::state...>;
+
+		struct entry
+		{
+			Key key{};
+			std::uint64_t count = 0;
+			states_type states{};
+		};
+
+		template<std::size_t... I>
+		constexpr static void add_row(states_type& states, std::size_t row, std::uint64_t count, std::index_sequence<I...>, Aggregates const&... aggregates)
+		{
+			(Aggregates::add(std::get<I>(states), aggregates.values[row].value(), count), ...);
+		}
+
+		template<std::size_t... I>
+		constexpr static void merge_states(states_type& states, states_type const& other, std::uint64_t count, std::uint64_t other_count, std::index_sequence<I...>)
+		{
+			(Aggregates::merge(std::get<I>(states), std::get<I>(other), count, other_count), ...);
+		}
+
+		//! Writes the groups to out from row offset on.
+		constexpr void write(result_type& out, std::size_t offset) const
+		{
+			for (std::size_t slot = 0; slot < ctrl_.size(); ++slot)
+			{
+				if (ctrl_[slot] == detail::group_empty)
+					continue;
+				entry const& e = entries_[slot];
+				out.keys_[offset] = e.key;
+				out.counts_[offset] = e.count;
+				write_results(out, offset, e, std::index_sequence_for<Aggregates...>{});
+				++offset;
+			}
+		}
+
+		template<std::size_t... I>
+		constexpr static void write_results(result_type& out, std::size_t offset, entry const& e, std::index_sequence<I...>)
+		{
+			((std::get<I>(out.columns_)[offset] = Aggregates::result(std::get<I>(e.states), e.count)), ...);
+		}
+
+		/*!
+		 * Probes groups in triangular order (1, 2, 3... groups on), which visits every group of a power of two
+		 * count. Keys are never removed, so an empty slot in a group ends the probe.
+		 */
+		constexpr entry& find_or_insert(Key key, std::uint64_t hash)
+		{
+			if (size_ >= ctrl_.size() - ctrl_.size() / 8)
+				rehash(std::max<std::size_t>(2 * detail::group_width, 2 * ctrl_.size()));
+
+			const auto tag = static_cast<std::uint8_t>(hash & 0x7f);
+			const std::size_t mask = ctrl_.size() / detail::group_width - 1;
+			std::size_t group = (hash >> 7) & mask;
+			for (std::size_t step = 1;; ++step)
+			{
+				const std::size_t first = group * detail::group_width;
+				const std::uint64_t word = detail::load_group(ctrl_.data() + first);
+				for (std::uint64_t match = detail::match_group(word, tag); match; match &= match - 1)
+				{
+					entry& e = entries_[first + static_cast<std::size_t>(std::countr_zero(match)) / 8];
+					if (e.key == key)
+						return e;
+				}
+				if (const std::uint64_t empty = detail::match_empty(word))
+				{
+					const std::size_t slot = first + static_cast<std::size_t>(std::countr_zero(empty)) / 8;
+					ctrl_[slot] = tag;
+					entries_[slot].key = key;
+					++size_;
+					return entries_[slot];
+				}
+				group = (group + step) & mask;
+			}
+		}
+
+		constexpr void rehash(std::size_t slots)
+		{
+			std::vector<std::uint8_t> ctrl(slots, detail::group_empty);
+			std::vector<entry> entries(slots);
+			ctrl.swap(ctrl_);
+			entries.swap(entries_);
+			size_ = 0;
+			for (std::size_t slot = 0; slot < ctrl.size(); ++slot)
+			{
+				if (ctrl[slot] != detail::group_empty)
+					find_or_insert(entries[slot].key, detail::group_hash(static_cast<std::uint64_t>(entries[slot].key))) = entries[slot];
+			}
+		}
+
+		std::vector<std::uint8_t> ctrl_;
+		std::vector<entry> entries_;
+		std::size_t size_ = 0;
+	};
+
+	/*!
+	 * Groups rows by key and aggregates each group, for queries such as "sum energy, mean speed and max
+	 * temperature by device":
+	 * @code
+	 * auto by_device = group_by(keys, sum_of(energy), mean_of(speed), max_of(temperature));
+	 * quantity<si::energy> e = by_device.column<0>()[0];
+	 * @endcode
+	 *
+	 * @throws std::invalid_argument If the columns and keys have different lengths.
+	 */
+	template<std::integral Key, GroupAggregate... Aggregates>
+	constexpr group_by_result<Key, Aggregates...> group_by(std::span<const Key> keys, Aggregates const&... aggregates)
+	{
+		group_table<Key, Aggregates...> table;
+		table.add(keys, aggregates...);
+		return table.result();
+	}
+
+	/*!
+	 * group_by in parallel on pool. Every worker takes chunks of rows from a shared counter into a table of
+	 * its own; then worker w merges hash partition w of every table into a final table, so the merge runs
+	 * in parallel too and no key appears in two final tables; last, each final table is written to its
+	 * own range of the result. The result has the same groups as the sequential group_by, in another order,
+	 * and floating-point sums can differ in the last bits since rows are added in another order.
+	 *
+	 * @throws std::invalid_argument If the columns and keys have different lengths.
+	 */
+	template<std::integral Key, GroupAggregate... Aggregates>
+	group_by_result<Key, Aggregates...> group_by(thread_pool& pool, std::span<const Key> keys, Aggregates const&... aggregates)
+	{
+		if (((aggregates.values.size() != keys.size()) || ...))
+			throw std::invalid_argument("group_by columns must have the same length as the keys");
+		using table_type = group_table<Key, Aggregates...>;
+		const std::size_t workers = pool.size();
+		if (workers == 1)
+			return group_by(keys, aggregates...);
+
+		std::vector<table_type> local(workers);
+		std::atomic<std::size_t> next{ 0 };
+		pool.for_each_worker([&](std::size_t worker)
+		{
+			for (;;)
+			{
+				const std::size_t begin = next.fetch_add(thread_pool::default_grain, std::memory_order_relaxed);
+				if (begin >= keys.size())
+					break;
+				local[worker].add(begin, std::min(keys.size(), begin + thread_pool::default_grain), keys, aggregates...);
+			}
+		});
+
+		std::vector<table_type> merged(workers);
+		pool.for_each_worker([&](std::size_t worker)
+		{
+			for (table_type const& table : local)
+				merged[worker].merge(table, worker, workers);
+		});
+		local.clear();
+
+		std::vector<std::size_t> offsets(workers + 1, 0);
+		for (std::size_t w = 0; w < workers; ++w)
+			offsets[w + 1] = offsets[w] + merged[w].size();
+		group_by_result<Key, Aggregates...> out;
+		out.resize(offsets[workers]);
+		pool.for_each_worker([&](std::size_t worker) { merged[worker].write(out, offsets[worker]); });
+		return out;
+	}
+}
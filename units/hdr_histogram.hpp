@@ -0,0 +1,270 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include "units.hpp"
+#include "quantity.hpp"
+
+namespace units
+{
+	namespace detail
+	{
+		/*!
+		 * Bucket layout shared by hdr_histogram and shared_hdr_histogram. A value v is bucketed by its bit width
+		 * and its top Precision + 1 bits: with shift = max(bit_width(v) - 1 - Precision, 0),
+		 * index = shift * 2^Precision + (v >> shift). Values below 2^(Precision + 1) get a bucket each, and above
+		 * that every bucket is at most 2^-Precision of its value wide. Computing the index is a bit-width
+		 * instruction, a shift and a multiply-add, with no branches.
+		 */
+		template<unsigned Precision, unsigned Range>
+		struct hdr_layout
+		{
+			static_assert(Precision >= 1 && Precision < Range && Range <= 64, "hdr_histogram needs 1 <= Precision < Range <= 64");
+
+			constexpr static const std::size_t sub_buckets = std::size_t{ 1 } << Precision;
+			constexpr static const std::size_t bucket_count = (Range - Precision + 1) * sub_buckets;
+			constexpr static const std::uint64_t max_value = Range == 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << Range) - 1;
+
+			constexpr static std::size_t index_of(std::uint64_t value)
+			{
+				value = value < max_value ? value : max_value;
+				const unsigned width = static_cast<unsigned>(std::bit_width(value));
+				const unsigned shift = width > Precision + 1 ? width - Precision - 1 : 0;
+				return static_cast<std::size_t>(shift) * sub_buckets + static_cast<std::size_t>(value >> shift);
+			}
+
+			//! The lowest value that lands in bucket index.
+			constexpr static std::uint64_t lowest_value(std::size_t index)
+			{
+				if (index < 2 * sub_buckets)
+					return index;
+				const std::size_t shift = index / sub_buckets - 1;
+				return static_cast<std::uint64_t>(index - shift * sub_buckets) << shift;
+			}
+
+			//! The highest value that lands in bucket index.
+			constexpr static std::uint64_t highest_value(std::size_t index)
+			{
+				if (index < 2 * sub_buckets)
+					return index;
+				const std::size_t shift = index / sub_buckets - 1;
+				return lowest_value(index) + ((std::uint64_t{ 1 } << shift) - 1);
+			}
+		};
+
+		/*!
+		 * Converts a delta to a whole number of UnitType, clamping negative values and NaN to zero and values
+		 * of 2^63 or more (including infinity) to the largest uint64, which lands in the last bucket.
+		 * The conversion is done in the common value_type of the two units and clamped there, before anything
+		 * is cast to an integer, so a double delta recorded in integer ticks cannot overflow the cast.
+		 */
+		template<Unit UnitType, Unit Other>
+		constexpr std::uint64_t hdr_ticks(delta<Other> value)
+		{
+			using conversion = unit_conversion<typename delta<Other>::unit_type, typename delta<UnitType>::unit_type>;
+			using ticks_type = typename conversion::value_type;
+			const ticks_type ticks = conversion::convert(static_cast<ticks_type>(value.value()));
+			if constexpr (std::is_floating_point_v<ticks_type>)
+			{
+				// Through int64, which is a single instruction; uint64 conversion is not on x86 before AVX-512.
+				// The range is clamped in floating point first, since converting NaN or anything outside int64 is undefined.
+				constexpr ticks_type limit = static_cast<ticks_type>(std::uint64_t{ 1 } << 63);
+				const bool above = ticks >= limit;
+				const auto whole = static_cast<std::int64_t>(ticks > 0 && !above ? ticks : ticks_type{});
+				return above ? std::numeric_limits<std::uint64_t>::max() : static_cast<std::uint64_t>(whole);
+			}
+			else if constexpr (std::is_signed_v<ticks_type>)
+				return ticks > 0 ? static_cast<std::uint64_t>(ticks) : 0;
+			else
+				return static_cast<std::uint64_t>(ticks);
+		}
+	}
+
+	/*!
+	 * hdr_histogram is a log-bucketed histogram of deltas, in the style of HdrHistogram. Values are counted
+	 * as whole numbers of UnitType, so UnitType sets the resolution: use nano<si::second> to record latencies
+	 * to the nanosecond, whatever unit they are recorded in. Memory is fixed at bucket_count counters, and
+	 * quantiles are accurate to 2^-Precision of the value (about 0.8% with the default of 7).
+	 *
+	 * Recording is O(1) and branch-free. An instance is not thread-safe; give each thread its own and combine
+	 * them with merge, or merge them into a shared_hdr_histogram.
+	 *
+	 * @tparam UnitType The unit values are counted in.
+	 * @tparam Precision Bits of precision below the leading bit.
+	 * @tparam Range Bits of range; larger values are counted in the last bucket.
+	 */
+	template<Unit UnitType, unsigned Precision = 7, unsigned Range = 64>
+	class hdr_histogram
+	{
+	public:
+
+		using layout = detail::hdr_layout<Precision, Range>;
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+
+		constexpr static const std::size_t bucket_count = layout::bucket_count;
+
+		hdr_histogram()
+			: counts_{ std::make_unique<std::uint64_t[]>(bucket_count) }
+		{}
+
+		hdr_histogram(hdr_histogram const& other)
+			: hdr_histogram()
+		{
+			merge(other);
+		}
+
+		hdr_histogram& operator=(hdr_histogram const& other)
+		{
+			if (this != &other)
+			{
+				reset();
+				merge(other);
+			}
+			return *this;
+		}
+
+		hdr_histogram(hdr_histogram&&) noexcept = default;
+		hdr_histogram& operator=(hdr_histogram&&) noexcept = default;
+
+		/*!
+		 * Records one value, converted to a whole number of UnitType. Negative values are recorded as zero.
+		 */
+		template<Unit Other>
+		requires SimilarUnits<UnitType, Other>
+		void record(delta<Other> value, std::uint64_t count = 1)
+		{
+			record_ticks(detail::hdr_ticks<UnitType>(value), count);
+		}
+
+		//! Records a value that is already a whole number of UnitType.
+		void record_ticks(std::uint64_t ticks, std::uint64_t count = 1)
+		{
+			counts_[layout::index_of(ticks)] += count;
+			total_ += count;
+			min_ = std::min(min_, ticks);
+			max_ = std::max(max_, ticks);
+		}
+
+		//! Adds the counts of other to this histogram.
+		void merge(hdr_histogram const& other)
+		{
+			for (std::size_t i = 0; i < bucket_count; ++i)
+				counts_[i] += other.counts_[i];
+			total_ += other.total_;
+			min_ = std::min(min_, other.min_);
+			max_ = std::max(max_, other.max_);
+		}
+
+		void reset()
+		{
+			std::fill_n(counts_.get(), bucket_count, std::uint64_t{ 0 });
+			total_ = 0;
+			min_ = ~std::uint64_t{ 0 };
+			max_ = 0;
+		}
+
+		std::uint64_t count() const { return total_; }
+
+		//! The smallest recorded value. Only meaningful if count() != 0.
+		delta<UnitType> min() const { return delta<UnitType>{ static_cast<value_type>(min_) }; }
+
+		//! The largest recorded value. Only meaningful if count() != 0.
+		delta<UnitType> max() const { return delta<UnitType>{ static_cast<value_type>(max_) }; }
+
+		/*!
+		 * Returns the value below which a fraction q of the recorded values fall, for example 0.99 for p99.
+		 * The result is the highest value of the bucket the quantile lands in, clamped to the recorded maximum,
+		 * so it never understates a latency. Returns zero if nothing has been recorded.
+		 *
+		 * @throws std::out_of_range If q is not in [0, 1].
+		 */
+		delta<UnitType> quantile(double q) const
+		{
+			if (!(q >= 0.0 && q <= 1.0))
+				throw std::out_of_range("quantile must be in [0, 1]");
+			if (total_ == 0)
+				return delta<UnitType>{};
+			const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total_))));
+			std::uint64_t seen = 0;
+			for (std::size_t i = 0; i < bucket_count; ++i)
+			{
+				seen += counts_[i];
+				if (seen >= rank)
+					return delta<UnitType>{ static_cast<value_type>(std::min(layout::highest_value(i), max_)) };
+			}
+			return max();
+		}
+
+		//! The count in bucket i, for exporting the histogram.
+		std::uint64_t bucket(std::size_t i) const { return counts_[i]; }
+
+	private:
+
+		template<Unit, unsigned, unsigned>
+		friend class shared_hdr_histogram;
+
+		std::unique_ptr<std::uint64_t[]> counts_;
+		std::uint64_t total_ = 0;
+		std::uint64_t min_ = ~std::uint64_t{ 0 };
+		std::uint64_t max_ = 0;
+	};
+
+	/*!
+	 * shared_hdr_histogram collects per-thread hdr_histograms without a lock: merge adds each non-empty bucket
+	 * with a relaxed fetch_add, so threads can merge concurrently, for example at the end of each reporting
+	 * interval. Queries go through snapshot.
+	 */
+	template<Unit UnitType, unsigned Precision = 7, unsigned Range = 64>
+	class shared_hdr_histogram
+	{
+	public:
+
+		using histogram = hdr_histogram<UnitType, Precision, Range>;
+
+		shared_hdr_histogram()
+			: counts_{ std::make_unique<std::atomic<std::uint64_t>[]>(histogram::bucket_count) }
+		{}
+
+		void merge(histogram const& local)
+		{
+			for (std::size_t i = 0; i < histogram::bucket_count; ++i)
+				if (local.counts_[i] != 0)
+					counts_[i].fetch_add(local.counts_[i], std::memory_order_relaxed);
+			total_.fetch_add(local.total_, std::memory_order_relaxed);
+
+			std::uint64_t min = min_.load(std::memory_order_relaxed);
+			while (local.min_ < min && !min_.compare_exchange_weak(min, local.min_, std::memory_order_relaxed)) {}
+			std::uint64_t max = max_.load(std::memory_order_relaxed);
+			while (local.max_ > max && !max_.compare_exchange_weak(max, local.max_, std::memory_order_relaxed)) {}
+		}
+
+		/*!
+		 * Returns a copy of the current counts. Merges running at the same time may be partly included.
+		 */
+		histogram snapshot() const
+		{
+			histogram result;
+			for (std::size_t i = 0; i < histogram::bucket_count; ++i)
+				result.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+			result.total_ = total_.load(std::memory_order_relaxed);
+			result.min_ = min_.load(std::memory_order_relaxed);
+			result.max_ = max_.load(std::memory_order_relaxed);
+			return result;
+		}
+
+	private:
+
+		std::unique_ptr<std::atomic<std::uint64_t>[]> counts_;
+		std::atomic<std::uint64_t> total_{ 0 };
+		std::atomic<std::uint64_t> min_{ ~std::uint64_t{ 0 } };
+		std::atomic<std::uint64_t> max_{ 0 };
+	};
+}
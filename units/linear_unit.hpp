@@ -3,6 +3,7 @@
 #include <cstdint>
 #include "units.hpp"
 #include "difference_unit.hpp"
+#include "unit_scale.hpp"
 
 namespace units
 {
@@ -42,19 +43,30 @@ namespace units
 
 		constexpr static value_type to_fundamental(value_type v)
 		{
-			return Ratio::apply_inverse(v);
+			return BaseUnit::to_fundamental(Ratio::apply_inverse(v));
 		}
 
 		constexpr static value_type from_fundamental(value_type v)
 		{
-			return Ratio::apply(v);
+			return Ratio::apply(BaseUnit::from_fundamental(v));
 		}
 	};
 
 	/*!
-	 * offset_unit represents a unit that is a fixed offset from another unit. For example, celsius could be defined as 
+	 * Specialization of unit_scale for scaled_unit. Ratio is the number of this unit per
+	 * Ratio::den BaseUnits, so the scale is the scale of BaseUnit times den / num.
+	 */
+	template<Unit BaseUnit, class Ratio>
+	struct unit_scale<scaled_unit<BaseUnit, Ratio>>
+	{
+		constexpr static const detail::scale_factor value = detail::multiply(unit_scale_v<BaseUnit>, detail::ratio_scale<Ratio>());
+	};
+
+	/*!
+	 * offset_unit represents a unit that is a fixed offset from another unit: the base value is the value minus Offset::value.
+	 * For example, celsius could be defined as
 	 * @code
-	 * struct celsius_offset_type { constexpr static const double value = 273.15;};
+	 * struct celsius_offset_type { constexpr static const double value = -273.15;};
 	 * using celsius = offset_unit<kelvin, celsius_offset_type>;
 	 * @endcode
 	 */
@@ -162,6 +174,28 @@ namespace units
 
 		template<Unit unit>
 		using giga = scaled_unit<unit, ratio<1, 1000000000>>;
+
+		/*!
+		 * IEC binary prefixes. These are exact powers of two, so conversions between them
+		 * on integer value types reduce to shifts.
+		 */
+		template<Unit unit>
+		using kibi = scaled_unit<unit, ratio<1, 1024>>;
+
+		template<Unit unit>
+		using mebi = scaled_unit<unit, ratio<1, 1048576>>;
+
+		template<Unit unit>
+		using gibi = scaled_unit<unit, ratio<1, 1073741824>>;
+
+		template<Unit unit>
+		using tebi = scaled_unit<unit, ratio<1, 1099511627776>>;
+
+		template<Unit unit>
+		using pebi = scaled_unit<unit, ratio<1, 1125899906842624>>;
+
+		template<Unit unit>
+		using exbi = scaled_unit<unit, ratio<1, 1152921504606846976>>;
 	}
 
 	using namespace prefixes;
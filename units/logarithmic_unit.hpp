@@ -0,0 +1,368 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include "units.hpp"
+#include "difference_unit.hpp"
+#include "detail/unit_comparisons.hpp"
+#include "compound_unit.hpp"
+#include "quantity.hpp"
+
+namespace units
+{
+	/*!
+	 * Scale types for logarithmic_unit. A level L in a logarithmic unit with scale k is
+	 * L = k * ln(x / reference), where x is in the base unit.
+	 */
+	namespace log_scales
+	{
+		//! Decibels of a power-like quantity: 10 log10(P / P0).
+		struct decibel_power { constexpr static const double value = 10.0 / std::numbers::ln10; };
+
+		//! Decibels of a field (root-power) quantity: 20 log10(V / V0).
+		struct decibel_field { constexpr static const double value = 20.0 / std::numbers::ln10; };
+
+		//! Bels of a power-like quantity: log10(P / P0).
+		struct bel { constexpr static const double value = 1.0 / std::numbers::ln10; };
+
+		//! Nepers of a field quantity: ln(V / V0).
+		struct neper { constexpr static const double value = 1.0; };
+
+		//! "p" functions such as pH: -log10(a / a0).
+		struct p_function { constexpr static const double value = -1.0 / std::numbers::ln10; };
+	}
+
+	/*!
+	 * Tag used by the difference unit of logarithmic units. The tag carries the tag of the
+	 * base unit, so a level difference in dB of power is not interchangeable with one in dB of voltage.
+	 */
+	template<class BaseTag>
+	struct log_ratio_tag {};
+
+	/*!
+	 * log_ratio_unit is the difference_unit of a logarithmic_unit: a gain or attenuation.
+	 * Its fundamental form is the natural log of the ratio of the base quantities, so ratios in
+	 * different scales (dB and Np, say) convert by a constant factor.
+	 */
+	template<Unit BaseUnit, class Scale>
+	struct log_ratio_unit
+	{
+		using base_unit = BaseUnit;
+		using scale_type = Scale;
+		using value_type = typename BaseUnit::value_type;
+		using unit_tag = log_ratio_tag<tag_of_t<BaseUnit>>;
+
+		constexpr static value_type to_fundamental(value_type value)
+		{
+			return static_cast<value_type>(value / Scale::value);
+		}
+
+		constexpr static value_type from_fundamental(value_type value)
+		{
+			return static_cast<value_type>(value * Scale::value);
+		}
+	};
+
+	/*!
+	 * logarithmic_unit represents a level: a logarithm of the ratio between a quantity in BaseUnit and a
+	 * fixed reference. For example, dBm is
+	 * @code
+	 * struct milliwatt { constexpr static const double value = 0.001; };
+	 * using dBm = logarithmic_unit<watt, milliwatt, log_scales::decibel_power>;
+	 * @endcode
+	 * Levels convert to each other (dBm to dBW) and to and from the base unit through to_fundamental and
+	 * from_fundamental, which use exp and log. The difference of two levels is a delta in
+	 * log_ratio_unit, so adding a delta to a level multiplies the linear quantity: quantity<dBm> + delta<dBm>
+	 * applies a gain. Adding two levels is not defined, just as adding two absolute temperatures is not.
+	 *
+	 * @tparam BaseUnit The linear unit the level is taken of.
+	 * @tparam Reference Provides a static value, the reference quantity in BaseUnit.
+	 * @tparam Scale Provides a static value k, where level = k * ln(x / reference). See log_scales.
+	 */
+	template<Unit BaseUnit, class Reference, class Scale>
+	struct logarithmic_unit
+	{
+		using base_unit = BaseUnit;
+		using reference_type = Reference;
+		using scale_type = Scale;
+		using value_type = typename BaseUnit::value_type;
+		using unit_tag = typename BaseUnit::unit_tag;
+
+		//! Returns the quantity in BaseUnit for a level.
+		static value_type to_linear(value_type level)
+		{
+			return static_cast<value_type>(Reference::value * std::exp(level / Scale::value));
+		}
+
+		//! Returns the level of a quantity in BaseUnit.
+		static value_type from_linear(value_type value)
+		{
+			return static_cast<value_type>(Scale::value * std::log(value / Reference::value));
+		}
+
+		static value_type to_fundamental(value_type level)
+		{
+			return BaseUnit::to_fundamental(to_linear(level));
+		}
+
+		static value_type from_fundamental(value_type value)
+		{
+			return from_linear(BaseUnit::from_fundamental(value));
+		}
+	};
+
+	/*!
+	 * Specialization of difference_unit for logarithmic_unit. The reference cancels when two levels
+	 * are subtracted, leaving the log of the ratio, so every level of the same base unit and scale
+	 * shares one difference unit.
+	 */
+	template<Unit BaseUnit, class Reference, class Scale>
+	struct difference_unit<logarithmic_unit<BaseUnit, Reference, Scale>>
+	{
+		using type = log_ratio_unit<BaseUnit, Scale>;
+	};
+
+	/*!
+	 * Specialization of exponent_of. A level has the exponent of the quantity it is a level of.
+	 */
+	template<Unit BaseUnit, class Reference, class Scale>
+	struct exponent_of<logarithmic_unit<BaseUnit, Reference, Scale>> : exponent_of<BaseUnit> {};
+
+	/*!
+	 * Specializations of compare_tag and compare_exponent. A level compares as its base unit, so
+	 * similar_units holds between a level and its base unit even when the base is a compound_unit,
+	 * and quantity<watt> can be constructed from quantity<dBm>.
+	 */
+	template<Unit BaseUnit, class Reference, class Scale, Unit Other>
+	struct compare_tag<logarithmic_unit<BaseUnit, Reference, Scale>, Other> : compare_tag<BaseUnit, Other> {};
+
+	template<Unit Other, Unit BaseUnit, class Reference, class Scale>
+	struct compare_tag<Other, logarithmic_unit<BaseUnit, Reference, Scale>> : compare_tag<Other, BaseUnit> {};
+
+	template<Unit BaseA, class ReferenceA, class ScaleA, Unit BaseB, class ReferenceB, class ScaleB>
+	struct compare_tag<logarithmic_unit<BaseA, ReferenceA, ScaleA>, logarithmic_unit<BaseB, ReferenceB, ScaleB>> : compare_tag<BaseA, BaseB> {};
+
+	template<Unit BaseUnit, class Reference, class Scale, Unit... Compound>
+	struct compare_tag<logarithmic_unit<BaseUnit, Reference, Scale>, compound_unit<Compound...>> : compare_tag<BaseUnit, compound_unit<Compound...>> {};
+
+	template<Unit... Compound, Unit BaseUnit, class Reference, class Scale>
+	struct compare_tag<compound_unit<Compound...>, logarithmic_unit<BaseUnit, Reference, Scale>> : compare_tag<compound_unit<Compound...>, BaseUnit> {};
+
+	template<Unit BaseUnit, class Reference, class Scale, Unit Other>
+	struct compare_exponent<logarithmic_unit<BaseUnit, Reference, Scale>, Other> : compare_exponent<BaseUnit, Other> {};
+
+	template<Unit Other, Unit BaseUnit, class Reference, class Scale>
+	struct compare_exponent<Other, logarithmic_unit<BaseUnit, Reference, Scale>> : compare_exponent<Other, BaseUnit> {};
+
+	template<Unit BaseA, class ReferenceA, class ScaleA, Unit BaseB, class ReferenceB, class ScaleB>
+	struct compare_exponent<logarithmic_unit<BaseA, ReferenceA, ScaleA>, logarithmic_unit<BaseB, ReferenceB, ScaleB>> : compare_exponent<BaseA, BaseB> {};
+
+	template<Unit BaseUnit, class Reference, class Scale, Unit... Compound>
+	struct compare_exponent<logarithmic_unit<BaseUnit, Reference, Scale>, compound_unit<Compound...>> : compare_exponent<BaseUnit, compound_unit<Compound...>> {};
+
+	template<Unit... Compound, Unit BaseUnit, class Reference, class Scale>
+	struct compare_exponent<compound_unit<Compound...>, logarithmic_unit<BaseUnit, Reference, Scale>> : compare_exponent<compound_unit<Compound...>, BaseUnit> {};
+
+	/*!
+	 * Specializations of compare_tag and compare_exponent for log_ratio_unit. A ratio is only similar to
+	 * another ratio of the same base unit, so delta<watt> cannot be added to quantity<dBm>. The exponent
+	 * is taken from the base unit, which keeps the comparison from building a compound_unit over a log_ratio_tag.
+	 */
+	template<Unit BaseUnit, class Scale, Unit Other>
+	struct compare_tag<log_ratio_unit<BaseUnit, Scale>, Other> { using type = std::false_type; };
+
+	template<Unit Other, Unit BaseUnit, class Scale>
+	struct compare_tag<Other, log_ratio_unit<BaseUnit, Scale>> { using type = std::false_type; };
+
+	template<Unit BaseA, class ScaleA, Unit BaseB, class ScaleB>
+	struct compare_tag<log_ratio_unit<BaseA, ScaleA>, log_ratio_unit<BaseB, ScaleB>> : compare_tag<BaseA, BaseB> {};
+
+	template<Unit BaseUnit, class Scale, Unit... Compound>
+	struct compare_tag<log_ratio_unit<BaseUnit, Scale>, compound_unit<Compound...>> { using type = std::false_type; };
+
+	template<Unit... Compound, Unit BaseUnit, class Scale>
+	struct compare_tag<compound_unit<Compound...>, log_ratio_unit<BaseUnit, Scale>> { using type = std::false_type; };
+
+	template<Unit BaseA, class ScaleA, Unit BaseB, class ReferenceB, class ScaleB>
+	struct compare_tag<log_ratio_unit<BaseA, ScaleA>, logarithmic_unit<BaseB, ReferenceB, ScaleB>> { using type = std::false_type; };
+
+	template<Unit BaseA, class ReferenceA, class ScaleA, Unit BaseB, class ScaleB>
+	struct compare_tag<logarithmic_unit<BaseA, ReferenceA, ScaleA>, log_ratio_unit<BaseB, ScaleB>> { using type = std::false_type; };
+
+	template<Unit BaseUnit, class Scale, Unit Other>
+	struct compare_exponent<log_ratio_unit<BaseUnit, Scale>, Other> : compare_exponent<BaseUnit, Other> {};
+
+	template<Unit Other, Unit BaseUnit, class Scale>
+	struct compare_exponent<Other, log_ratio_unit<BaseUnit, Scale>> : compare_exponent<Other, BaseUnit> {};
+
+	template<Unit BaseA, class ScaleA, Unit BaseB, class ScaleB>
+	struct compare_exponent<log_ratio_unit<BaseA, ScaleA>, log_ratio_unit<BaseB, ScaleB>> : compare_exponent<BaseA, BaseB> {};
+
+	template<Unit BaseUnit, class Scale, Unit... Compound>
+	struct compare_exponent<log_ratio_unit<BaseUnit, Scale>, compound_unit<Compound...>> : compare_exponent<BaseUnit, compound_unit<Compound...>> {};
+
+	template<Unit... Compound, Unit BaseUnit, class Scale>
+	struct compare_exponent<compound_unit<Compound...>, log_ratio_unit<BaseUnit, Scale>> : compare_exponent<compound_unit<Compound...>, BaseUnit> {};
+
+	template<Unit BaseA, class ScaleA, Unit BaseB, class ReferenceB, class ScaleB>
+	struct compare_exponent<log_ratio_unit<BaseA, ScaleA>, logarithmic_unit<BaseB, ReferenceB, ScaleB>> : compare_exponent<BaseA, BaseB> {};
+
+	template<Unit BaseA, class ReferenceA, class ScaleA, Unit BaseB, class ScaleB>
+	struct compare_exponent<logarithmic_unit<BaseA, ReferenceA, ScaleA>, log_ratio_unit<BaseB, ScaleB>> : compare_exponent<BaseA, BaseB> {};
+
+	/*!
+	 * Selects how batch level conversions compute exp and log.
+	 */
+	enum class log_precision
+	{
+		//! Polynomial approximations, evaluated branch-free so the loops vectorise. See detail::fast_exp and detail::fast_log.
+		fast,
+		//! std::exp and std::log.
+		precise,
+	};
+
+	namespace detail
+	{
+		/*!
+		 * exp(x) for doubles without calls or branches in the common path. x is split into n ln2 + r with
+		 * |r| <= ln2 / 2, exp(r) is a degree 11 Taylor polynomial, and 2^n is built directly in the exponent bits.
+		 * The truncation error is below 7e-15 relative; with rounding the result is within 1e-14 relative
+		 * of std::exp for x in [-708, 709]. Inputs outside that range are clamped to it, so they give
+		 * exp(-708) (about 3.3e-308) or exp(709) (about 8.2e307) rather than denormals, 0 or infinity.
+		 * NaN is selected through unchanged.
+		 */
+		inline double fast_exp(double x)
+		{
+			const bool nan = x != x;
+			const double clamped = nan ? 0.0 : (x < -708.0 ? -708.0 : (x > 709.0 ? 709.0 : x));
+			const double n = std::nearbyint(clamped * std::numbers::log2e);
+			// ln2 split in two (Cody-Waite) so n * ln2_high is exact and r keeps its low bits.
+			const double r = (clamped - n * 6.93147180369123816490e-01) - n * 1.90821492927058770002e-10;
+
+			double p = 1.0 / 39916800.0;
+			p = p * r + 1.0 / 3628800.0;
+			p = p * r + 1.0 / 362880.0;
+			p = p * r + 1.0 / 40320.0;
+			p = p * r + 1.0 / 5040.0;
+			p = p * r + 1.0 / 720.0;
+			p = p * r + 1.0 / 120.0;
+			p = p * r + 1.0 / 24.0;
+			p = p * r + 1.0 / 6.0;
+			p = p * r + 0.5;
+			p = p * r + 1.0;
+			p = p * r + 1.0;
+
+			const auto exponent = static_cast<std::int64_t>(n) + 1023;
+			const double result = p * std::bit_cast<double>(static_cast<std::uint64_t>(exponent) << 52);
+			return nan ? x : result;
+		}
+
+		/*!
+		 * log(x) for positive normal doubles without calls or branches. x is split into m 2^e with
+		 * m in [sqrt(1/2), sqrt(2)), and log(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172, is
+		 * summed to s^19. The truncation error is below 1e-17; with rounding the result is within 4e-16
+		 * absolute (plus 1 ulp of e ln2) of std::log. Zero, negative, denormal, infinite and NaN inputs
+		 * give meaningless results and must go through the precise path.
+		 */
+		inline double fast_log(double x)
+		{
+			const auto bits = std::bit_cast<std::uint64_t>(x);
+			// Bias the exponent so the mantissa lands in [sqrt(1/2), sqrt(2)) rather than [1, 2).
+			const std::uint64_t shifted = bits - 0x3FE6A09E667F3BCDull;
+			const auto e = static_cast<std::int64_t>(shifted) >> 52;
+			const double m = std::bit_cast<double>(bits - (static_cast<std::uint64_t>(e) << 52));
+
+			const double s = (m - 1.0) / (m + 1.0);
+			const double s2 = s * s;
+			double p = 1.0 / 19.0;
+			p = p * s2 + 1.0 / 17.0;
+			p = p * s2 + 1.0 / 15.0;
+			p = p * s2 + 1.0 / 13.0;
+			p = p * s2 + 1.0 / 11.0;
+			p = p * s2 + 1.0 / 9.0;
+			p = p * s2 + 1.0 / 7.0;
+			p = p * s2 + 1.0 / 5.0;
+			p = p * s2 + 1.0 / 3.0;
+			p = p * s2 + 1.0;
+
+			return static_cast<double>(e) * std::numbers::ln2 + 2.0 * s * p;
+		}
+
+		inline bool fast_log_domain(double x)
+		{
+			return x >= std::numeric_limits<double>::min() && x <= std::numeric_limits<double>::max();
+		}
+	}
+
+	/*!
+	 * Converts a batch of levels to the linear base unit. With log_precision::fast the conversion uses
+	 * detail::fast_exp and runs as one branch-free loop; with log_precision::precise it uses std::exp.
+	 *
+	 * @throws std::invalid_argument If out is shorter than levels.
+	 */
+	template<Unit BaseUnit, class Reference, class Scale>
+	void to_linear(std::span<const quantity<logarithmic_unit<BaseUnit, Reference, Scale>>> levels, std::span<quantity<BaseUnit>> out, log_precision precision = log_precision::fast)
+	{
+		using value_type = typename BaseUnit::value_type;
+		if (out.size() < levels.size())
+			throw std::invalid_argument("to_linear output is shorter than the input");
+
+		constexpr double inverse_scale = 1.0 / Scale::value;
+		if (precision == log_precision::fast)
+		{
+			for (std::size_t i = 0; i < levels.size(); ++i)
+				out[i] = quantity<BaseUnit>{ static_cast<value_type>(Reference::value * detail::fast_exp(static_cast<double>(levels[i].value()) * inverse_scale)) };
+		}
+		else
+		{
+			for (std::size_t i = 0; i < levels.size(); ++i)
+				out[i] = quantity<BaseUnit>{ static_cast<value_type>(Reference::value * std::exp(static_cast<double>(levels[i].value()) * inverse_scale)) };
+		}
+	}
+
+	/*!
+	 * Converts a batch of linear quantities to levels. With log_precision::fast the conversion uses
+	 * detail::fast_log in one branch-free loop, then recomputes with std::log any element that is outside
+	 * the fast path's domain (zero, negative, denormal, infinite or NaN), so the results match the precise
+	 * path for those inputs. With log_precision::precise it uses std::log throughout.
+	 *
+	 * @throws std::invalid_argument If out is shorter than values.
+	 */
+	template<Unit BaseUnit, class Reference, class Scale>
+	void from_linear(std::span<const quantity<BaseUnit>> values, std::span<quantity<logarithmic_unit<BaseUnit, Reference, Scale>>> out, log_precision precision = log_precision::fast)
+	{
+		using level_unit = logarithmic_unit<BaseUnit, Reference, Scale>;
+		using value_type = typename BaseUnit::value_type;
+		if (out.size() < values.size())
+			throw std::invalid_argument("from_linear output is shorter than the input");
+
+		constexpr double inverse_reference = 1.0 / Reference::value;
+		if (precision == log_precision::fast)
+		{
+			bool all_in_domain = true;
+			for (std::size_t i = 0; i < values.size(); ++i)
+			{
+				const double ratio = static_cast<double>(values[i].value()) * inverse_reference;
+				all_in_domain &= detail::fast_log_domain(ratio);
+				out[i] = quantity<level_unit>{ static_cast<value_type>(Scale::value * detail::fast_log(ratio)) };
+			}
+			if (all_in_domain)
+				return;
+			for (std::size_t i = 0; i < values.size(); ++i)
+			{
+				const double ratio = static_cast<double>(values[i].value()) * inverse_reference;
+				if (!detail::fast_log_domain(ratio))
+					out[i] = quantity<level_unit>{ static_cast<value_type>(Scale::value * std::log(ratio)) };
+			}
+		}
+		else
+		{
+			for (std::size_t i = 0; i < values.size(); ++i)
+				out[i] = quantity<level_unit>{ static_cast<value_type>(Scale::value * std::log(static_cast<double>(values[i].value()) * inverse_reference)) };
+		}
+	}
+}
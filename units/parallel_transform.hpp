@@ -0,0 +1,341 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "atomic_quantity.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#define CPP_UNITS_HAS_THREAD_AFFINITY 1
+#endif
+
+namespace units
+{
+	/*!
+	 * thread_pool is a fixed set of worker threads for data-parallel loops over large arrays.
+	 *
+	 * Work is split the same way every time: each worker owns a contiguous, page-aligned part of the index
+	 * range (see partition), takes chunks from the front of its own part and, once that is exhausted,
+	 * steals chunks from the parts of the other workers. On an even load every worker touches only its own
+	 * part, so memory written first by first_touch with the same pool stays on the worker's NUMA node;
+	 * on an uneven load the idle workers take over the remainder. With pin_threads the worker threads are
+	 * bound to one CPU each (on Linux), so the OS does not move them away from their memory; the calling
+	 * thread is left as it is.
+	 *
+	 * The calling thread works as worker 0, so a pool of size 1 has no threads and runs loops inline.
+	 * for_each_chunk must not be called from inside a loop on the same pool; calls from different threads
+	 * are run one after the other.
+	 */
+	class thread_pool
+	{
+	public:
+
+		//! The default number of elements taken at once.
+		constexpr static const std::size_t default_grain = 16384;
+
+		explicit thread_pool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()), bool pin_threads = false)
+			: size_{ std::max<std::size_t>(1, threads) }
+		{
+			workers_.reserve(size_ - 1);
+			for (std::size_t i = 1; i < size_; ++i)
+				workers_.emplace_back([this, i] { work(i); });
+			if (pin_threads)
+				pin();
+		}
+
+		thread_pool(thread_pool const&) = delete;
+		thread_pool& operator=(thread_pool const&) = delete;
+
+		~thread_pool()
+		{
+			{
+				std::lock_guard lock{ mutex_ };
+				stop_ = true;
+			}
+			wake_.notify_all();
+			for (std::thread& worker : workers_)
+				worker.join();
+		}
+
+		std::size_t size() const { return size_; }
+
+		/*!
+		 * The part of [0, count) that worker owns: equal parts, with the boundaries rounded to multiples of
+		 * align elements (a page of the element type, for first_touch) so no page is shared by two workers.
+		 */
+		std::pair<std::size_t, std::size_t> partition(std::size_t worker, std::size_t count, std::size_t align = 1) const
+		{
+			const auto boundary = [&](std::size_t w)
+			{
+				if (w >= size_)
+					return count;
+				const std::size_t even = count / size_ * w + count % size_ * w / size_;
+				return std::min(count, even / align * align);
+			};
+			return { boundary(worker), boundary(worker + 1) };
+		}
+
+		/*!
+		 * Calls fn(begin, end) on disjoint chunks covering [0, count), from every worker, with work stealing.
+		 * If fn throws, the remaining chunks are skipped and the first exception is rethrown here once every
+		 * worker has stopped.
+		 *
+		 * @param grain The number of elements taken at once. Chunks are at most grain long.
+		 * @param align Part boundaries are multiples of align; see partition.
+		 */
+		template<class Fn>
+		void for_each_chunk(std::size_t count, Fn&& fn, std::size_t grain = default_grain, std::size_t align = 1)
+		{
+			if (count == 0)
+				return;
+			grain = std::max<std::size_t>(1, grain);
+			if (size_ == 1)
+			{
+				for (std::size_t begin = 0; begin < count; begin += grain)
+					fn(begin, std::min(count, begin + grain));
+				return;
+			}
+
+			std::unique_ptr<part[]> parts{ new part[size_] };
+			for (std::size_t w = 0; w < size_; ++w)
+			{
+				const auto [begin, end] = partition(w, count, align);
+				parts[w].next.store(begin, std::memory_order_relaxed);
+				parts[w].end = end;
+			}
+
+			std::atomic<bool> failed{ false };
+			auto body = [&](std::size_t worker)
+			{
+				for (std::size_t k = 0; k < size_ && !failed.load(std::memory_order_relaxed); ++k)
+				{
+					part& victim = parts[(worker + k) % size_];
+					while (!failed.load(std::memory_order_relaxed))
+					{
+						const std::size_t begin = victim.next.fetch_add(grain, std::memory_order_relaxed);
+						if (begin >= victim.end)
+							break;
+						fn(begin, std::min(victim.end, begin + grain));
+					}
+				}
+			};
+			run(body, failed);
+		}
+
+		/*!
+		 * Calls fn(begin, end) once from each worker with the part of [0, count) it owns, without stealing,
+		 * so each part is always processed by the same worker; see first_touch.
+		 */
+		template<class Fn>
+		void for_each_part(std::size_t count, Fn&& fn, std::size_t align = 1)
+		{
+			for_each_worker([&](std::size_t worker)
+			{
+				const auto [begin, end] = partition(worker, count, align);
+				if (begin < end)
+					fn(begin, end);
+			});
+		}
+
+		/*!
+		 * Calls fn(worker) once from each worker, with worker in [0, size()), for loops that keep per-worker
+		 * state such as partial results. Exceptions are handled as for for_each_chunk.
+		 */
+		template<class Fn>
+		void for_each_worker(Fn&& fn)
+		{
+			std::atomic<bool> failed{ false };
+			if (size_ == 1)
+				fn(std::size_t{ 0 });
+			else
+				run(fn, failed);
+		}
+
+	private:
+
+		struct alignas(detail::cache_line_size) part
+		{
+			std::atomic<std::size_t> next{ 0 };
+			std::size_t end = 0;
+		};
+
+		using job_function = void (*)(void*, std::size_t);
+
+		template<class Body>
+		void run(Body& body, std::atomic<bool>& failed)
+		{
+			std::lock_guard serial{ run_mutex_ };
+			std::exception_ptr error;
+			std::mutex error_mutex;
+			auto guarded = [&](std::size_t worker)
+			{
+				try
+				{
+					body(worker);
+				}
+				catch (...)
+				{
+					failed.store(true, std::memory_order_relaxed);
+					std::lock_guard lock{ error_mutex };
+					if (!error)
+						error = std::current_exception();
+				}
+			};
+
+			{
+				std::lock_guard lock{ mutex_ };
+				job_ = [](void* context, std::size_t worker) { (*static_cast<decltype(guarded)*>(context))(worker); };
+				context_ = &guarded;
+				pending_ = size_ - 1;
+				++generation_;
+			}
+			wake_.notify_all();
+			guarded(0);
+			{
+				std::unique_lock lock{ mutex_ };
+				done_.wait(lock, [this] { return pending_ == 0; });
+			}
+			if (error)
+				std::rethrow_exception(error);
+		}
+
+		void work(std::size_t worker)
+		{
+			std::uint64_t seen = 0;
+			for (;;)
+			{
+				job_function job;
+				void* context;
+				{
+					std::unique_lock lock{ mutex_ };
+					wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+					if (stop_)
+						return;
+					seen = generation_;
+					job = job_;
+					context = context_;
+				}
+				job(context, worker);
+				{
+					std::lock_guard lock{ mutex_ };
+					if (--pending_ == 0)
+						done_.notify_one();
+				}
+			}
+		}
+
+		void pin()
+		{
+#ifdef CPP_UNITS_HAS_THREAD_AFFINITY
+			const std::size_t cpus = std::max(1u, std::thread::hardware_concurrency());
+			const auto bind = [cpus](pthread_t thread, std::size_t worker)
+			{
+				cpu_set_t set;
+				CPU_ZERO(&set);
+				CPU_SET(worker % cpus, &set);
+				pthread_setaffinity_np(thread, sizeof(set), &set);
+			};
+			for (std::size_t i = 0; i < workers_.size(); ++i)
+				bind(workers_[i].native_handle(), i + 1);
+#endif
+		}
+
+		std::size_t size_;
+		std::vector<std::thread> workers_;
+		std::mutex run_mutex_;
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable done_;
+		job_function job_ = nullptr;
+		void* context_ = nullptr;
+		std::size_t pending_ = 0;
+		std::uint64_t generation_ = 0;
+		bool stop_ = false;
+	};
+
+	namespace detail
+	{
+		//! The number of elements of T in a 4 KiB page, the alignment of first-touch partitions.
+		template<class T>
+		constexpr std::size_t page_elements()
+		{
+			return std::max<std::size_t>(1, 4096 / sizeof(T));
+		}
+	}
+
+	/*!
+	 * Writes value to every element of out from the worker that owns it in pool.partition, so that on a first-touch NUMA policy each page is placed on the node of the worker that
+	 * will process it in parallel_transform. Use it on freshly allocated memory, before anything else writes it.
+	 */
+	template<class T>
+	void first_touch(thread_pool& pool, std::span<T> out, T const& value = T{})
+	{
+		pool.for_each_part(out.size(), [&](std::size_t begin, std::size_t end)
+		{
+			std::fill(out.begin() + static_cast<std::ptrdiff_t>(begin), out.begin() + static_cast<std::ptrdiff_t>(end), value);
+		}, detail::page_elements<T>());
+	}
+
+	/*!
+	 * Allocates count elements without initializing them and first-touches them from pool.
+	 */
+	template<class T>
+	requires std::is_trivially_copyable_v<T>
+	std::unique_ptr<T[]> make_first_touch_array(thread_pool& pool, std::size_t count, T const& value = T{})
+	{
+		std::unique_ptr<T[]> result{ std::make_unique_for_overwrite<T[]>(count) };
+		first_touch(pool, std::span<T>{ result.get(), count }, value);
+		return result;
+	}
+
+	/*!
+	 * out[i] = fn(in[i]) in parallel on pool. fn takes a quantity or delta and returns something that converts
+	 * implicitly to the output element, so the units are checked as for a plain assignment: a lambda
+	 * returning meters can fill an array of millimeters but not one of seconds.
+	 *
+	 * @throws std::invalid_argument If in and out have different lengths.
+	 */
+	template<detail::QuantityOrDelta In, detail::QuantityOrDelta Out, class Fn>
+	requires std::is_convertible_v<std::invoke_result_t<Fn&, In const&>, Out>
+	void parallel_transform(thread_pool& pool, std::span<const In> in, std::span<Out> out, Fn fn, std::size_t grain = thread_pool::default_grain)
+	{
+		if (in.size() != out.size())
+			throw std::invalid_argument("parallel_transform spans must have the same length");
+		pool.for_each_chunk(in.size(), [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+				out[i] = fn(in[i]);
+		}, grain, detail::page_elements<Out>());
+	}
+
+	/*!
+	 * out[i] = fn(a[i], b[i]) in parallel on pool, for kinematics-style updates such as x + v * dt.
+	 *
+	 * @throws std::invalid_argument If the spans have different lengths.
+	 */
+	template<detail::QuantityOrDelta A, detail::QuantityOrDelta B, detail::QuantityOrDelta Out, class Fn>
+	requires std::is_convertible_v<std::invoke_result_t<Fn&, A const&, B const&>, Out>
+	void parallel_transform(thread_pool& pool, std::span<const A> a, std::span<const B> b, std::span<Out> out, Fn fn, std::size_t grain = thread_pool::default_grain)
+	{
+		if (a.size() != out.size() || b.size() != out.size())
+			throw std::invalid_argument("parallel_transform spans must have the same length");
+		pool.for_each_chunk(out.size(), [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+				out[i] = fn(a[i], b[i]);
+		}, grain, detail::page_elements<Out>());
+	}
+}
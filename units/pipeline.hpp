@@ -0,0 +1,399 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "units.hpp"
+#include "unit_conversion.hpp"
+#include "quantity.hpp"
+#include "atomic_quantity.hpp"
+
+namespace units
+{
+	/*!
+	 * quantity_batch is a fixed-capacity block of values that share one unit. It is the unit of work
+	 * passed between pipeline stages: the unit is part of the type, so a batch can only be handed to a
+	 * stage that expects it, and the values are raw value_type so a whole batch converts in one loop.
+	 *
+	 * @tparam UnitType The unit of every value in the batch.
+	 * @tparam Capacity The maximum number of values in the batch.
+	 */
+	template<Unit UnitType, std::size_t Capacity>
+	class quantity_batch
+	{
+	public:
+
+		using value_type = typename UnitType::value_type;
+		using unit_type = UnitType;
+
+		constexpr static const std::size_t capacity = Capacity;
+
+		constexpr quantity_batch() = default;
+
+		constexpr std::size_t size() const { return size_; }
+		constexpr bool empty() const { return size_ == 0; }
+		constexpr bool full() const { return size_ == Capacity; }
+		constexpr void clear() { size_ = 0; }
+
+		/*!
+		 * Appends a raw value, which is taken to be in UnitType. This is the form a decoder uses
+		 * when the device reports values in a known unit.
+		 *
+		 * @throws std::length_error If the batch is full.
+		 */
+		constexpr void push_back(value_type value)
+		{
+			if (size_ == Capacity)
+				throw std::length_error("quantity_batch is full");
+			values_[size_++] = value;
+		}
+
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		constexpr void push_back(quantity<unit> value)
+		{
+			push_back(quantity<UnitType>{ value }.value());
+		}
+
+		constexpr quantity<UnitType> operator[](std::size_t i) const
+		{
+			return quantity<UnitType>{ values_[i] };
+		}
+
+		/*!
+		 * Returns the raw values currently in the batch.
+		 */
+		constexpr std::span<value_type> values() { return std::span<value_type>{ values_.data(), size_ }; }
+		constexpr std::span<const value_type> values() const { return std::span<const value_type>{ values_.data(), size_ }; }
+
+	private:
+
+		std::array<value_type, Capacity> values_{};
+		std::size_t size_ = 0;
+	};
+
+	/*!
+	 * Converts a whole batch to Target. The conversion is resolved at compile time and applied in a
+	 * single loop over the raw values, so it vectorises and costs nothing per element beyond the arithmetic.
+	 */
+	template<Unit Target, Unit Source, std::size_t Capacity>
+	requires SimilarUnits<Target, Source>
+	constexpr quantity_batch<Target, Capacity> normalise(quantity_batch<Source, Capacity> const& batch)
+	{
+		quantity_batch<Target, Capacity> result;
+		for (const auto value : batch.values())
+			result.push_back(static_cast<typename Target::value_type>(unit_conversion<Source, Target>::convert(value)));
+		return result;
+	}
+
+	/*!
+	 * Function object form of normalise, for use as a pipeline_stage function.
+	 */
+	template<Unit Target>
+	struct normalise_to
+	{
+		template<Unit Source, std::size_t Capacity>
+		requires SimilarUnits<Target, Source>
+		constexpr quantity_batch<Target, Capacity> operator()(quantity_batch<Source, Capacity> const& batch) const
+		{
+			return normalise<Target>(batch);
+		}
+	};
+
+	/*!
+	 * Bounded single-producer, single-consumer queue. Pushes and pops are wait-free: each side owns one
+	 * index and keeps a cached copy of the other, so the shared indices are only read when the cache says
+	 * the queue looks full (or empty). A failed try_push is the backpressure signal.
+	 *
+	 * @tparam T The element type. Must be default constructible and movable.
+	 */
+	template<class T>
+	class spsc_queue
+	{
+	public:
+
+		/*!
+		 * Constructs a queue that can hold at least capacity elements. The capacity is rounded up to a power of two.
+		 */
+		explicit spsc_queue(std::size_t capacity)
+			: capacity_{ std::bit_ceil(std::max<std::size_t>(capacity, 2)) },
+			  slots_{ std::make_unique<T[]>(capacity_) }
+		{}
+
+		spsc_queue(spsc_queue const&) = delete;
+		spsc_queue& operator=(spsc_queue const&) = delete;
+
+		std::size_t capacity() const { return capacity_; }
+
+		/*!
+		 * Moves value into the queue if there is room. Returns false, leaving value untouched, if the queue is full.
+		 * Must only be called from the producer thread.
+		 */
+		bool try_push(T& value)
+		{
+			const std::size_t tail = producer_.index.load(std::memory_order_relaxed);
+			if (tail - producer_.cached == capacity_)
+			{
+				producer_.cached = consumer_.index.load(std::memory_order_acquire);
+				if (tail - producer_.cached == capacity_)
+					return false;
+			}
+			slots_[tail & (capacity_ - 1)] = std::move(value);
+			producer_.index.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/*!
+		 * Moves the oldest element into value. Returns false if the queue is empty.
+		 * Must only be called from the consumer thread.
+		 */
+		bool try_pop(T& value)
+		{
+			const std::size_t head = consumer_.index.load(std::memory_order_relaxed);
+			if (head == consumer_.cached)
+			{
+				consumer_.cached = producer_.index.load(std::memory_order_acquire);
+				if (head == consumer_.cached)
+					return false;
+			}
+			value = std::move(slots_[head & (capacity_ - 1)]);
+			consumer_.index.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		/*!
+		 * Pushes value, yielding while the queue is full. Returns the number of times the push had to wait.
+		 */
+		std::size_t push(T value)
+		{
+			std::size_t stalls = 0;
+			while (!try_push(value))
+			{
+				++stalls;
+				std::this_thread::yield();
+			}
+			return stalls;
+		}
+
+		/*!
+		 * Returns the number of elements popped so far, so the producer side can tell whether the
+		 * consumer is still taking elements.
+		 */
+		std::size_t popped() const
+		{
+			return consumer_.index.load(std::memory_order_acquire);
+		}
+
+		/*!
+		 * Returns true if the queue was empty at some point during the call.
+		 */
+		bool empty() const
+		{
+			return consumer_.index.load(std::memory_order_acquire) == producer_.index.load(std::memory_order_acquire);
+		}
+
+	private:
+
+		struct alignas(detail::cache_line_size) side
+		{
+			std::atomic<std::size_t> index{ 0 };
+			std::size_t cached = 0;
+		};
+
+		std::size_t capacity_;
+		std::unique_ptr<T[]> slots_;
+		side producer_;
+		side consumer_;
+	};
+
+	/*!
+	 * A snapshot of the counters kept by a pipeline_stage.
+	 */
+	struct stage_statistics
+	{
+		std::uint64_t batches = 0;
+		std::uint64_t items = 0;
+		std::uint64_t stalls = 0;
+		std::uint64_t dropped = 0;
+		std::chrono::nanoseconds busy_time{ 0 };
+		std::chrono::nanoseconds max_latency{ 0 };
+
+		/*!
+		 * Returns the mean time spent processing one batch, including any time blocked on a full output queue.
+		 */
+		std::chrono::nanoseconds mean_latency() const
+		{
+			return batches == 0 ? std::chrono::nanoseconds{ 0 } : busy_time / static_cast<std::int64_t>(batches);
+		}
+
+		/*!
+		 * Returns the number of items processed per second of busy time.
+		 */
+		double throughput() const
+		{
+			return busy_time.count() == 0 ? 0.0 : static_cast<double>(items) * 1e9 / static_cast<double>(busy_time.count());
+		}
+	};
+
+	namespace detail
+	{
+		template<class Batch>
+		constexpr std::size_t batch_items(Batch const& batch)
+		{
+			if constexpr (requires { batch.size(); })
+				return batch.size();
+			else
+				return 1;
+		}
+	}
+
+	/*!
+	 * pipeline_stage runs Function on a worker thread, taking batches from an input queue and pushing the
+	 * results to an output queue. When the output queue is full the worker waits, which in turn lets the
+	 * input queue fill up and pushes back on the producer. Each stage keeps its own latency and throughput counters.
+	 *
+	 * Stopping a stage lets it drain its input queue first, so stopping the stages of a pipeline in order
+	 * (and joining each one before stopping the next) delivers every batch. Stopping never hangs on a
+	 * stage whose output nobody reads any more: see stop.
+	 *
+	 * @tparam Input The batch type read from the input queue.
+	 * @tparam Output The batch type written to the output queue. Function must be invocable as Output(Input&&).
+	 */
+	template<class Input, class Output, class Function>
+	requires std::is_invocable_r_v<Output, Function&, Input&&>
+	class pipeline_stage
+	{
+	public:
+
+		pipeline_stage(spsc_queue<Input>& input, spsc_queue<Output>& output, Function function = Function{})
+			: input_{ input }, output_{ output }, function_{ std::move(function) },
+			  worker_{ [this]() { run(); } }
+		{}
+
+		pipeline_stage(pipeline_stage const&) = delete;
+		pipeline_stage& operator=(pipeline_stage const&) = delete;
+
+		~pipeline_stage()
+		{
+			stop();
+		}
+
+		//! How long stop waits for a full output queue to move before giving up on it.
+		constexpr static const std::chrono::milliseconds default_patience{ 1000 };
+
+		/*!
+		 * Asks the worker to finish once its input queue is empty, and waits for it. If the worker is
+		 * blocked on a full output queue whose consumer takes nothing for patience (the next stage has
+		 * already stopped, say), the worker is told to give up: the batch it holds is dropped and counted in
+		 * stage_statistics::dropped, and whatever is still in the input queue is left there.
+		 */
+		void stop(std::chrono::nanoseconds patience = default_patience)
+		{
+			stopping_.store(true, std::memory_order_release);
+			std::size_t popped = output_.popped();
+			auto last_progress = std::chrono::steady_clock::now();
+			while (!finished_.load(std::memory_order_acquire))
+			{
+				const std::size_t now_popped = output_.popped();
+				const auto now = std::chrono::steady_clock::now();
+				if (now_popped != popped)
+				{
+					popped = now_popped;
+					last_progress = now;
+				}
+				else if (blocked_.load(std::memory_order_acquire) && now - last_progress >= patience)
+					abandon_.store(true, std::memory_order_release);
+				std::this_thread::yield();
+			}
+			if (worker_.joinable())
+				worker_.join();
+		}
+
+		stage_statistics statistics() const
+		{
+			stage_statistics result;
+			result.batches = batches_.load(std::memory_order_relaxed);
+			result.items = items_.load(std::memory_order_relaxed);
+			result.stalls = stalls_.load(std::memory_order_relaxed);
+			result.dropped = dropped_.load(std::memory_order_relaxed);
+			result.busy_time = std::chrono::nanoseconds{ busy_ns_.load(std::memory_order_relaxed) };
+			result.max_latency = std::chrono::nanoseconds{ max_latency_ns_.load(std::memory_order_relaxed) };
+			return result;
+		}
+
+	private:
+
+		void run()
+		{
+			Input batch;
+			while (true)
+			{
+				if (!input_.try_pop(batch))
+				{
+					if (stopping_.load(std::memory_order_acquire) && input_.empty())
+						break;
+					std::this_thread::yield();
+					continue;
+				}
+
+				const auto start = std::chrono::steady_clock::now();
+				const std::size_t items = detail::batch_items(batch);
+				Output result = std::invoke(function_, std::move(batch));
+				std::size_t stalls = 0;
+				bool pushed = output_.try_push(result);
+				while (!pushed && !abandon_.load(std::memory_order_acquire))
+				{
+					blocked_.store(true, std::memory_order_release);
+					++stalls;
+					std::this_thread::yield();
+					pushed = output_.try_push(result);
+				}
+				blocked_.store(false, std::memory_order_relaxed);
+				// Only a batch that was not pushed is dropped: stop may give up just before a consumer frees a slot.
+				if (!pushed)
+				{
+					dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+					break;
+				}
+				const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+				// Only this thread writes the counters, so plain load/store is enough.
+				batches_.store(batches_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				items_.store(items_.load(std::memory_order_relaxed) + items, std::memory_order_relaxed);
+				stalls_.store(stalls_.load(std::memory_order_relaxed) + stalls, std::memory_order_relaxed);
+				busy_ns_.store(busy_ns_.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+				if (elapsed > max_latency_ns_.load(std::memory_order_relaxed))
+					max_latency_ns_.store(elapsed, std::memory_order_relaxed);
+			}
+			finished_.store(true, std::memory_order_release);
+		}
+
+		spsc_queue<Input>& input_;
+		spsc_queue<Output>& output_;
+		Function function_;
+
+		std::atomic<bool> stopping_{ false };
+		std::atomic<bool> blocked_{ false };
+		std::atomic<bool> abandon_{ false };
+		std::atomic<bool> finished_{ false };
+		std::atomic<std::uint64_t> batches_{ 0 };
+		std::atomic<std::uint64_t> items_{ 0 };
+		std::atomic<std::uint64_t> stalls_{ 0 };
+		std::atomic<std::uint64_t> dropped_{ 0 };
+		std::atomic<std::int64_t> busy_ns_{ 0 };
+		std::atomic<std::int64_t> max_latency_ns_{ 0 };
+
+		// Declared last so the counters and queues exist before the worker starts.
+		std::thread worker_;
+	};
+}
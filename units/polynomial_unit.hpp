@@ -0,0 +1,567 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "units.hpp"
+#include "difference_unit.hpp"
+#include "detail/unit_comparisons.hpp"
+#include "compound_unit.hpp"
+#include "exponent_unit.hpp"
+#include "linear_unit.hpp"
+#include "quantity.hpp"
+#include "unit_conversion.hpp"
+#include "constant_quantity.hpp"
+
+namespace units
+{
+	namespace detail
+	{
+		/*!
+		 * a * b + c. Where the target has a fused multiply-add (FP_FAST_FMA and FP_FAST_FMAF), it is one
+		 * instruction rounding once; elsewhere it is a multiply and an add, since std::fma without hardware
+		 * support is a slow library call. Compile-time evaluation always multiplies and adds.
+		 */
+		template<class T>
+		constexpr T multiply_add(T a, T b, T c)
+		{
+#if defined(FP_FAST_FMA)
+			if constexpr (std::is_same_v<T, double>)
+			{
+				if (!std::is_constant_evaluated())
+					return std::fma(a, b, c);
+			}
+#endif
+#if defined(FP_FAST_FMAF)
+			if constexpr (std::is_same_v<T, float>)
+			{
+				if (!std::is_constant_evaluated())
+					return std::fma(a, b, c);
+			}
+#endif
+			return a * b + c;
+		}
+
+		/*!
+		 * UnitType^Power as a unit the comparison meta-functions understand. make_exponent_t of a compound unit,
+		 * or of a scaled compound unit such as millivolts, has a list as its unit_tag, which cannot go into
+		 * another compound_unit; so the power is distributed over the units of a compound, and the scale of a
+		 * scaled compound is moved onto its first unit.
+		 */
+		template<Unit UnitType, std::intmax_t Power>
+		struct unit_power
+		{
+			using type = std::conditional_t<Power == 1, UnitType, make_exponent_t<UnitType, Power>>;
+		};
+
+		template<Unit UnitType, std::intmax_t Power>
+		using unit_power_t = typename unit_power<UnitType, Power>::type;
+
+		template<Unit BaseUnit, class Exponent, std::intmax_t Power>
+		struct unit_power<exponent_unit<BaseUnit, Exponent>, Power>
+		{
+			using type = unit_power_t<BaseUnit, Exponent::value * Power>;
+		};
+
+		template<Unit... Units, std::intmax_t Power>
+		struct unit_power<compound_unit<Units...>, Power>
+		{
+			using type = compound_unit<unit_power_t<Units, Power>...>;
+		};
+
+		template<Unit First, Unit... Rest, class Ratio, std::intmax_t Power>
+		struct unit_power<scaled_unit<compound_unit<First, Rest...>, Ratio>, Power>
+		{
+			using type = unit_power_t<compound_unit<scaled_unit<First, Ratio>, Rest...>, Power>;
+		};
+	}
+
+	/*!
+	 * The natural unit of the coefficient of x^Power in a polynomial from InputUnit to OutputUnit: OutputUnit
+	 * itself for the constant term, and the difference unit of OutputUnit per InputUnit^Power for the others,
+	 * since only the constant term carries an offset (degrees celsius, not kelvin).
+	 */
+	template<Unit InputUnit, Unit OutputUnit, std::size_t Power>
+	using polynomial_coefficient_unit_t = std::conditional_t<Power == 0, OutputUnit,
+		make_compound_t<difference_unit_t<OutputUnit>, detail::unit_power_t<InputUnit, -static_cast<std::intmax_t>(Power == 0 ? 1 : Power)>>>;
+
+	/*!
+	 * polynomial is y = c0 + c1 x + c2 x^2 + ..., for a quantity x in InputUnit and y in OutputUnit, with
+	 * the coefficients as types: Coefficients are constant_quantity types, lowest power first. Every term
+	 * is checked at compile time: make_compound_t of the i-th coefficient's unit and InputUnit^i must be
+	 * SimilarUnits with OutputUnit. The coefficients are converted to OutputUnit per InputUnit^i once, at
+	 * compile time, so a coefficient given in kelvin per volt works with readings in millivolts.
+	 *
+	 * make_polynomial_t builds one from plain values in the natural units (polynomial_coefficient_unit_t).
+	 *
+	 * @tparam InputUnit The unit of x.
+	 * @tparam OutputUnit The unit of y. May have an offset; the constant term is converted as a quantity,
+	 * the others as deltas.
+	 * @tparam Coefficients constant_quantity types, c0 first.
+	 */
+	template<Unit InputUnit, Unit OutputUnit, class... Coefficients>
+	struct polynomial
+	{
+		static_assert(sizeof...(Coefficients) > 0, "A polynomial needs at least one coefficient");
+
+		using input_unit = InputUnit;
+		using output_unit = OutputUnit;
+		using value_type = typename OutputUnit::value_type;
+
+		constexpr static const std::size_t degree = sizeof...(Coefficients) - 1;
+
+	private:
+
+		template<std::size_t Power, class Coefficient>
+		constexpr static value_type convert_coefficient()
+		{
+			using coefficient_unit = typename Coefficient::unit_type;
+			if constexpr (Power == 0)
+			{
+				static_assert(SimilarUnits<coefficient_unit, OutputUnit>, "The constant term of a polynomial must be in a unit similar to the output unit");
+				return quantity<OutputUnit>{ quantity<coefficient_unit>{ Coefficient::value() } }.value();
+			}
+			else
+			{
+				using term_unit = make_compound_t<coefficient_unit, detail::unit_power_t<InputUnit, static_cast<std::intmax_t>(Power)>>;
+				static_assert(SimilarUnits<term_unit, OutputUnit>, "Each polynomial coefficient times the input unit to its power must be similar to the output unit");
+				return delta<OutputUnit>{ delta<term_unit>{ Coefficient::value() } }.value();
+			}
+		}
+
+		template<std::size_t... Power>
+		constexpr static std::array<value_type, sizeof...(Coefficients)> convert_coefficients(std::index_sequence<Power...>)
+		{
+			return { convert_coefficient<Power, Coefficients>()... };
+		}
+
+	public:
+
+		//! The coefficients in OutputUnit per InputUnit^i, c0 first.
+		constexpr static const std::array<value_type, sizeof...(Coefficients)> coefficients = convert_coefficients(std::index_sequence_for<Coefficients...>{});
+
+		//! y for x in InputUnit, by Horner's rule with multiply_add.
+		constexpr static value_type evaluate(value_type x)
+		{
+			value_type y = coefficients[degree];
+			for (std::size_t i = degree; i-- > 0;)
+				y = detail::multiply_add(y, x, coefficients[i]);
+			return y;
+		}
+
+		//! dy/dx for x in InputUnit.
+		constexpr static value_type derivative(value_type x)
+		{
+			value_type d{};
+			for (std::size_t i = degree; i > 0; --i)
+				d = detail::multiply_add(d, x, static_cast<value_type>(i) * coefficients[i]);
+			return d;
+		}
+	};
+
+	namespace detail
+	{
+		template<Unit InputUnit, Unit OutputUnit, class Indices, auto... Values>
+		struct make_polynomial;
+
+		template<Unit InputUnit, Unit OutputUnit, std::size_t... Power, auto... Values>
+		struct make_polynomial<InputUnit, OutputUnit, std::index_sequence<Power...>, Values...>
+		{
+			using type = polynomial<InputUnit, OutputUnit,
+				constant_quantity<polynomial_coefficient_unit_t<InputUnit, OutputUnit, Power>, static_cast<typename OutputUnit::value_type>(Values)>...>;
+		};
+	}
+
+	/*!
+	 * A polynomial from InputUnit to OutputUnit with the coefficients Values, c0 first, in the natural units
+	 * of each term (see polynomial_coefficient_unit_t). For published tables such as the NIST ITS-90
+	 * thermocouple polynomials.
+	 */
+	template<Unit InputUnit, Unit OutputUnit, auto... Values>
+	using make_polynomial_t = typename detail::make_polynomial<InputUnit, OutputUnit, std::make_index_sequence<sizeof...(Values)>, Values...>::type;
+
+	/*!
+	 * One piece of a piecewise_polynomial: Polynomial, valid for inputs in [Lower, Upper]. Lower and Upper
+	 * are constant_quantity types in a unit similar to the polynomial's input unit.
+	 */
+	template<class Polynomial, class Lower, class Upper>
+	struct polynomial_range
+	{
+		using polynomial_type = Polynomial;
+		using input_unit = typename Polynomial::input_unit;
+		using value_type = typename Polynomial::value_type;
+
+		static_assert(SimilarUnits<typename Lower::unit_type, input_unit> && SimilarUnits<typename Upper::unit_type, input_unit>,
+			"The bounds of a polynomial range must be in a unit similar to the input unit");
+
+		constexpr static const value_type lower = quantity<input_unit>{ quantity<typename Lower::unit_type>{ Lower::value() } }.value();
+		constexpr static const value_type upper = quantity<input_unit>{ quantity<typename Upper::unit_type>{ Upper::value() } }.value();
+
+		static_assert(lower < upper, "A polynomial range must not be empty");
+	};
+
+	/*!
+	 * piecewise_polynomial is a function made of polynomials on adjacent ranges of the input, as standard
+	 * sensor curves are published. Ranges are given in increasing order and each must start where the last
+	 * one ends. Inputs below the first range or above the last are extrapolated with the end polynomials;
+	 * use contains to check them.
+	 *
+	 * The coefficients of all pieces are padded to one degree and kept in a table, so an input selects its
+	 * piece with comparisons, not branches, and batches of inputs are evaluated by one loop.
+	 */
+	template<class... Ranges>
+	struct piecewise_polynomial
+	{
+		static_assert(sizeof...(Ranges) > 0, "A piecewise polynomial needs at least one range");
+
+		using first_range = std::tuple_element_t<0, std::tuple<Ranges...>>;
+		using input_unit = typename first_range::input_unit;
+		using output_unit = typename first_range::polynomial_type::output_unit;
+		using value_type = typename first_range::value_type;
+
+		static_assert((std::is_same_v<typename Ranges::input_unit, input_unit> && ...), "Every range must have the same input unit");
+		static_assert((std::is_same_v<typename Ranges::polynomial_type::output_unit, output_unit> && ...), "Every range must have the same output unit");
+
+		constexpr static const std::size_t pieces = sizeof...(Ranges);
+		constexpr static const std::size_t degree = std::max({ Ranges::polynomial_type::degree... });
+
+		constexpr static const value_type lower = first_range::lower;
+		constexpr static const value_type upper = std::tuple_element_t<pieces - 1, std::tuple<Ranges...>>::upper;
+
+	private:
+
+		constexpr static std::array<value_type, pieces> range_bounds(bool upper_bounds)
+		{
+			return { (upper_bounds ? Ranges::upper : Ranges::lower)... };
+		}
+
+		constexpr static bool contiguous()
+		{
+			constexpr std::array<value_type, pieces> lowers = range_bounds(false);
+			constexpr std::array<value_type, pieces> uppers = range_bounds(true);
+			for (std::size_t i = 1; i < pieces; ++i)
+			{
+				if (lowers[i] != uppers[i - 1])
+					return false;
+			}
+			return true;
+		}
+
+		static_assert(contiguous(), "Each polynomial range must start where the previous one ends");
+
+		template<class Range>
+		constexpr static std::array<value_type, degree + 1> padded()
+		{
+			std::array<value_type, degree + 1> result{};
+			for (std::size_t i = 0; i < Range::polynomial_type::coefficients.size(); ++i)
+				result[i] = Range::polynomial_type::coefficients[i];
+			return result;
+		}
+
+	public:
+
+		//! The upper bound of each piece, in InputUnit.
+		constexpr static const std::array<value_type, pieces> bounds = range_bounds(true);
+
+		//! The coefficients of each piece, c0 first, padded with zeros to degree.
+		constexpr static const std::array<std::array<value_type, degree + 1>, pieces> coefficients{ padded<Ranges>()... };
+
+		//! The piece x is evaluated with: the first whose upper bound is not below x, or the last.
+		constexpr static std::size_t piece(value_type x)
+		{
+			std::size_t index = 0;
+			for (std::size_t i = 0; i + 1 < pieces; ++i)
+				index += x > bounds[i] ? 1 : 0;
+			return index;
+		}
+
+		constexpr static bool contains(value_type x)
+		{
+			return x >= lower && x <= upper;
+		}
+
+		constexpr static value_type evaluate(value_type x)
+		{
+			std::array<value_type, degree + 1> const& c = coefficients[piece(x)];
+			value_type y = c[degree];
+			for (std::size_t i = degree; i-- > 0;)
+				y = detail::multiply_add(y, x, c[i]);
+			return y;
+		}
+
+		constexpr static value_type derivative(value_type x)
+		{
+			std::array<value_type, degree + 1> const& c = coefficients[piece(x)];
+			value_type d{};
+			for (std::size_t i = degree; i > 0; --i)
+				d = detail::multiply_add(d, x, static_cast<value_type>(i) * c[i]);
+			return d;
+		}
+	};
+
+	namespace detail
+	{
+		template<class Function>
+		concept PolynomialFunction = requires(typename Function::value_type x)
+		{
+			typename Function::input_unit;
+			typename Function::output_unit;
+			{ Function::evaluate(x) } -> std::same_as<typename Function::value_type>;
+			{ Function::derivative(x) } -> std::same_as<typename Function::value_type>;
+		};
+
+		template<class Function>
+		constexpr bool has_range()
+		{
+			return requires { Function::lower; Function::upper; };
+		}
+
+		/*!
+		 * The x with Function::evaluate(x) == y, by Newton's method from a linear estimate: the chord of the
+		 * whole range for a piecewise_polynomial, the linear term for a polynomial. Function must be monotonic
+		 * there; sensor curves are. Iterates until the step is below a few ulps of x, at most 16 times.
+		 */
+		template<PolynomialFunction Function>
+		constexpr typename Function::value_type solve_polynomial(typename Function::value_type y)
+		{
+			using value_type = typename Function::value_type;
+			value_type x{};
+			if constexpr (has_range<Function>())
+			{
+				const value_type y_lower = Function::evaluate(Function::lower);
+				const value_type y_upper = Function::evaluate(Function::upper);
+				x = Function::lower + (y - y_lower) * (Function::upper - Function::lower) / (y_upper - y_lower);
+			}
+			else
+				x = (y - Function::evaluate(value_type{})) / Function::derivative(value_type{});
+
+			for (int i = 0; i < 16; ++i)
+			{
+				const value_type step = (Function::evaluate(x) - y) / Function::derivative(x);
+				x -= step;
+				const value_type magnitude = x < value_type{} ? -x : x;
+				if (!(step * step > value_type{ 16 } * std::numeric_limits<value_type>::epsilon() * std::numeric_limits<value_type>::epsilon() * magnitude * magnitude))
+					break;
+			}
+			return x;
+		}
+
+		template<class Inverse, class Forward>
+		constexpr bool inverts()
+		{
+			if constexpr (std::is_void_v<Inverse>)
+				return true;
+			else
+				return std::is_same_v<typename Inverse::input_unit, typename Forward::output_unit> && std::is_same_v<typename Inverse::output_unit, typename Forward::input_unit>;
+		}
+
+		//! coefficients (c0 first) of a curve to From, as coefficients of the same curve to To.
+		template<Unit From, Unit To, class T, std::size_t N>
+		constexpr std::array<T, N> convert_polynomial(std::array<T, N> coefficients)
+		{
+			constexpr affine_coefficients c = affine_conversion<From, To>();
+			for (T& coefficient : coefficients)
+				coefficient = static_cast<T>(coefficient * c.scale);
+			coefficients[0] = static_cast<T>(coefficients[0] + c.offset);
+			return coefficients;
+		}
+
+		template<Unit From, Unit To, class T, std::size_t N, std::size_t Pieces>
+		constexpr std::array<std::array<T, N>, Pieces> convert_polynomial(std::array<std::array<T, N>, Pieces> pieces)
+		{
+			for (std::array<T, N>& piece : pieces)
+				piece = convert_polynomial<From, To>(piece);
+			return pieces;
+		}
+	}
+
+	/*!
+	 * polynomial_unit is a unit whose values are sensor readings, converted to OutputUnit by a standard
+	 * non-linear curve: a polynomial or piecewise_polynomial from the reading to the measured quantity.
+	 * A type K thermocouple is
+	 * @code
+	 * using type_k = polynomial_unit<type_k_millivolts_to_celsius>;
+	 * quantity<si::kelvin> t{ quantity<type_k>{ 4.096 } }; // 373.11 K, 100 celsius to within the curve accuracy
+	 * @endcode
+	 * so a reading is a temperature as far as the type system goes: it converts to any similar unit, and
+	 * quantities of other similar units convert to readings. That direction uses Inverse, a curve from
+	 * OutputUnit back to the reading, if one is published, and otherwise solves Forward by Newton's method.
+	 *
+	 * The difference of two readings is a difference of readings (millivolts), not of the output: the curve
+	 * is not linear, so it is only SimilarUnits with other differences of the same polynomial_unit.
+	 *
+	 * @tparam Forward A polynomial or piecewise_polynomial from the reading unit to the output unit.
+	 * @tparam Inverse A polynomial or piecewise_polynomial from the output unit to the reading unit, or void.
+	 */
+	template<detail::PolynomialFunction Forward, class Inverse = void>
+	struct polynomial_unit
+	{
+		using forward_type = Forward;
+		using inverse_type = Inverse;
+		using input_unit = typename Forward::input_unit;
+		using base_unit = typename Forward::output_unit;
+		using value_type = typename base_unit::value_type;
+		using unit_tag = typename base_unit::unit_tag;
+
+		static_assert(detail::inverts<Inverse, Forward>(), "The inverse curve must map the output unit back to the input unit");
+
+		//! Returns the quantity in the output unit for a reading.
+		constexpr static value_type to_output(value_type reading)
+		{
+			return Forward::evaluate(reading);
+		}
+
+		//! Returns the reading for a quantity in the output unit.
+		constexpr static value_type from_output(value_type value)
+		{
+			if constexpr (std::is_void_v<Inverse>)
+				return detail::solve_polynomial<Forward>(value);
+			else
+				return Inverse::evaluate(value);
+		}
+
+		constexpr static value_type to_fundamental(value_type reading)
+		{
+			return base_unit::to_fundamental(to_output(reading));
+		}
+
+		constexpr static value_type from_fundamental(value_type value)
+		{
+			return from_output(base_unit::from_fundamental(value));
+		}
+	};
+
+	/*!
+	 * Specialization of difference_unit for polynomial_unit: differences of readings are in the reading unit.
+	 */
+	template<class Forward, class Inverse>
+	struct difference_unit<polynomial_unit<Forward, Inverse>>
+	{
+		using type = difference_unit_t<typename Forward::input_unit>;
+	};
+
+	/*!
+	 * Specialization of exponent_of. A reading has the exponent of the quantity it measures.
+	 */
+	template<class Forward, class Inverse>
+	struct exponent_of<polynomial_unit<Forward, Inverse>> : exponent_of<typename Forward::output_unit> {};
+
+	/*!
+	 * Specializations of compare_tag and compare_exponent. A reading compares as the unit it is converted
+	 * to, as logarithmic_unit does, so it is SimilarUnits with it even when that is a compound_unit.
+	 */
+	template<class Forward, class Inverse, Unit Other>
+	struct compare_tag<polynomial_unit<Forward, Inverse>, Other> : compare_tag<typename Forward::output_unit, Other> {};
+
+	template<Unit Other, class Forward, class Inverse>
+	struct compare_tag<Other, polynomial_unit<Forward, Inverse>> : compare_tag<Other, typename Forward::output_unit> {};
+
+	template<class ForwardA, class InverseA, class ForwardB, class InverseB>
+	struct compare_tag<polynomial_unit<ForwardA, InverseA>, polynomial_unit<ForwardB, InverseB>> : compare_tag<typename ForwardA::output_unit, typename ForwardB::output_unit> {};
+
+	template<class Forward, class Inverse, Unit... Compound>
+	struct compare_tag<polynomial_unit<Forward, Inverse>, compound_unit<Compound...>> : compare_tag<typename Forward::output_unit, compound_unit<Compound...>> {};
+
+	template<Unit... Compound, class Forward, class Inverse>
+	struct compare_tag<compound_unit<Compound...>, polynomial_unit<Forward, Inverse>> : compare_tag<compound_unit<Compound...>, typename Forward::output_unit> {};
+
+	template<class Forward, class Inverse, Unit Other>
+	struct compare_exponent<polynomial_unit<Forward, Inverse>, Other> : compare_exponent<typename Forward::output_unit, Other> {};
+
+	template<Unit Other, class Forward, class Inverse>
+	struct compare_exponent<Other, polynomial_unit<Forward, Inverse>> : compare_exponent<Other, typename Forward::output_unit> {};
+
+	template<class ForwardA, class InverseA, class ForwardB, class InverseB>
+	struct compare_exponent<polynomial_unit<ForwardA, InverseA>, polynomial_unit<ForwardB, InverseB>> : compare_exponent<typename ForwardA::output_unit, typename ForwardB::output_unit> {};
+
+	template<class Forward, class Inverse, Unit... Compound>
+	struct compare_exponent<polynomial_unit<Forward, Inverse>, compound_unit<Compound...>> : compare_exponent<typename Forward::output_unit, compound_unit<Compound...>> {};
+
+	template<Unit... Compound, class Forward, class Inverse>
+	struct compare_exponent<compound_unit<Compound...>, polynomial_unit<Forward, Inverse>> : compare_exponent<compound_unit<Compound...>, typename Forward::output_unit> {};
+
+	namespace detail
+	{
+		/*!
+		 * The loop behind evaluate and evaluate_checked. Returns false if a reading was outside the range of a
+		 * piecewise curve; every reading is converted either way.
+		 */
+		template<class Forward, class Inverse, Unit To>
+		bool evaluate_polynomial(std::span<const quantity<polynomial_unit<Forward, Inverse>>> readings, std::span<quantity<To>> out)
+		{
+			if (readings.size() != out.size())
+				throw std::invalid_argument("evaluate spans must have the same length");
+			using value_type = typename Forward::value_type;
+			using output_type = typename To::value_type;
+			constexpr std::size_t degree = Forward::degree;
+			constexpr auto coefficients = convert_polynomial<typename Forward::output_unit, To>(Forward::coefficients);
+
+			if constexpr (requires { Forward::pieces; })
+			{
+				bool in_range = true;
+				for (std::size_t i = 0; i < readings.size(); ++i)
+				{
+					const value_type x = readings[i].value();
+					in_range &= Forward::contains(x);
+					auto const& p = coefficients[Forward::piece(x)];
+					value_type y = p[degree];
+					for (std::size_t k = degree; k-- > 0;)
+						y = multiply_add(y, x, p[k]);
+					out[i] = quantity<To>{ static_cast<output_type>(y) };
+				}
+				return in_range;
+			}
+			else
+			{
+				for (std::size_t i = 0; i < readings.size(); ++i)
+				{
+					const value_type x = readings[i].value();
+					value_type y = coefficients[degree];
+					for (std::size_t k = degree; k-- > 0;)
+						y = multiply_add(y, x, coefficients[k]);
+					out[i] = quantity<To>{ static_cast<output_type>(y) };
+				}
+				return true;
+			}
+		}
+	}
+
+	/*!
+	 * Converts a batch of readings to To. The conversion from the curve's output unit to To is folded into
+	 * the coefficients at compile time (celsius to kelvin adds 273.15 to c0), so each reading costs one
+	 * Horner evaluation with fused multiply-adds and a table lookup for its piece, in a loop without
+	 * branches that vectorises. Readings outside the curve's range are extrapolated with the end pieces,
+	 * exactly as the scalar conversion quantity<To>{ reading } does; use evaluate_checked to reject them.
+	 *
+	 * @throws std::invalid_argument If the spans have different lengths.
+	 */
+	template<class Forward, class Inverse, Unit To>
+	requires SimilarUnits<typename Forward::output_unit, To> && std::is_floating_point_v<typename To::value_type>
+	void evaluate(std::span<const quantity<polynomial_unit<Forward, Inverse>>> readings, std::span<quantity<To>> out)
+	{
+		detail::evaluate_polynomial(readings, out);
+	}
+
+	/*!
+	 * evaluate, for callers that treat readings outside the published range of the curve as faults (an open
+	 * or shorted sensor). The out-of-range readings are reported once the whole batch has been written.
+	 *
+	 * @throws std::invalid_argument If the spans have different lengths.
+	 * @throws std::out_of_range If a reading is outside the range of a piecewise curve; out is still filled.
+	 */
+	template<class Forward, class Inverse, Unit To>
+	requires SimilarUnits<typename Forward::output_unit, To> && std::is_floating_point_v<typename To::value_type>
+	void evaluate_checked(std::span<const quantity<polynomial_unit<Forward, Inverse>>> readings, std::span<quantity<To>> out)
+	{
+		if (!detail::evaluate_polynomial(readings, out))
+			throw std::out_of_range("polynomial reading outside the range of its curve");
+	}
+}
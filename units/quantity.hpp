@@ -1,5 +1,10 @@
 #pragma once
 
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <type_traits>
 #include "units.hpp"
 #include "detail/unit_comparisons.hpp"
 #include "unit_conversion.hpp"
@@ -9,6 +14,42 @@
 
 namespace units
 {
+	namespace detail
+	{
+		/*!
+		 * True if every value of From is exactly representable in To. For arithmetic types this compares
+		 * the digits and range of the types: int32 -> double is lossless, int64 -> double and double -> float
+		 * are not. Other value types (checked, simd_pack) are trusted to define their own conversions.
+		 */
+		template<class From, class To>
+		constexpr bool lossless_value_conversion()
+		{
+			if constexpr (std::is_same_v<From, To>)
+				return true;
+			else if constexpr (std::is_arithmetic_v<From> && std::is_arithmetic_v<To>)
+			{
+				using from = std::numeric_limits<From>;
+				using to = std::numeric_limits<To>;
+				if constexpr (std::is_floating_point_v<To>)
+					return from::digits <= to::digits && (std::is_integral_v<From> || from::max_exponent <= to::max_exponent);
+				else if constexpr (std::is_integral_v<From>)
+					return from::digits <= to::digits && (std::is_unsigned_v<From> || std::is_signed_v<To>);
+				else
+					return false;
+			}
+			else
+				return std::is_convertible_v<From, To>;
+		}
+	}
+
+	/*!
+	 * Concept for units whose deltas convert to each other: the units are similar and so are their
+	 * difference units. A level and its base unit are similar, but a gain is not a power, so
+	 * quantity<dBm> + delta<watt> is rejected here rather than failing inside the conversion.
+	 */
+	template<class A, class B>
+	concept SimilarDifferences = SimilarUnits<A, B> && SimilarUnits<difference_unit_t<A>, difference_unit_t<B>>;
+
 	/*!
 	 * A quantity represents an absolute amount of a unit of the specified type.
 	 * The numeric value is stored in type UnitType::value_type.
@@ -36,19 +77,32 @@ namespace units
 		/*!
 		 * Copy/conversion constructor. This will automatically convert
 		 * quantities of SimilarUnits to this unit type and store the value.
+		 * The conversion is computed in the common value_type of the two units.
+		 *
+		 * The constructor is implicit when every value of the other value_type is exactly representable
+		 * in this one (see detail::lossless_value_conversion): the same type, double <- float,
+		 * double <- int32 or int64 <- int32. It is explicit when the value may be rounded or truncated,
+		 * as in float <- double, double <- int64 or int32 <- double, so those are written
+		 * quantity<unit>{ other }.
 		 * 
 		 * @tparam unit The Unit type of the other quantity. Must satisfy SimilarUnit<UnitType, unit>.
 		 * @param other The other quantity. The value will be converted to this unit type automatically
 		 */
 		template<Unit unit>
-		constexpr quantity(quantity<unit> other) requires SimilarUnits<UnitType, unit>
-			: value_{ unit_conversion<unit, UnitType>::convert(other.value()) }
+		constexpr explicit(!detail::lossless_value_conversion<typename unit::value_type, value_type>())
+		quantity(quantity<unit> other) requires SimilarUnits<UnitType, unit>
+			: value_{ static_cast<value_type>(unit_conversion<unit, UnitType>::convert(other.value())) }
 		{}
 
+		/*!
+		 * Converting assignment, available for the same value_type conversions as the implicit constructor.
+		 * Assigning from a quantity whose value may be rounded or truncated takes an explicit construction,
+		 * q = quantity<unit>{ other }.
+		 */
 		template<Unit unit>
-		constexpr quantity& operator=(quantity<unit> const& other) requires SimilarUnits<UnitType, unit>
+		constexpr quantity& operator=(quantity<unit> const& other) requires SimilarUnits<UnitType, unit> && (detail::lossless_value_conversion<typename unit::value_type, value_type>())
 		{
-			value_ = unit_conversion<unit, UnitType>::convert(other.value());
+			value_ = static_cast<value_type>(unit_conversion<unit, UnitType>::convert(other.value()));
 			return *this;
 		}
 
@@ -94,9 +148,9 @@ namespace units
 		 * @param other The other quantity. The value will be converted to this unit type automatically
 		 */
 		template<Unit Other>
-		requires SimilarUnits<UnitType, Other>
-			constexpr delta(delta<Other> other)
-			: value_{ unit_conversion<typename delta<Other>::unit_type, unit_type>::convert(other.value()) }
+		requires SimilarDifferences<UnitType, Other>
+			constexpr explicit(!detail::lossless_value_conversion<typename Other::value_type, value_type>()) delta(delta<Other> other)
+			: value_{ static_cast<value_type>(unit_conversion<typename delta<Other>::unit_type, unit_type>::convert(other.value())) }
 		{}
 
 		/*!
@@ -107,7 +161,7 @@ namespace units
 		/*!
 		 * Negation operator, returns a delta with the sign of the value flipped.
 		 */
-		constexpr delta<UnitType> operator-() const { return delta<UnitType>{-value_}; }
+		constexpr delta<UnitType> operator-() const { return delta<UnitType>{ static_cast<value_type>(-value_) }; }
 
 	private:
 
@@ -115,70 +169,223 @@ namespace units
 	};
 
 	template<Unit A, Unit B>
-	constexpr inline delta<A> operator+(delta<A> a, delta<B> b) requires SimilarUnits<A, B>
+	constexpr inline delta<A> operator+(delta<A> a, delta<B> b) requires SimilarDifferences<A, B>
 	{
-		return delta<A>{a.value() + delta<A>{b}.value()};
+		return delta<A>{ static_cast<typename A::value_type>(a.value() + delta<A>{b}.value()) };
 	}
 
 	template<Unit A, Unit B>
-	constexpr inline delta<A> operator-(delta<A> a, delta<B> b) requires SimilarUnits<A, B>
+	constexpr inline delta<A> operator-(delta<A> a, delta<B> b) requires SimilarDifferences<A, B>
 	{
-		return delta<A>{a.value() - delta<A>{b}.value()};
+		return delta<A>{ static_cast<typename A::value_type>(a.value() - delta<A>{b}.value()) };
 	}
 
 	template<Unit A, Unit B>
-	constexpr inline quantity<A> operator+(quantity<A> a, delta<B> b) requires SimilarUnits<A, B>
+	constexpr inline quantity<A> operator+(quantity<A> a, delta<B> b) requires SimilarDifferences<A, B>
 	{
-		return quantity<A>{a.value() + delta<A>{b}.value()};
+		return quantity<A>{ static_cast<typename A::value_type>(a.value() + delta<A>{b}.value()) };
 	}
 
 	template<Unit A, Unit B>
-	constexpr inline quantity<B> operator+(delta<A> a, quantity<B> b) requires SimilarUnits<A, B>
+	constexpr inline quantity<B> operator+(delta<A> a, quantity<B> b) requires SimilarDifferences<A, B>
 	{
-		return quantity<B>{b.value() + delta<B>{a}.value()};
+		return quantity<B>{ static_cast<typename B::value_type>(b.value() + delta<B>{a}.value()) };
 	}
 
 	template<Unit A, Unit B>
-	constexpr inline quantity<A> operator-(quantity<A> a, delta<B> b) requires SimilarUnits<A, B>
+	constexpr inline quantity<A> operator-(quantity<A> a, delta<B> b) requires SimilarDifferences<A, B>
 	{
-		return quantity<A>{a.value() - delta<A>{b}.value()};
+		return quantity<A>{ static_cast<typename A::value_type>(a.value() - delta<A>{b}.value()) };
 	}
 
 	template<Unit A, Unit B>
 	constexpr inline delta<A> operator-(quantity<A> a, quantity<B> b) requires SimilarUnits<A, B>
 	{
-		return delta<A>{a.value() - quantity<A>{b}.value()};
+		return delta<A>{ static_cast<typename A::value_type>(a.value() - quantity<A>{b}.value()) };
 	}
 
 	template<Unit A, Unit B>
 	constexpr inline quantity<make_compound_t<A, B>> operator*(quantity<A> a, quantity<B> b)
 	{
-		return quantity<make_compound_t<A, B>>{a.value() * b.value()};
+		return quantity<make_compound_t<A, B>>{ static_cast<typename make_compound_t<A, B>::value_type>(a.value() * b.value()) };
 	}
 
 	template<Unit A, Unit B>
 	constexpr inline delta<make_compound_t<A, B>> operator*(delta<A> a, delta<B> b)
 	{
-		return delta<make_compound_t<A, B>>{a.value() * b.value()};
+		return delta<make_compound_t<A, B>>{ static_cast<typename make_compound_t<A, B>::value_type>(a.value() * b.value()) };
 	}
 
 	template<Unit A, Unit B>
 	constexpr inline delta<make_compound_t<A, B>> operator*(quantity<A> a, delta<B> b)
 	{
-		return delta<make_compound_t<A, B>>{a.value() * b.value()};
+		return delta<make_compound_t<A, B>>{ static_cast<typename make_compound_t<A, B>::value_type>(a.value() * b.value()) };
 	}
 
 	template<Unit A, Unit B>
 	constexpr inline delta<make_compound_t<A, B>> operator*(delta<A> a, quantity<B> b)
 	{
-		return delta<make_compound_t<A, B>>{a.value() * b.value()};
+		return delta<make_compound_t<A, B>>{ static_cast<typename make_compound_t<A, B>::value_type>(a.value() * b.value()) };
+	}
+
+	template<Unit A, Unit B>
+	constexpr inline quantity<make_compound_t<A, inverse_unit<B>>> operator/(quantity<A> a, quantity<B> b)
+	{
+		return quantity<make_compound_t<A, inverse_unit<B>>>{ static_cast<typename make_compound_t<A, inverse_unit<B>>::value_type>(a.value() / b.value()) };
+	}
+
+	namespace detail
+	{
+		template<class T>
+		struct is_quantity_or_delta : std::false_type {};
+
+		template<Unit UnitType>
+		struct is_quantity_or_delta<quantity<UnitType>> : std::true_type {};
+
+		template<Unit UnitType>
+		struct is_quantity_or_delta<delta<UnitType>> : std::true_type {};
+
+		/*!
+		 * QuantityOrDelta concept. Satisfied by quantity<U> and delta<U>, ignoring const.
+		 */
+		template<class T>
+		concept QuantityOrDelta = is_quantity_or_delta<std::remove_cv_t<T>>::value;
+
+		/*!
+		 * a * scale, if it does not overflow T.
+		 */
+		template<class T>
+		constexpr bool checked_scale(T a, T scale, T& result)
+		{
+			if (a > std::numeric_limits<T>::max() / scale)
+				return false;
+			if constexpr (std::is_signed_v<T>)
+			{
+				if (a < std::numeric_limits<T>::min() / scale)
+					return false;
+			}
+			result = a * scale;
+			return true;
+		}
+
+		/*!
+		 * a / n <=> b / d for integers, with n and d positive, without overflow: the integer parts are
+		 * compared first, then the remainders by comparing the reciprocals, as in Euclid's algorithm.
+		 */
+		template<class T>
+		constexpr std::strong_ordering compare_fractions(T a, T n, T b, T d)
+		{
+			const auto floor_divide = [](T x, T y, T& remainder)
+			{
+				T quotient = x / y;
+				remainder = x % y;
+				if constexpr (std::is_signed_v<T>)
+				{
+					if (remainder < 0)
+					{
+						remainder += y;
+						--quotient;
+					}
+				}
+				return quotient;
+			};
+			T ra{}, rb{};
+			const T qa = floor_divide(a, n, ra);
+			const T qb = floor_divide(b, d, rb);
+			if (qa != qb)
+				return qa <=> qb;
+
+			// ra / n <=> rb / d, with 0 <= ra < n and 0 <= rb < d.
+			bool flipped = false;
+			for (;;)
+			{
+				if (ra == 0 || rb == 0)
+				{
+					const std::strong_ordering order = (ra != 0) <=> (rb != 0);
+					return flipped ? 0 <=> order : order;
+				}
+				// Both are in (0, 1), so compare n / ra <=> d / rb the other way round.
+				T na{}, nb{};
+				const T ia = floor_divide(n, ra, na);
+				const T ib = floor_divide(d, rb, nb);
+				flipped = !flipped;
+				if (ia != ib)
+					return flipped ? ib <=> ia : ia <=> ib;
+				n = ra;
+				d = rb;
+				ra = na;
+				rb = nb;
+			}
+		}
+
+		/*!
+		 * Three-way comparison of a value in unit A with a value in unit B. Only one side is scaled:
+		 * if the ratio between the units is exact and the values are integers, the comparison is done
+		 * by multiplying whichever side needs it, so it never rounds. If a product would overflow,
+		 * the values are compared as fractions instead (see compare_fractions). Otherwise b is converted to A.
+		 */
+		template<Unit A, Unit B>
+		constexpr auto compare_values(typename A::value_type a, typename B::value_type b)
+		{
+			using conversion = unit_conversion<B, A>;
+			using value_type = typename conversion::value_type;
+			constexpr detail::scale_factor factor = conversion::factor;
+
+			if constexpr (factor.exact && std::is_integral_v<value_type>)
+			{
+				if constexpr (factor.num == 1 && factor.den == 1)
+					return static_cast<value_type>(a) <=> static_cast<value_type>(b);
+				else
+				{
+					constexpr value_type num = static_cast<value_type>(factor.num);
+					constexpr value_type den = static_cast<value_type>(factor.den);
+					value_type scaled_a{}, scaled_b{};
+					if (checked_scale(static_cast<value_type>(a), den, scaled_a) && checked_scale(static_cast<value_type>(b), num, scaled_b))
+						return scaled_a <=> scaled_b;
+					return compare_fractions(static_cast<value_type>(a), num, static_cast<value_type>(b), den);
+				}
+			}
+			else
+				return static_cast<value_type>(a) <=> conversion::convert(b);
+		}
+
+		/*!
+		 * Returns true if a in unit A equals b in unit B. Value types without <=> (simd_pack) are
+		 * compared with their own ==, after converting b to A.
+		 */
+		template<Unit A, Unit B>
+		constexpr bool equal_values(typename A::value_type a, typename B::value_type b)
+		{
+			using conversion = unit_conversion<B, A>;
+			if constexpr (std::three_way_comparable<typename conversion::value_type>)
+				return compare_values<A, B>(a, b) == 0;
+			else
+				return static_cast<typename conversion::value_type>(a) == conversion::convert(b);
+		}
+	}
+
+	template<Unit A, Unit B>
+	constexpr inline bool operator==(quantity<A> a, quantity<B> b) requires SimilarUnits<A, B>
+	{
+		return detail::equal_values<A, B>(a.value(), b.value());
 	}
 
 	template<Unit A, Unit B>
-	constexpr inline auto operator/(quantity<A> a, quantity<B> b)
-		-> decltype(a * std::declval<quantity<inverse_unit<B>>>())
+	constexpr inline auto operator<=>(quantity<A> a, quantity<B> b) requires SimilarUnits<A, B> && std::three_way_comparable<typename unit_conversion<B, A>::value_type>
 	{
-		return a * quantity<inverse_unit<B>>{typename B::value_type{ 1 } / b.value()};
+		return detail::compare_values<A, B>(a.value(), b.value());
+	}
+
+	template<Unit A, Unit B>
+	constexpr inline bool operator==(delta<A> a, delta<B> b) requires SimilarDifferences<A, B>
+	{
+		return detail::equal_values<typename delta<A>::unit_type, typename delta<B>::unit_type>(a.value(), b.value());
+	}
+
+	template<Unit A, Unit B>
+	constexpr inline auto operator<=>(delta<A> a, delta<B> b) requires SimilarDifferences<A, B> && std::three_way_comparable<typename unit_conversion<typename delta<B>::unit_type, typename delta<A>::unit_type>::value_type>
+	{
+		return detail::compare_values<typename delta<A>::unit_type, typename delta<B>::unit_type>(a.value(), b.value());
 	}
 
 	template<Unit A, Unit B>
@@ -192,4 +399,28 @@ namespace units
 
 	template<Unit unit>
 	inline quantity<inverse_unit<unit>> operator/(typename unit::value_type value, unit) { return quantity<inverse_unit<unit>>{value}; }
-}
\ No newline at end of file
+}
+
+/*!
+ * std::hash specializations for quantity and delta. The hash is that of the stored value, with -0
+ * hashed as +0, so it is consistent with operator== for a single unit type.
+ */
+template<units::Unit UnitType>
+struct std::hash<units::quantity<UnitType>>
+{
+	std::size_t operator()(units::quantity<UnitType> const& value) const noexcept
+	{
+		using value_type = typename UnitType::value_type;
+		return std::hash<value_type>{}(value.value() == value_type{} ? value_type{} : value.value());
+	}
+};
+
+template<units::Unit UnitType>
+struct std::hash<units::delta<UnitType>>
+{
+	std::size_t operator()(units::delta<UnitType> const& value) const noexcept
+	{
+		using value_type = typename UnitType::value_type;
+		return std::hash<value_type>{}(value.value() == value_type{} ? value_type{} : value.value());
+	}
+};
\ No newline at end of file
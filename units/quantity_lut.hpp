@@ -0,0 +1,290 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "unit_conversion.hpp"
+
+namespace units
+{
+	/*!
+	 * An axis of N evenly spaced breakpoints, start, start + step, ... Locating a value is a multiply by the
+	 * precomputed inverse of the step, with no search.
+	 *
+	 * @tparam UnitType The unit of the breakpoints. Its value_type must be floating point.
+	 * @tparam N The number of breakpoints. Must be at least 2.
+	 */
+	template<Unit UnitType, std::size_t N>
+	requires std::is_floating_point_v<typename UnitType::value_type> && (N >= 2)
+	class uniform_axis
+	{
+	public:
+
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+
+		constexpr static const std::size_t size = N;
+
+		/*!
+		 * @throws std::invalid_argument If step is not positive.
+		 */
+		constexpr uniform_axis(quantity<UnitType> start, delta<UnitType> step)
+			: start_{ start.value() },
+			  step_{ step.value() },
+			  inverse_step_{ value_type{ 1 } / step.value() }
+		{
+			if (!(step.value() > value_type{}))
+				throw std::invalid_argument("uniform_axis step must be positive");
+		}
+
+		constexpr quantity<UnitType> operator[](std::size_t i) const { return quantity<UnitType>{ start_ + static_cast<value_type>(i) * step_ }; }
+
+		/*!
+		 * Returns the fractional breakpoint index of a value given in another unit, with the unit conversion
+		 * folded in: value * coefficients.scale + coefficients.offset is the value in UnitType. The result is not clamped.
+		 */
+		constexpr value_type position(value_type value, detail::affine_coefficients coefficients) const
+		{
+			const value_type a = static_cast<value_type>(coefficients.scale) * inverse_step_;
+			const value_type b = (static_cast<value_type>(coefficients.offset) - start_) * inverse_step_;
+			return value * a + b;
+		}
+
+	private:
+
+		value_type start_;
+		value_type step_;
+		value_type inverse_step_;
+	};
+
+	/*!
+	 * An axis of N breakpoints at arbitrary, strictly increasing positions. Locating a value is a binary search.
+	 *
+	 * @tparam UnitType The unit of the breakpoints. Its value_type must be floating point.
+	 * @tparam N The number of breakpoints. Must be at least 2.
+	 */
+	template<Unit UnitType, std::size_t N>
+	requires std::is_floating_point_v<typename UnitType::value_type> && (N >= 2)
+	class grid_axis
+	{
+	public:
+
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+
+		constexpr static const std::size_t size = N;
+
+		/*!
+		 * @throws std::invalid_argument If the breakpoints are not strictly increasing.
+		 */
+		constexpr explicit grid_axis(std::array<value_type, N> const& breakpoints)
+			: breakpoints_{ breakpoints }
+		{
+			for (std::size_t i = 1; i < N; ++i)
+				if (!(breakpoints_[i - 1] < breakpoints_[i]))
+					throw std::invalid_argument("grid_axis breakpoints must be strictly increasing");
+		}
+
+		constexpr quantity<UnitType> operator[](std::size_t i) const { return quantity<UnitType>{ breakpoints_[i] }; }
+
+		/*!
+		 * Returns the fractional breakpoint index of a value given in another unit; see uniform_axis::position.
+		 */
+		constexpr value_type position(value_type value, detail::affine_coefficients coefficients) const
+		{
+			const value_type x = value * static_cast<value_type>(coefficients.scale) + static_cast<value_type>(coefficients.offset);
+			const auto upper = std::upper_bound(breakpoints_.begin() + 1, breakpoints_.end() - 1, x);
+			const std::size_t i = static_cast<std::size_t>(upper - breakpoints_.begin()) - 1;
+			return static_cast<value_type>(i) + (x - breakpoints_[i]) / (breakpoints_[i + 1] - breakpoints_[i]);
+		}
+
+	private:
+
+		std::array<value_type, N> breakpoints_;
+	};
+
+	namespace detail
+	{
+		template<class T>
+		struct is_lut_axis : std::false_type {};
+
+		template<Unit UnitType, std::size_t N>
+		struct is_lut_axis<uniform_axis<UnitType, N>> : std::true_type {};
+
+		template<Unit UnitType, std::size_t N>
+		struct is_lut_axis<grid_axis<UnitType, N>> : std::true_type {};
+
+		/*!
+		 * Splits a fractional position into a cell index and the fraction within the cell, clamping to the
+		 * table so values outside the axis take the edge value. Written with selects so batch loops vectorise.
+		 */
+		template<class T>
+		constexpr std::pair<std::size_t, T> lut_cell(T position, std::size_t size)
+		{
+			const T last = static_cast<T>(size - 1);
+			position = position < T{} ? T{} : position;
+			position = position > last ? last : position;
+			std::size_t i = static_cast<std::size_t>(position);
+			i = i > size - 2 ? size - 2 : i;
+			return { i, position - static_cast<T>(i) };
+		}
+	}
+
+	/*!
+	 * quantity_lut is a 1D or 2D lookup table of quantity<ResultUnit>, indexed by quantities on its axes and
+	 * evaluated by linear or bilinear interpolation. Inputs outside an axis are clamped to its ends.
+	 *
+	 * Inputs may be in any unit that is SimilarUnits with the axis; the conversion is folded into the index
+	 * computation, so a kelvin axis can be indexed with celsius at no extra cost. Tables can be built in
+	 * constant expressions, either from values or with generate.
+	 *
+	 * The result unit comes first because a template parameter pack has to be last.
+	 *
+	 * @tparam ResultUnit The unit of the table values. Its value_type must be floating point.
+	 * @tparam Axes One or two uniform_axis or grid_axis types. The first axis is the slowest varying in the values.
+	 */
+	template<Unit ResultUnit, class... Axes>
+	requires std::is_floating_point_v<typename ResultUnit::value_type>
+		&& (sizeof...(Axes) == 1 || sizeof...(Axes) == 2) && (detail::is_lut_axis<Axes>::value && ...)
+	class quantity_lut
+	{
+	public:
+
+		using result_unit = ResultUnit;
+		using value_type = typename ResultUnit::value_type;
+
+		constexpr static const std::size_t dimensions = sizeof...(Axes);
+		constexpr static const std::size_t size = (Axes::size * ...);
+
+		constexpr quantity_lut(Axes... axes, std::array<value_type, size> const& values)
+			: axes_{ axes... },
+			  values_{ values }
+		{}
+
+		/*!
+		 * Builds a table by calling fn with the breakpoints of each cell, in the axis units.
+		 * fn must return a quantity of SimilarUnits with ResultUnit.
+		 */
+		template<class Fn>
+		constexpr static quantity_lut generate(Axes... axes, Fn fn)
+		{
+			std::array<value_type, size> values{};
+			const std::tuple<Axes...> all{ axes... };
+			if constexpr (dimensions == 1)
+			{
+				for (std::size_t i = 0; i < size; ++i)
+					values[i] = quantity<ResultUnit>{ fn(std::get<0>(all)[i]) }.value();
+			}
+			else
+			{
+				constexpr std::size_t columns = std::tuple_element_t<1, std::tuple<Axes...>>::size;
+				for (std::size_t i = 0; i < size / columns; ++i)
+					for (std::size_t j = 0; j < columns; ++j)
+						values[i * columns + j] = quantity<ResultUnit>{ fn(std::get<0>(all)[i], std::get<1>(all)[j]) }.value();
+			}
+			return quantity_lut{ axes..., values };
+		}
+
+		template<std::size_t I>
+		constexpr auto const& axis() const { return std::get<I>(axes_); }
+
+		constexpr std::span<const value_type, size> values() const { return values_; }
+
+		/*!
+		 * Interpolates the table at x.
+		 */
+		template<Unit X>
+		requires (dimensions == 1) && SimilarUnits<X, typename std::tuple_element_t<0, std::tuple<Axes...>>::unit_type>
+		constexpr quantity<ResultUnit> operator()(quantity<X> x) const
+		{
+			constexpr detail::affine_coefficients cx = coefficients<0, X>();
+			return quantity<ResultUnit>{ interpolate(std::get<0>(axes_).position(x.value(), cx)) };
+		}
+
+		/*!
+		 * Interpolates the table at (x, y).
+		 */
+		template<Unit X, Unit Y>
+		requires (dimensions == 2) && SimilarUnits<X, typename std::tuple_element_t<0, std::tuple<Axes...>>::unit_type>
+			&& SimilarUnits<Y, typename std::tuple_element_t<1, std::tuple<Axes...>>::unit_type>
+		constexpr quantity<ResultUnit> operator()(quantity<X> x, quantity<Y> y) const
+		{
+			constexpr detail::affine_coefficients cx = coefficients<0, X>();
+			constexpr detail::affine_coefficients cy = coefficients<1, Y>();
+			return quantity<ResultUnit>{ interpolate(std::get<0>(axes_).position(x.value(), cx), std::get<1>(axes_).position(y.value(), cy)) };
+		}
+
+		/*!
+		 * Interpolates the table at every x. The loop body has no data-dependent branches on uniform axes, so
+		 * compilers vectorise the index computation and blend; the table reads are gathers.
+		 *
+		 * @throws std::invalid_argument If x and out have different lengths.
+		 */
+		template<Unit X>
+		requires (dimensions == 1) && SimilarUnits<X, typename std::tuple_element_t<0, std::tuple<Axes...>>::unit_type>
+		void evaluate(std::span<const quantity<X>> x, std::span<quantity<ResultUnit>> out) const
+		{
+			if (x.size() != out.size())
+				throw std::invalid_argument("quantity_lut::evaluate spans must have the same length");
+			constexpr detail::affine_coefficients cx = coefficients<0, X>();
+			auto const& axis = std::get<0>(axes_);
+			for (std::size_t i = 0; i < x.size(); ++i)
+				out[i] = quantity<ResultUnit>{ interpolate(axis.position(static_cast<value_type>(x[i].value()), cx)) };
+		}
+
+		/*!
+		 * Interpolates the table at every (x[i], y[i]).
+		 *
+		 * @throws std::invalid_argument If the spans have different lengths.
+		 */
+		template<Unit X, Unit Y>
+		requires (dimensions == 2) && SimilarUnits<X, typename std::tuple_element_t<0, std::tuple<Axes...>>::unit_type>
+			&& SimilarUnits<Y, typename std::tuple_element_t<1, std::tuple<Axes...>>::unit_type>
+		void evaluate(std::span<const quantity<X>> x, std::span<const quantity<Y>> y, std::span<quantity<ResultUnit>> out) const
+		{
+			if (x.size() != out.size() || y.size() != out.size())
+				throw std::invalid_argument("quantity_lut::evaluate spans must have the same length");
+			constexpr detail::affine_coefficients cx = coefficients<0, X>();
+			constexpr detail::affine_coefficients cy = coefficients<1, Y>();
+			auto const& axis_x = std::get<0>(axes_);
+			auto const& axis_y = std::get<1>(axes_);
+			for (std::size_t i = 0; i < out.size(); ++i)
+				out[i] = quantity<ResultUnit>{ interpolate(axis_x.position(static_cast<value_type>(x[i].value()), cx), axis_y.position(static_cast<value_type>(y[i].value()), cy)) };
+		}
+
+	private:
+
+		template<std::size_t I, Unit Input>
+		constexpr static detail::affine_coefficients coefficients()
+		{
+			return detail::affine_conversion<Input, typename std::tuple_element_t<I, std::tuple<Axes...>>::unit_type>();
+		}
+
+		constexpr value_type interpolate(value_type position) const
+		{
+			const auto [i, t] = detail::lut_cell(position, size);
+			return values_[i] + (values_[i + 1] - values_[i]) * t;
+		}
+
+		constexpr value_type interpolate(value_type position_x, value_type position_y) const
+		{
+			constexpr std::size_t rows = std::tuple_element_t<0, std::tuple<Axes...>>::size;
+			constexpr std::size_t columns = std::tuple_element_t<1, std::tuple<Axes...>>::size;
+			const auto [i, tx] = detail::lut_cell(position_x, rows);
+			const auto [j, ty] = detail::lut_cell(position_y, columns);
+			const value_type* row = values_.data() + i * columns + j;
+			const value_type top = row[0] + (row[1] - row[0]) * ty;
+			const value_type bottom = row[columns] + (row[columns + 1] - row[columns]) * ty;
+			return top + (bottom - top) * tx;
+		}
+
+		std::tuple<Axes...> axes_;
+		std::array<value_type, size> values_;
+	};
+}
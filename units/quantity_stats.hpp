@@ -0,0 +1,243 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "exponent_unit.hpp"
+#include "difference_unit.hpp"
+
+namespace units
+{
+	/*!
+	 * quantity_stats is a one-pass accumulator for the count, mean, variance, skewness, minimum and maximum
+	 * of a stream of quantities. Single samples are folded in with Welford's update, and two accumulators
+	 * can be combined in O(1) using the pairwise update of Chan et al., so per-thread accumulators can be
+	 * merged at the end of a parallel reduction.
+	 *
+	 * Results keep their units: the mean is a quantity<UnitType>, the variance is a quantity of the squared
+	 * difference unit, and the standard deviation is a delta<UnitType>.
+	 *
+	 * @tparam UnitType The unit the statistics are accumulated in. Samples of SimilarUnits are converted on entry.
+	 */
+	template<Unit UnitType>
+	class quantity_stats
+	{
+	public:
+
+		using unit_type = UnitType;
+		using value_type = typename UnitType::value_type;
+		using variance_unit = make_exponent_t<difference_unit_t<UnitType>, 2>;
+
+		//! The type the running moments are held in. Integer units are accumulated in double.
+		using accumulator_type = std::conditional_t<std::is_floating_point_v<value_type>, value_type, double>;
+
+		constexpr quantity_stats() = default;
+
+		/*!
+		 * Adds a single sample to the accumulator.
+		 *
+		 * @param sample The sample. Must satisfy SimilarUnits<UnitType, unit>; it is converted to UnitType first.
+		 */
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		constexpr void add(quantity<unit> sample)
+		{
+			const value_type value = quantity<UnitType>{ sample }.value();
+			const accumulator_type x = static_cast<accumulator_type>(value);
+			const accumulator_type n1 = static_cast<accumulator_type>(count_);
+			++count_;
+			const accumulator_type n = static_cast<accumulator_type>(count_);
+			const accumulator_type d = x - mean_;
+			const accumulator_type d_n = d / n;
+			const accumulator_type term = d * d_n * n1;
+			mean_ += d_n;
+			m3_ += term * d_n * (n - 2) - 3 * d_n * m2_;
+			m2_ += term;
+			sum_ += x;
+			min_ = std::min(min_, value);
+			max_ = std::max(max_, value);
+		}
+
+		/*!
+		 * Adds a batch of samples. The batch is reduced on its own with independent accumulator lanes,
+		 * which the compiler can keep in vector registers without reassociating floating-point sums,
+		 * and the partial result is then merged into this accumulator.
+		 *
+		 * @param samples The samples to add. Must satisfy SimilarUnits<UnitType, unit>.
+		 */
+		template<Unit unit>
+		requires SimilarUnits<UnitType, unit>
+		constexpr void add(std::span<const quantity<unit>> samples)
+		{
+			if (samples.empty())
+				return;
+
+			constexpr std::size_t lanes = 8;
+			const std::size_t size = samples.size();
+			const std::size_t body = size - size % lanes;
+
+			std::array<accumulator_type, lanes> sum{};
+			std::array<value_type, lanes> lo;
+			std::array<value_type, lanes> hi;
+			lo.fill(std::numeric_limits<value_type>::max());
+			hi.fill(std::numeric_limits<value_type>::lowest());
+
+			for (std::size_t i = 0; i < body; i += lanes)
+			{
+				for (std::size_t l = 0; l < lanes; ++l)
+				{
+					const value_type value = quantity<UnitType>{ samples[i + l] }.value();
+					sum[l] += static_cast<accumulator_type>(value);
+					lo[l] = std::min(lo[l], value);
+					hi[l] = std::max(hi[l], value);
+				}
+			}
+			for (std::size_t i = body; i < size; ++i)
+			{
+				const value_type value = quantity<UnitType>{ samples[i] }.value();
+				sum[0] += static_cast<accumulator_type>(value);
+				lo[0] = std::min(lo[0], value);
+				hi[0] = std::max(hi[0], value);
+			}
+
+			quantity_stats batch;
+			batch.count_ = size;
+			for (std::size_t l = 0; l < lanes; ++l)
+			{
+				batch.sum_ += sum[l];
+				batch.min_ = std::min(batch.min_, lo[l]);
+				batch.max_ = std::max(batch.max_, hi[l]);
+			}
+			batch.mean_ = batch.sum_ / static_cast<accumulator_type>(size);
+
+			std::array<accumulator_type, lanes> m2{};
+			std::array<accumulator_type, lanes> m3{};
+			for (std::size_t i = 0; i < body; i += lanes)
+			{
+				for (std::size_t l = 0; l < lanes; ++l)
+				{
+					const accumulator_type d = static_cast<accumulator_type>(quantity<UnitType>{ samples[i + l] }.value()) - batch.mean_;
+					m2[l] += d * d;
+					m3[l] += d * d * d;
+				}
+			}
+			for (std::size_t i = body; i < size; ++i)
+			{
+				const accumulator_type d = static_cast<accumulator_type>(quantity<UnitType>{ samples[i] }.value()) - batch.mean_;
+				m2[0] += d * d;
+				m3[0] += d * d * d;
+			}
+			for (std::size_t l = 0; l < lanes; ++l)
+			{
+				batch.m2_ += m2[l];
+				batch.m3_ += m3[l];
+			}
+
+			merge(batch);
+		}
+
+		/*!
+		 * Merges another accumulator into this one in O(1). The result is the same as if every sample
+		 * added to other had been added to this accumulator.
+		 */
+		constexpr void merge(quantity_stats const& other)
+		{
+			if (other.count_ == 0)
+				return;
+			if (count_ == 0)
+			{
+				*this = other;
+				return;
+			}
+
+			const accumulator_type na = static_cast<accumulator_type>(count_);
+			const accumulator_type nb = static_cast<accumulator_type>(other.count_);
+			const accumulator_type n = na + nb;
+			const accumulator_type d = other.mean_ - mean_;
+			const accumulator_type d_n = d / n;
+
+			m3_ += other.m3_ + d * d_n * d_n * na * nb * (na - nb) + 3 * d_n * (na * other.m2_ - nb * m2_);
+			m2_ += other.m2_ + d * d_n * na * nb;
+			mean_ += d_n * nb;
+			sum_ += other.sum_;
+			count_ += other.count_;
+			min_ = std::min(min_, other.min_);
+			max_ = std::max(max_, other.max_);
+		}
+
+		/*!
+		 * Returns the number of samples added so far.
+		 */
+		constexpr std::uint64_t count() const { return count_; }
+
+		/*!
+		 * Returns the sum of all samples.
+		 */
+		constexpr quantity<UnitType> sum() const { return quantity<UnitType>{ static_cast<value_type>(sum_) }; }
+
+		/*!
+		 * Returns the arithmetic mean of all samples.
+		 */
+		constexpr quantity<UnitType> mean() const { return quantity<UnitType>{ static_cast<value_type>(mean_) }; }
+
+		/*!
+		 * Returns the smallest sample, or a value initialized quantity if no samples were added.
+		 */
+		constexpr quantity<UnitType> min() const { return count_ ? quantity<UnitType>{ min_ } : quantity<UnitType>{}; }
+
+		/*!
+		 * Returns the largest sample, or a value initialized quantity if no samples were added.
+		 */
+		constexpr quantity<UnitType> max() const { return count_ ? quantity<UnitType>{ max_ } : quantity<UnitType>{}; }
+
+		/*!
+		 * Returns the population variance, in the square of the difference unit of UnitType.
+		 */
+		constexpr quantity<variance_unit> variance() const
+		{
+			return quantity<variance_unit>{ count_ ? static_cast<value_type>(m2_ / static_cast<accumulator_type>(count_)) : value_type{} };
+		}
+
+		/*!
+		 * Returns the unbiased sample variance, in the square of the difference unit of UnitType.
+		 */
+		constexpr quantity<variance_unit> sample_variance() const
+		{
+			return quantity<variance_unit>{ count_ > 1 ? static_cast<value_type>(m2_ / static_cast<accumulator_type>(count_ - 1)) : value_type{} };
+		}
+
+		/*!
+		 * Returns the population standard deviation. This is a spread rather than an absolute amount,
+		 * so it is returned as a delta.
+		 */
+		delta<UnitType> standard_deviation() const
+		{
+			return delta<UnitType>{ count_ ? static_cast<value_type>(std::sqrt(m2_ / static_cast<accumulator_type>(count_))) : value_type{} };
+		}
+
+		/*!
+		 * Returns the population skewness. This is dimensionless, so it is returned as a plain number.
+		 */
+		accumulator_type skewness() const
+		{
+			if (count_ == 0 || m2_ == 0)
+				return 0;
+			return std::sqrt(static_cast<accumulator_type>(count_)) * m3_ / std::pow(m2_, accumulator_type{ 1.5 });
+		}
+
+	private:
+
+		std::uint64_t count_ = 0;
+		accumulator_type mean_ = 0;
+		accumulator_type m2_ = 0;
+		accumulator_type m3_ = 0;
+		accumulator_type sum_ = 0;
+		value_type min_ = std::numeric_limits<value_type>::max();
+		value_type max_ = std::numeric_limits<value_type>::lowest();
+	};
+}
\ No newline at end of file
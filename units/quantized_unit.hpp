@@ -0,0 +1,218 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "units.hpp"
+#include "linear_unit.hpp"
+#include "unit_scale.hpp"
+#include "unit_conversion.hpp"
+#include "quantity.hpp"
+#include "checked_value.hpp"
+
+namespace units
+{
+	/*!
+	 * quantized_unit is a scaled_unit stored as whole ticks of an integer type:
+	 * quantized_unit<si::meter, ratio<10000>, std::int16_t> counts 0.1 mm ticks in an int16, for a range of
+	 * +-3.2 m in a quarter of the memory of a double. The scale is exact, so quantities convert to and from
+	 * the base unit exactly, in the base unit's value_type; dequantize does it with one multiply.
+	 *
+	 * Quantities of the same quantized_unit add and subtract in the storage type, and wrap on overflow as it
+	 * does. Converting a quantity in another unit with the quantity constructor truncates toward zero;
+	 * use quantize to round to the nearest tick and choose what happens out of range.
+	 *
+	 * @tparam BaseUnit The unit computations are done in. Must have an exact scale (no offset).
+	 * @tparam Ratio The number of ticks per Ratio::den BaseUnits, as for scaled_unit.
+	 * @tparam StorageInt The integer type ticks are stored in.
+	 */
+	template<Unit BaseUnit, class Ratio, std::integral StorageInt>
+	struct quantized_unit : scaled_unit<BaseUnit, Ratio>
+	{
+		using scaled = scaled_unit<BaseUnit, Ratio>;
+		using value_type = StorageInt;
+		using compute_type = typename BaseUnit::value_type;
+
+		static_assert(unit_scale_v<scaled>.exact, "quantized_unit needs a base unit with an exact scale");
+
+		/*!
+		 * The fundamental value of a tick count, in compute_type. Inexact conversions (to an offset unit such as
+		 * celsius) go through here, and a fundamental value is rarely a whole number of ticks, so it is not
+		 * truncated back to StorageInt.
+		 */
+		constexpr static compute_type to_fundamental(compute_type v)
+		{
+			return scaled::to_fundamental(v);
+		}
+
+		//! The tick count of a fundamental value, in compute_type; the quantity constructor truncates it to StorageInt.
+		constexpr static compute_type from_fundamental(compute_type v)
+		{
+			return scaled::from_fundamental(v);
+		}
+
+		//! The size of one tick, in BaseUnit.
+		constexpr static compute_type quantum()
+		{
+			return Ratio::apply_inverse(compute_type{ 1 });
+		}
+
+		//! Bytes saved per value, against storing compute_type.
+		constexpr static const std::ptrdiff_t bytes_saved = static_cast<std::ptrdiff_t>(sizeof(compute_type)) - static_cast<std::ptrdiff_t>(sizeof(StorageInt));
+	};
+
+	template<Unit BaseUnit, class Ratio, std::integral StorageInt>
+	struct unit_scale<quantized_unit<BaseUnit, Ratio, StorageInt>>
+	{
+		constexpr static const detail::scale_factor value = unit_scale_v<scaled_unit<BaseUnit, Ratio>>;
+	};
+
+	namespace detail
+	{
+		template<class T>
+		struct is_quantized_unit : std::false_type {};
+
+		template<Unit BaseUnit, class Ratio, std::integral StorageInt>
+		struct is_quantized_unit<quantized_unit<BaseUnit, Ratio, StorageInt>> : std::true_type {};
+
+		/*!
+		 * Rounds x (already in ticks) to the nearest tick, half away from zero, and applies Policy if it is
+		 * out of the range of T. Returns true if it was. Written with selects only, so loops over it vectorise.
+		 */
+		template<std::integral T, overflow_policy Policy, class F>
+		constexpr bool quantize_ticks(F x, T& result)
+		{
+			// Signed, so negative values wrap into narrower unsigned types too; only uint64 needs the unsigned range.
+			using wide = std::conditional_t<std::is_signed_v<T> || sizeof(T) < sizeof(std::uint64_t), std::int64_t, std::uint64_t>;
+			// The largest values of T and wide that are exactly representable in F.
+			constexpr wide digits_mask = std::numeric_limits<wide>::max() >> (std::numeric_limits<F>::digits - 1);
+			constexpr F wide_max = static_cast<F>(std::numeric_limits<wide>::max() - digits_mask);
+			constexpr F wide_min = static_cast<F>(std::numeric_limits<wide>::min());
+			constexpr F max = sizeof(T) < sizeof(wide) ? static_cast<F>(std::numeric_limits<T>::max()) : wide_max;
+			constexpr F min = static_cast<F>(std::numeric_limits<T>::min());
+
+			x = x < F{} ? x - F{ 0.5 } : x + F{ 0.5 };
+			const bool out_of_range = !(x > min - F{ 1 } && x < max + F{ 1 });
+			if constexpr (Policy == overflow_policy::saturate)
+			{
+				x = x < min ? min : x;
+				x = x > max ? max : x;
+				result = static_cast<T>(x);
+			}
+			else
+			{
+				// Wrap through the 64-bit type; the narrowing conversion is modulo 2^N.
+				x = x < wide_min ? wide_min : x;
+				x = x > wide_max ? wide_max : x;
+				result = static_cast<T>(static_cast<wide>(x));
+			}
+			return out_of_range;
+		}
+
+		template<overflow_policy Policy>
+		constexpr void quantize_overflowed(bool any)
+		{
+			if constexpr (Policy == overflow_policy::trap)
+			{
+				if (any)
+					throw std::overflow_error("value out of range of the quantized storage");
+			}
+			else if constexpr (Policy == overflow_policy::report)
+			{
+				if (!std::is_constant_evaluated())
+					overflow_flag() |= any;
+			}
+		}
+	}
+
+	/*!
+	 * Converts value to the nearest tick of Quantized. Out-of-range values are handled by Policy, as for
+	 * checked: saturate clamps, wrap wraps modulo 2^N, trap throws std::overflow_error and report wraps and
+	 * sets the overflow flag (see overflow_reported).
+	 */
+	template<Unit Quantized, overflow_policy Policy = overflow_policy::saturate, Unit From>
+	requires detail::is_quantized_unit<Quantized>::value && SimilarUnits<From, Quantized>
+	constexpr quantity<Quantized> quantize(quantity<From> value)
+	{
+		using compute_type = typename Quantized::compute_type;
+		typename Quantized::value_type ticks{};
+		const bool out_of_range = detail::quantize_ticks<typename Quantized::value_type, Policy>(
+			static_cast<compute_type>(unit_conversion<From, typename Quantized::scaled>::convert(value.value())), ticks);
+		detail::quantize_overflowed<Policy>(out_of_range);
+		return quantity<Quantized>{ ticks };
+	}
+
+	template<Unit Quantized, overflow_policy Policy = overflow_policy::saturate, Unit From>
+	requires detail::is_quantized_unit<Quantized>::value && SimilarUnits<From, Quantized>
+	constexpr delta<Quantized> quantize(delta<From> value)
+	{
+		using compute_type = typename Quantized::compute_type;
+		typename Quantized::value_type ticks{};
+		const bool out_of_range = detail::quantize_ticks<typename Quantized::value_type, Policy>(
+			static_cast<compute_type>(unit_conversion<typename delta<From>::unit_type, typename Quantized::scaled>::convert(value.value())), ticks);
+		detail::quantize_overflowed<Policy>(out_of_range);
+		return delta<Quantized>{ ticks };
+	}
+
+	/*!
+	 * Packs values into Quantized ticks, rounding to nearest. The conversion is folded into one multiply per
+	 * value and the loop has no branches, so it vectorises. Policy is applied per batch, after the loop, so
+	 * with overflow_policy::trap every output has been written when the exception is thrown.
+	 *
+	 * @throws std::invalid_argument If the spans have different lengths.
+	 */
+	template<overflow_policy Policy = overflow_policy::saturate, Unit From, Unit Quantized>
+	requires detail::is_quantized_unit<Quantized>::value && SimilarUnits<From, Quantized>
+	void quantize(std::span<const quantity<From>> values, std::span<quantity<Quantized>> out)
+	{
+		if (values.size() != out.size())
+			throw std::invalid_argument("quantize spans must have the same length");
+		using compute_type = typename Quantized::compute_type;
+		using storage_type = typename Quantized::value_type;
+		constexpr detail::affine_coefficients c = detail::affine_conversion<From, typename Quantized::scaled>();
+		static_assert(c.offset == 0.0, "quantize needs an exact conversion");
+		constexpr compute_type scale = static_cast<compute_type>(c.scale);
+
+		bool any = false;
+		for (std::size_t i = 0; i < values.size(); ++i)
+		{
+			storage_type ticks{};
+			any |= detail::quantize_ticks<storage_type, Policy>(static_cast<compute_type>(values[i].value()) * scale, ticks);
+			out[i] = quantity<Quantized>{ ticks };
+		}
+		detail::quantize_overflowed<Policy>(any);
+	}
+
+	/*!
+	 * Converts ticks to To with a multiply by the tick size. The quantity constructor is exact, so it divides
+	 * when the ratio has a denominator (0.1 mm ticks to meters divide by 10000); this rounds once more but
+	 * is several times faster in loops.
+	 */
+	template<Unit To, Unit Quantized>
+	requires detail::is_quantized_unit<Quantized>::value && SimilarUnits<Quantized, To> && std::is_floating_point_v<typename To::value_type>
+	constexpr quantity<To> dequantize(quantity<Quantized> ticks)
+	{
+		using value_type = typename To::value_type;
+		constexpr value_type scale = static_cast<value_type>(detail::affine_conversion<typename Quantized::scaled, To>().scale);
+		return quantity<To>{ static_cast<value_type>(ticks.value()) * scale };
+	}
+
+	/*!
+	 * Unpacks Quantized ticks into To: one conversion to the compute type and one multiply per value, as
+	 * for the single-value dequantize.
+	 *
+	 * @throws std::invalid_argument If the spans have different lengths.
+	 */
+	template<Unit Quantized, Unit To>
+	requires detail::is_quantized_unit<Quantized>::value && SimilarUnits<Quantized, To> && std::is_floating_point_v<typename To::value_type>
+	void dequantize(std::span<const quantity<Quantized>> ticks, std::span<quantity<To>> out)
+	{
+		if (ticks.size() != out.size())
+			throw std::invalid_argument("dequantize spans must have the same length");
+		for (std::size_t i = 0; i < ticks.size(); ++i)
+			out[i] = dequantize<To>(ticks[i]);
+	}
+}
@@ -0,0 +1,251 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "units.hpp"
+#include "fundamental_unit.hpp"
+#include "compound_unit.hpp"
+#include "unit_scale.hpp"
+#include "detail/type_name.hpp"
+
+namespace units
+{
+	/*!
+	 * runtime_dimension is the run-time counterpart of the tag/exponent pairs that compare_tag and
+	 * compare_exponent work on. Each entry is a unit_tag (identified by a hash of its detail::portable_type_name)
+	 * and the summed exponent of that tag; entries are kept sorted by tag and zero exponents are removed, so two
+	 * dimensions are equal exactly when similar_units_v would hold for the units they came from.
+	 */
+	class runtime_dimension
+	{
+	public:
+
+		//! The maximum number of distinct tags in one dimension.
+		constexpr static const std::size_t max_tags = 8;
+
+		struct entry
+		{
+			std::uint64_t tag = 0;
+			std::string_view name;
+			std::int32_t exponent = 0;
+		};
+
+		constexpr runtime_dimension() = default;
+
+		/*!
+		 * Returns the dimension of UnitType, following the same decomposition as compare_tag and compare_exponent.
+		 */
+		template<Unit UnitType>
+		constexpr static runtime_dimension of()
+		{
+			runtime_dimension result;
+			result.add_unit<UnitType>(1);
+			return result;
+		}
+
+		constexpr bool dimensionless() const { return size_ == 0; }
+		constexpr std::size_t size() const { return size_; }
+		constexpr entry const& operator[](std::size_t i) const { return entries_[i]; }
+
+		/*!
+		 * Adds exponent to the entry for tag, inserting or removing the entry as needed.
+		 */
+		constexpr void add(std::uint64_t tag, std::string_view name, std::int32_t exponent)
+		{
+			std::size_t i = 0;
+			while (i < size_ && entries_[i].tag < tag)
+				++i;
+
+			if (i < size_ && entries_[i].tag == tag)
+			{
+				entries_[i].exponent += exponent;
+				if (entries_[i].exponent == 0)
+				{
+					for (std::size_t j = i + 1; j < size_; ++j)
+						entries_[j - 1] = entries_[j];
+					--size_;
+				}
+				return;
+			}
+
+			if (exponent == 0)
+				return;
+			if (size_ == max_tags)
+				throw std::length_error("runtime_dimension has too many distinct unit tags");
+			for (std::size_t j = size_; j > i; --j)
+				entries_[j] = entries_[j - 1];
+			entries_[i] = entry{ tag, name, exponent };
+			++size_;
+		}
+
+		constexpr runtime_dimension power(std::int32_t n) const
+		{
+			runtime_dimension result;
+			if (n == 0)
+				return result;
+			result = *this;
+			for (std::size_t i = 0; i < result.size_; ++i)
+				result.entries_[i].exponent *= n;
+			return result;
+		}
+
+		friend constexpr runtime_dimension operator*(runtime_dimension a, runtime_dimension const& b)
+		{
+			for (std::size_t i = 0; i < b.size_; ++i)
+				a.add(b.entries_[i].tag, b.entries_[i].name, b.entries_[i].exponent);
+			return a;
+		}
+
+		friend constexpr runtime_dimension operator/(runtime_dimension a, runtime_dimension const& b)
+		{
+			for (std::size_t i = 0; i < b.size_; ++i)
+				a.add(b.entries_[i].tag, b.entries_[i].name, -b.entries_[i].exponent);
+			return a;
+		}
+
+		friend constexpr bool operator==(runtime_dimension const& a, runtime_dimension const& b)
+		{
+			if (a.size_ != b.size_)
+				return false;
+			for (std::size_t i = 0; i < a.size_; ++i)
+				if (a.entries_[i].tag != b.entries_[i].tag || a.entries_[i].exponent != b.entries_[i].exponent)
+					return false;
+			return true;
+		}
+
+		/*!
+		 * Returns a readable form such as "meter^1 second^-2", for diagnostics.
+		 */
+		std::string to_string() const
+		{
+			if (size_ == 0)
+				return "dimensionless";
+			std::string result;
+			for (std::size_t i = 0; i < size_; ++i)
+			{
+				if (i != 0)
+					result += ' ';
+				result += entries_[i].name;
+				result += '^';
+				result += std::to_string(entries_[i].exponent);
+			}
+			return result;
+		}
+
+	private:
+
+		template<Unit UnitType>
+		constexpr void add_unit(std::int32_t sign)
+		{
+			if constexpr (requires { add_compound(static_cast<UnitType*>(nullptr), sign); })
+				add_compound(static_cast<UnitType*>(nullptr), sign);
+			else
+				add(detail::fnv1a(detail::portable_type_name<tag_of_t<UnitType>>()), detail::portable_type_name<tag_of_t<UnitType>>(), sign * static_cast<std::int32_t>(exponent_of_v<UnitType>));
+		}
+
+		template<Unit... Units>
+		constexpr void add_compound(compound_unit<Units...>*, std::int32_t sign)
+		{
+			(add_unit<Units>(sign), ...);
+		}
+
+		std::array<entry, max_tags> entries_{};
+		std::size_t size_ = 0;
+	};
+
+	/*!
+	 * runtime_unit describes a unit whose type is only known at run time, for example from column metadata.
+	 * It carries the dimension and the affine map to the fundamental units of that dimension:
+	 * fundamental = value * scale + offset. Units built from scaled, exponent and compound units have an
+	 * offset of zero; offset_unit and linear_unit (celsius, fahrenheit) have a non-zero offset.
+	 */
+	struct runtime_unit
+	{
+		runtime_dimension dimension;
+		double scale = 1.0;
+		double offset = 0.0;
+
+		/*!
+		 * Returns the runtime_unit for UnitType. The scale comes from unit_scale when it is exact,
+		 * otherwise it is measured through to_fundamental, which also picks up any offset.
+		 */
+		template<Unit UnitType>
+		constexpr static runtime_unit of()
+		{
+			runtime_unit result;
+			result.dimension = runtime_dimension::of<UnitType>();
+			constexpr detail::scale_factor factor = unit_scale_v<UnitType>;
+			if constexpr (factor.exact)
+				result.scale = static_cast<double>(factor.num) / static_cast<double>(factor.den);
+			else
+			{
+				result.offset = static_cast<double>(UnitType::to_fundamental(0));
+				result.scale = static_cast<double>(UnitType::to_fundamental(1)) - result.offset;
+			}
+			return result;
+		}
+
+		constexpr double to_fundamental(double value) const { return value * scale + offset; }
+		constexpr double from_fundamental(double value) const { return (value - offset) / scale; }
+
+		friend constexpr bool operator==(runtime_unit const&, runtime_unit const&) = default;
+	};
+
+	namespace detail
+	{
+		constexpr std::uint64_t fnv1a_integer(std::uint64_t value, std::uint64_t hash)
+		{
+			for (int i = 0; i < 8; ++i)
+			{
+				hash ^= (value >> (8 * i)) & 0xff;
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+	}
+
+	namespace detail
+	{
+		//! Satisfied when UnitType::to_fundamental can be evaluated at compile time, so runtime_unit::of can measure it.
+		template<class UnitType>
+		concept constant_to_fundamental = requires { typename std::bool_constant<(UnitType::to_fundamental(typename UnitType::value_type{ 1 }), true)>; };
+	}
+
+	/*!
+	 * Returns a 64-bit fingerprint of UnitType, computed at compile time from its dimension (tag names and
+	 * exponents), its scale and offset to the fundamental units, and the size and kind of its value_type.
+	 * Units that store the same numbers the same way (si::meter and si_system_t<double>::meter, for example)
+	 * have the same fingerprint, so it can be written next to raw values that another process or build reads.
+	 * Units whose conversion is not constexpr (logarithmic_unit) hash their type name instead of the scale and offset.
+	 * Tag names are detail::portable_type_name, which is the same across compilers for tags at namespace scope.
+	 */
+	template<Unit UnitType>
+	constexpr std::uint64_t unit_fingerprint()
+	{
+		using value_type = typename UnitType::value_type;
+		constexpr runtime_dimension dimension = runtime_dimension::of<UnitType>();
+		std::uint64_t hash = detail::fnv1a("cpp_units");
+		for (std::size_t i = 0; i < dimension.size(); ++i)
+		{
+			hash = detail::fnv1a(dimension[i].name, hash);
+			hash = detail::fnv1a_integer(static_cast<std::uint64_t>(dimension[i].exponent), hash);
+		}
+		if constexpr (detail::constant_to_fundamental<UnitType>)
+		{
+			constexpr runtime_unit unit = runtime_unit::of<UnitType>();
+			hash = detail::fnv1a_integer(std::bit_cast<std::uint64_t>(unit.scale), hash);
+			hash = detail::fnv1a_integer(std::bit_cast<std::uint64_t>(unit.offset + 0.0), hash);
+		}
+		else
+			hash = detail::fnv1a(detail::type_name<UnitType>(), hash);
+		hash = detail::fnv1a_integer(sizeof(value_type), hash);
+		hash = detail::fnv1a_integer((std::is_floating_point_v<value_type> ? 2u : 0u) | (std::is_signed_v<value_type> ? 1u : 0u), hash);
+		return hash;
+	}
+}
@@ -0,0 +1,491 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "runtime_unit.hpp"
+
+namespace units
+{
+	namespace detail
+	{
+		/*!
+		 * Header written at the start of every compressed block. Fields are stored in host byte order.
+		 * The fingerprint identifies the quantity or delta type (and so the unit) the block was encoded
+		 * from; decoding into any other type is an error.
+		 */
+		struct series_block_header
+		{
+			std::uint32_t magic;
+			std::uint8_t encoding;
+			std::uint8_t value_size;
+			std::uint16_t reserved;
+			std::uint32_t count;
+			std::uint32_t payload_size;
+			std::uint64_t fingerprint;
+		};
+
+		constexpr const std::uint32_t series_block_magic = 0x31535451; // "QTS1"
+
+		enum class series_encoding : std::uint8_t
+		{
+			xor_float = 0,
+			delta_of_delta = 1,
+		};
+
+		/*!
+		 * The fingerprint written in block headers: unit_fingerprint of the stored unit, so blocks and
+		 * shared rings identify units the same way, mixed with whether the values are quantities or deltas.
+		 */
+		template<class Q>
+		constexpr std::uint64_t series_fingerprint()
+		{
+			using unit_type = typename std::remove_cv_t<Q>::unit_type;
+			constexpr bool is_delta = !std::is_same_v<std::remove_cv_t<Q>, quantity<unit_type>>;
+			return fnv1a_integer(is_delta ? 1u : 0u, unit_fingerprint<unit_type>());
+		}
+
+		//! Appends bits, most significant first, to a byte buffer. finish() must be called to write the last partial byte.
+		class bit_writer
+		{
+		public:
+
+			explicit bit_writer(std::vector<std::uint8_t>& out)
+				: out_{ out }
+			{}
+
+			void write(std::uint64_t bits, unsigned count)
+			{
+				if (count > 32)
+				{
+					write(bits >> 32, count - 32);
+					count = 32;
+				}
+				buffer_ = (buffer_ << count) | (bits & ((std::uint64_t{ 1 } << count) - 1));
+				used_ += count;
+				while (used_ >= 8)
+				{
+					used_ -= 8;
+					out_.push_back(static_cast<std::uint8_t>(buffer_ >> used_));
+				}
+			}
+
+			void finish()
+			{
+				if (used_ > 0)
+					out_.push_back(static_cast<std::uint8_t>(buffer_ << (8 - used_)));
+				used_ = 0;
+			}
+
+		private:
+
+			std::vector<std::uint8_t>& out_;
+			std::uint64_t buffer_ = 0;
+			unsigned used_ = 0;
+		};
+
+		//! Reads bits written by bit_writer, refilling a 64-bit buffer a byte at a time.
+		class bit_reader
+		{
+		public:
+
+			explicit bit_reader(std::span<const std::uint8_t> in)
+				: in_{ in }
+			{}
+
+			std::uint64_t read(unsigned count)
+			{
+				if (count > 32)
+				{
+					const std::uint64_t high = read(count - 32);
+					return (high << 32) | read(32);
+				}
+				if (available_ < count)
+				{
+					while (available_ <= 56 && byte_ < in_.size())
+					{
+						buffer_ = (buffer_ << 8) | in_[byte_++];
+						available_ += 8;
+					}
+					if (available_ < count)
+						throw std::out_of_range("compressed block is truncated");
+				}
+				available_ -= count;
+				return (buffer_ >> available_) & ((std::uint64_t{ 1 } << count) - 1);
+			}
+
+		private:
+
+			std::span<const std::uint8_t> in_;
+			std::size_t byte_ = 0;
+			std::uint64_t buffer_ = 0;
+			unsigned available_ = 0;
+		};
+
+		constexpr std::uint64_t zigzag_encode(std::uint64_t value)
+		{
+			return (value << 1) ^ (0 - (value >> 63));
+		}
+
+		constexpr std::uint64_t zigzag_decode(std::uint64_t value)
+		{
+			return (value >> 1) ^ (0 - (value & 1));
+		}
+
+		inline void write_varint(std::vector<std::uint8_t>& out, std::uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				out.push_back(static_cast<std::uint8_t>(value | 0x80));
+				value >>= 7;
+			}
+			out.push_back(static_cast<std::uint8_t>(value));
+		}
+
+		inline std::uint64_t read_varint(std::span<const std::uint8_t> in, std::size_t& position)
+		{
+			std::uint64_t value = 0;
+			const bool unchecked = in.size() - position >= 10;
+			for (unsigned shift = 0; shift < 64; shift += 7)
+			{
+				if (!unchecked && position >= in.size())
+					throw std::out_of_range("compressed block is truncated");
+				const std::uint8_t byte = in[position++];
+				value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+					return value;
+			}
+			throw std::invalid_argument("compressed block has an invalid varint");
+		}
+
+		template<class T>
+		using series_bits_t = std::conditional_t<sizeof(T) <= 4, std::uint32_t, std::uint64_t>;
+
+		/*!
+		 * Gorilla-style XOR encoding. Each value is XORed with the previous one; identical values cost
+		 * one bit, and values whose XOR fits in the previous leading/trailing zero window cost two bits
+		 * plus the meaningful bits.
+		 */
+		template<class T>
+		void encode_xor(std::span<const T> values, std::vector<std::uint8_t>& out)
+		{
+			using bits_type = series_bits_t<T>;
+			constexpr unsigned width = sizeof(bits_type) * 8;
+
+			bit_writer writer{ out };
+			bits_type previous = std::bit_cast<bits_type>(values[0]);
+			writer.write(previous, width);
+
+			unsigned window_leading = width + 1;
+			unsigned window_trailing = 0;
+			for (std::size_t i = 1; i < values.size(); ++i)
+			{
+				const bits_type current = std::bit_cast<bits_type>(values[i]);
+				const bits_type x = current ^ previous;
+				previous = current;
+
+				if (x == 0)
+				{
+					writer.write(0, 1);
+					continue;
+				}
+
+				const unsigned leading = static_cast<unsigned>(std::countl_zero(x));
+				const unsigned trailing = static_cast<unsigned>(std::countr_zero(x));
+				if (leading >= window_leading && trailing >= window_trailing)
+				{
+					writer.write(0b10, 2);
+					writer.write(x >> window_trailing, width - window_leading - window_trailing);
+				}
+				else
+				{
+					const unsigned meaningful = width - leading - trailing;
+					writer.write(0b11, 2);
+					writer.write(leading, 6);
+					writer.write(meaningful - 1, 6);
+					writer.write(x >> trailing, meaningful);
+					window_leading = leading;
+					window_trailing = trailing;
+				}
+			}
+			writer.finish();
+		}
+
+		template<class T>
+		void decode_xor(std::span<const std::uint8_t> in, std::span<T> values)
+		{
+			using bits_type = series_bits_t<T>;
+			constexpr unsigned width = sizeof(bits_type) * 8;
+
+			bit_reader reader{ in };
+			bits_type previous = static_cast<bits_type>(reader.read(width));
+			values[0] = std::bit_cast<T>(previous);
+
+			unsigned window_leading = 0;
+			unsigned window_trailing = 0;
+			for (std::size_t i = 1; i < values.size(); ++i)
+			{
+				if (reader.read(1) != 0)
+				{
+					if (reader.read(1) != 0)
+					{
+						window_leading = static_cast<unsigned>(reader.read(6));
+						const unsigned meaningful = static_cast<unsigned>(reader.read(6)) + 1;
+						if (window_leading + meaningful > width)
+							throw std::invalid_argument("compressed block has an invalid xor window");
+						window_trailing = width - window_leading - meaningful;
+					}
+					previous ^= static_cast<bits_type>(reader.read(width - window_leading - window_trailing) << window_trailing);
+				}
+				values[i] = std::bit_cast<T>(previous);
+			}
+		}
+
+		/*!
+		 * Delta-of-delta encoding for integers. The first value and first delta are stored as zigzag
+		 * varints, followed by the zigzag varint of each change in delta. Arithmetic is done modulo 2^64,
+		 * so every integer type round-trips exactly.
+		 */
+		template<class T>
+		void encode_delta_of_delta(std::span<const T> values, std::vector<std::uint8_t>& out)
+		{
+			std::uint64_t previous = static_cast<std::uint64_t>(values[0]);
+			write_varint(out, zigzag_encode(previous));
+			std::uint64_t previous_delta = 0;
+			for (std::size_t i = 1; i < values.size(); ++i)
+			{
+				const std::uint64_t current = static_cast<std::uint64_t>(values[i]);
+				const std::uint64_t delta = current - previous;
+				write_varint(out, zigzag_encode(delta - previous_delta));
+				previous = current;
+				previous_delta = delta;
+			}
+		}
+
+		/*!
+		 * Decodes delta-of-delta blocks in two passes: the varints are unpacked into a buffer of second
+		 * differences, then two running sums rebuild the values. Only the first pass depends on the byte
+		 * stream; the prefix sums are simple loops over contiguous memory.
+		 */
+		template<class T>
+		void decode_delta_of_delta(std::span<const std::uint8_t> in, std::span<T> values)
+		{
+			std::vector<std::uint64_t> work(values.size());
+			std::size_t position = 0;
+			for (auto& entry : work)
+				entry = zigzag_decode(read_varint(in, position));
+
+			std::uint64_t delta = 0;
+			for (std::size_t i = 1; i < work.size(); ++i)
+			{
+				delta += work[i];
+				work[i] = delta;
+			}
+			std::uint64_t value = 0;
+			for (std::size_t i = 0; i < work.size(); ++i)
+			{
+				value += work[i];
+				values[i] = static_cast<T>(value);
+			}
+		}
+	}
+
+	/*!
+	 * Encodes values as one self-contained block and appends it to out. Floating point values are
+	 * XOR compressed and integer values are delta-of-delta compressed. The quantity (or delta) type
+	 * is recorded once in the block header.
+	 *
+	 * @return The number of bytes appended.
+	 */
+	template<detail::QuantityOrDelta Q>
+	std::size_t encode_block(std::span<const Q> values, std::vector<std::uint8_t>& out)
+	{
+		using value_type = typename Q::value_type;
+		static_assert(std::is_arithmetic_v<value_type>, "Only arithmetic value types can be compressed");
+		static_assert(sizeof(Q) == sizeof(value_type), "Compression assumes quantities have the layout of their value_type");
+
+		const std::size_t start = out.size();
+		out.resize(start + sizeof(detail::series_block_header));
+		if (!values.empty())
+		{
+			const std::span<const value_type> raw{ reinterpret_cast<const value_type*>(values.data()), values.size() };
+			if constexpr (std::is_floating_point_v<value_type>)
+				detail::encode_xor(raw, out);
+			else
+				detail::encode_delta_of_delta(raw, out);
+		}
+
+		const detail::series_block_header header{
+			detail::series_block_magic,
+			static_cast<std::uint8_t>(std::is_floating_point_v<value_type> ? detail::series_encoding::xor_float : detail::series_encoding::delta_of_delta),
+			static_cast<std::uint8_t>(sizeof(value_type)),
+			0,
+			static_cast<std::uint32_t>(values.size()),
+			static_cast<std::uint32_t>(out.size() - start - sizeof(detail::series_block_header)),
+			detail::series_fingerprint<Q>()
+		};
+		std::memcpy(out.data() + start, &header, sizeof(header));
+		return out.size() - start;
+	}
+
+	/*!
+	 * Returns the header of the block at the start of bytes, after checking that it is a block.
+	 */
+	inline detail::series_block_header read_block_header(std::span<const std::uint8_t> bytes)
+	{
+		detail::series_block_header header;
+		if (bytes.size() < sizeof(header))
+			throw std::out_of_range("compressed block is truncated");
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (header.magic != detail::series_block_magic)
+			throw std::invalid_argument("not a compressed quantity block");
+		if (bytes.size() < sizeof(header) + header.payload_size)
+			throw std::out_of_range("compressed block is truncated");
+		return header;
+	}
+
+	/*!
+	 * Decodes the block at the start of bytes into out, which must have room for the block's count.
+	 * Throws std::invalid_argument if the block was encoded from a different quantity or delta type.
+	 *
+	 * @return The number of values decoded.
+	 */
+	template<detail::QuantityOrDelta Q>
+	std::size_t decode_block(std::span<const std::uint8_t> bytes, std::span<Q> out)
+	{
+		using value_type = typename Q::value_type;
+		const detail::series_block_header header = read_block_header(bytes);
+		if (header.fingerprint != detail::series_fingerprint<Q>() || header.value_size != sizeof(value_type))
+			throw std::invalid_argument("compressed block has a different unit type");
+		if (out.size() < header.count)
+			throw std::out_of_range("output is too small for compressed block");
+		if (header.count == 0)
+			return 0;
+
+		const auto payload = bytes.subspan(sizeof(header), header.payload_size);
+		const std::span<value_type> raw{ reinterpret_cast<value_type*>(out.data()), header.count };
+		if constexpr (std::is_floating_point_v<value_type>)
+			detail::decode_xor(payload, raw);
+		else
+			detail::decode_delta_of_delta(payload, raw);
+		return header.count;
+	}
+
+	/*!
+	 * compressed_series stores a growing sequence of quantities (or deltas) as a list of independently
+	 * compressed blocks of up to block_size values. Any block can be decoded without touching the others,
+	 * so random access costs at most one block decode. Values are buffered until a block is full or
+	 * flush() is called.
+	 */
+	template<detail::QuantityOrDelta Q>
+	class compressed_series
+	{
+	public:
+
+		using value_type = Q;
+
+		explicit compressed_series(std::size_t block_size = 1024)
+			: block_size_{ block_size }
+		{
+			pending_.reserve(block_size);
+		}
+
+		void push_back(Q value)
+		{
+			pending_.push_back(value);
+			if (pending_.size() == block_size_)
+				flush();
+		}
+
+		void append(std::span<const Q> values)
+		{
+			for (const Q& value : values)
+				push_back(value);
+		}
+
+		/*!
+		 * Compresses any buffered values into a (possibly short) block.
+		 */
+		void flush()
+		{
+			if (pending_.empty())
+				return;
+			offsets_.push_back(bytes_.size());
+			starts_.push_back(count_);
+			encode_block(std::span<const Q>{ pending_ }, bytes_);
+			count_ += pending_.size();
+			pending_.clear();
+		}
+
+		//! Returns the total number of values, including buffered ones.
+		std::size_t size() const { return count_ + pending_.size(); }
+
+		//! Returns the number of compressed blocks. Buffered values are not counted until flushed.
+		std::size_t block_count() const { return offsets_.size(); }
+
+		std::size_t block_size() const { return block_size_; }
+
+		//! Returns the compressed bytes, not counting buffered values.
+		std::span<const std::uint8_t> bytes() const { return bytes_; }
+
+		/*!
+		 * Decodes block index into out and returns the number of values written.
+		 */
+		std::size_t decode_block(std::size_t index, std::span<Q> out) const
+		{
+			const std::size_t end = index + 1 < offsets_.size() ? offsets_[index + 1] : bytes_.size();
+			return units::decode_block(std::span<const std::uint8_t>{ bytes_ }.subspan(offsets_[index], end - offsets_[index]), out);
+		}
+
+		/*!
+		 * Returns value index. The block that contains it is decoded and kept until a value from another
+		 * block is read, so reading in order decodes each block once; reading at random costs a block
+		 * decode, O(block_size), per access. The cached block makes this unsafe to call from several
+		 * threads at once; concurrent readers should call decode_block with their own buffers.
+		 */
+		Q operator[](std::size_t index) const
+		{
+			if (index >= count_)
+				return pending_[index - count_];
+			if (index < cached_start_ || index - cached_start_ >= cached_.size())
+			{
+				const std::size_t block_index = static_cast<std::size_t>(std::upper_bound(starts_.begin(), starts_.end(), index) - starts_.begin()) - 1;
+				cached_.resize(block_size_);
+				cached_.resize(decode_block(block_index, cached_));
+				cached_start_ = starts_[block_index];
+			}
+			return cached_[index - cached_start_];
+		}
+
+		/*!
+		 * Decodes every value, including buffered ones.
+		 */
+		std::vector<Q> decode() const
+		{
+			std::vector<Q> values(size());
+			std::size_t written = 0;
+			for (std::size_t i = 0; i < offsets_.size(); ++i)
+				written += decode_block(i, std::span<Q>{ values }.subspan(written));
+			std::copy(pending_.begin(), pending_.end(), values.begin() + static_cast<std::ptrdiff_t>(written));
+			return values;
+		}
+
+	private:
+
+		std::size_t block_size_;
+		std::size_t count_ = 0;
+		std::vector<std::uint8_t> bytes_;
+		std::vector<std::size_t> offsets_;
+		std::vector<std::size_t> starts_;
+		std::vector<Q> pending_;
+		// The block last decoded by operator[]; blocks never change once written, so it does not go stale.
+		mutable std::vector<Q> cached_;
+		mutable std::size_t cached_start_ = 0;
+	};
+}
@@ -0,0 +1,372 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "runtime_unit.hpp"
+#include "pipeline.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CPP_UNITS_HAS_POSIX_SHARED_MEMORY 1
+#endif
+
+namespace units
+{
+	/*!
+	 * How many processes may write to a shared_quantity_ring at once.
+	 */
+	enum class ring_producers
+	{
+		//! One producer. Pushing is a load, a copy and a store.
+		single,
+		//! Any number of producers. Each push claims a range with a compare-and-swap, and ranges are published in claim order.
+		multiple,
+	};
+
+	namespace detail
+	{
+		constexpr const std::uint32_t shared_ring_magic = 0x52535451; // "QTSR"
+		constexpr const std::uint32_t shared_ring_version = 1;
+
+		/*!
+		 * The header at the start of a shared ring. The indices only ever increase; the slot of an index is
+		 * index & (capacity - 1). Each index is on its own cache line so the producer and consumer do not
+		 * false-share.
+		 */
+		struct shared_ring_header
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint64_t fingerprint;
+			std::uint32_t value_size;
+			std::uint32_t producers;
+			std::uint64_t capacity;
+
+			alignas(cache_line_size) std::atomic<std::uint64_t> claimed;
+			alignas(cache_line_size) std::atomic<std::uint64_t> published;
+			alignas(cache_line_size) std::atomic<std::uint64_t> consumed;
+		};
+
+		static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared rings need lock-free 64-bit atomics to work across processes");
+
+		constexpr std::size_t shared_ring_data_offset = (sizeof(shared_ring_header) + cache_line_size - 1) / cache_line_size * cache_line_size;
+	}
+
+	/*!
+	 * shared_quantity_ring is a ring buffer of quantity<UnitType> laid out in a caller-provided block of memory,
+	 * normally a shared_memory_region, so processes on the same host can exchange quantity streams without
+	 * serialising them. The values are stored as they are in memory, and the consumer reads them in place.
+	 *
+	 * The header records unit_fingerprint<UnitType>(). attach checks it, so a consumer built for a different
+	 * unit (or value type) fails to attach instead of misreading the values.
+	 *
+	 * There is one consumer. With ring_producers::single there is one producer; with ring_producers::multiple
+	 * any number of producers may push concurrently. Batches are pushed all or nothing.
+	 *
+	 * The ring does not own the memory; it must outlive the ring.
+	 */
+	template<Unit UnitType, ring_producers Producers = ring_producers::single>
+	class shared_quantity_ring
+	{
+	public:
+
+		using value_type = quantity<UnitType>;
+
+		static_assert(std::is_trivially_copyable_v<value_type>, "Only trivially copyable quantities can be shared between processes");
+
+		constexpr static const std::uint64_t fingerprint = unit_fingerprint<UnitType>();
+
+		/*!
+		 * Returns the number of bytes needed for a ring of capacity values. capacity must be a power of two.
+		 */
+		static constexpr std::size_t required_bytes(std::size_t capacity)
+		{
+			return detail::shared_ring_data_offset + capacity * sizeof(value_type);
+		}
+
+		/*!
+		 * Initialises a new ring in memory and returns a handle to it. Only one process should create the ring;
+		 * the others attach.
+		 *
+		 * @throws std::invalid_argument If capacity is not a power of two or the memory is too small or misaligned.
+		 */
+		static shared_quantity_ring create(void* memory, std::size_t bytes, std::size_t capacity)
+		{
+			if (!std::has_single_bit(capacity))
+				throw std::invalid_argument("shared ring capacity must be a power of two");
+			check_memory(memory, bytes, capacity);
+
+			auto* header = ::new (memory) detail::shared_ring_header{};
+			header->fingerprint = fingerprint;
+			header->value_size = sizeof(value_type);
+			header->producers = static_cast<std::uint32_t>(Producers);
+			header->capacity = capacity;
+			header->version = detail::shared_ring_version;
+			// The magic is written last, with release order, so a process attaching concurrently sees a whole header.
+			std::atomic_ref<std::uint32_t>{ header->magic }.store(detail::shared_ring_magic, std::memory_order_release);
+			return shared_quantity_ring{ header };
+		}
+
+		/*!
+		 * Attaches to a ring that another process created in memory.
+		 *
+		 * @throws std::invalid_argument If memory does not hold a ring, or the ring carries a different unit,
+		 * value size or producer mode.
+		 */
+		static shared_quantity_ring attach(void* memory, std::size_t bytes)
+		{
+			if (bytes < sizeof(detail::shared_ring_header))
+				throw std::invalid_argument("shared memory is too small for a ring header");
+			auto* header = static_cast<detail::shared_ring_header*>(memory);
+			if (std::atomic_ref<std::uint32_t>{ header->magic }.load(std::memory_order_acquire) != detail::shared_ring_magic || header->version != detail::shared_ring_version)
+				throw std::invalid_argument("shared memory does not hold a quantity ring");
+			if (header->fingerprint != fingerprint || header->value_size != sizeof(value_type))
+				throw std::invalid_argument("shared ring carries a different unit than " + std::string{ detail::type_name<UnitType>() });
+			if (header->producers != static_cast<std::uint32_t>(Producers))
+				throw std::invalid_argument("shared ring was created with a different producer mode");
+			check_memory(memory, bytes, static_cast<std::size_t>(header->capacity));
+			return shared_quantity_ring{ header };
+		}
+
+		std::size_t capacity() const { return capacity_; }
+
+		/*!
+		 * Copies values into the ring if there is room for all of them, and returns false otherwise.
+		 */
+		bool try_push(std::span<const value_type> values)
+		{
+			const std::uint64_t count = values.size();
+			if (count > capacity_)
+				return false;
+
+			std::uint64_t start;
+			if constexpr (Producers == ring_producers::single)
+			{
+				start = header_->claimed.load(std::memory_order_relaxed);
+				if (start + count - cached_consumed_ > capacity_)
+				{
+					cached_consumed_ = header_->consumed.load(std::memory_order_acquire);
+					if (start + count - cached_consumed_ > capacity_)
+						return false;
+				}
+				header_->claimed.store(start + count, std::memory_order_relaxed);
+			}
+			else
+			{
+				start = header_->claimed.load(std::memory_order_relaxed);
+				do
+				{
+					if (start + count - header_->consumed.load(std::memory_order_acquire) > capacity_)
+						return false;
+				} while (!header_->claimed.compare_exchange_weak(start, start + count, std::memory_order_relaxed));
+			}
+
+			copy_in(start, values);
+
+			if constexpr (Producers == ring_producers::multiple)
+			{
+				// Publish in claim order: wait for the producers that claimed earlier ranges.
+				while (header_->published.load(std::memory_order_acquire) != start)
+					std::this_thread::yield();
+			}
+			header_->published.store(start + count, std::memory_order_release);
+			return true;
+		}
+
+		/*!
+		 * Returns the values that are ready to read, in place in the shared memory. When the readable values wrap
+		 * around the end of the ring only the part up to the end is returned; call consume and then peek again
+		 * for the rest. Returns an empty span if nothing is ready. Must only be called by the consumer.
+		 */
+		std::span<const value_type> peek()
+		{
+			const std::uint64_t head = header_->consumed.load(std::memory_order_relaxed);
+			if (head == cached_published_)
+			{
+				cached_published_ = header_->published.load(std::memory_order_acquire);
+				if (head == cached_published_)
+					return {};
+			}
+			const std::size_t slot = static_cast<std::size_t>(head & (capacity_ - 1));
+			const std::size_t ready = static_cast<std::size_t>(cached_published_ - head);
+			return { data() + slot, std::min(ready, capacity_ - slot) };
+		}
+
+		/*!
+		 * Marks the first count values returned by peek as read, so producers can reuse their slots.
+		 */
+		void consume(std::size_t count)
+		{
+			const std::uint64_t head = header_->consumed.load(std::memory_order_relaxed);
+			header_->consumed.store(head + count, std::memory_order_release);
+		}
+
+		/*!
+		 * Returns true if the ring was empty at some point during the call.
+		 */
+		bool empty() const
+		{
+			return header_->consumed.load(std::memory_order_acquire) == header_->published.load(std::memory_order_acquire);
+		}
+
+	private:
+
+		// The cached indices start from the header, not 0: a handle attached to a ring that is already in use
+		// would otherwise read slots between 0 and the consumed index as if they had just been published.
+		explicit shared_quantity_ring(detail::shared_ring_header* header)
+			: header_{ header },
+			  capacity_{ static_cast<std::size_t>(header->capacity) },
+			  cached_consumed_{ header->consumed.load(std::memory_order_acquire) },
+			  cached_published_{ header->published.load(std::memory_order_acquire) }
+		{}
+
+		static void check_memory(void* memory, std::size_t bytes, std::size_t capacity)
+		{
+			if (reinterpret_cast<std::uintptr_t>(memory) % detail::cache_line_size != 0)
+				throw std::invalid_argument("shared ring memory must be aligned to a cache line");
+			if (!std::has_single_bit(capacity) || bytes < required_bytes(capacity))
+				throw std::invalid_argument("shared memory is too small for the ring");
+		}
+
+		value_type* data() const
+		{
+			return reinterpret_cast<value_type*>(reinterpret_cast<std::byte*>(header_) + detail::shared_ring_data_offset);
+		}
+
+		void copy_in(std::uint64_t start, std::span<const value_type> values)
+		{
+			const std::size_t slot = static_cast<std::size_t>(start & (capacity_ - 1));
+			const std::size_t first = std::min(values.size(), capacity_ - slot);
+			std::copy_n(values.data(), first, data() + slot);
+			std::copy_n(values.data() + first, values.size() - first, data());
+		}
+
+		detail::shared_ring_header* header_;
+		std::size_t capacity_;
+		std::uint64_t cached_consumed_;
+		std::uint64_t cached_published_;
+	};
+
+#ifdef CPP_UNITS_HAS_POSIX_SHARED_MEMORY
+	/*!
+	 * A POSIX shared memory object (shm_open) mapped into this process. The creator passes a size; other
+	 * processes open it by name and map the whole object. The mapping is removed on destruction, but the
+	 * object stays until unlink is called.
+	 */
+	class shared_memory_region
+	{
+	public:
+
+		/*!
+		 * Creates the shared memory object name with the given size. Fails if it already exists.
+		 *
+		 * @throws std::system_error If the object cannot be created or mapped.
+		 */
+		static shared_memory_region create(std::string const& name, std::size_t bytes)
+		{
+			const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+			if (fd < 0)
+				throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+			if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+			{
+				const int error = errno;
+				::close(fd);
+				::shm_unlink(name.c_str());
+				throw std::system_error(error, std::generic_category(), "ftruncate " + name);
+			}
+			return shared_memory_region{ fd, bytes, name };
+		}
+
+		/*!
+		 * Opens and maps an existing shared memory object.
+		 *
+		 * @throws std::system_error If the object does not exist or cannot be mapped.
+		 */
+		static shared_memory_region open(std::string const& name)
+		{
+			const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+			if (fd < 0)
+				throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+			struct stat info {};
+			if (::fstat(fd, &info) != 0)
+			{
+				const int error = errno;
+				::close(fd);
+				throw std::system_error(error, std::generic_category(), "fstat " + name);
+			}
+			return shared_memory_region{ fd, static_cast<std::size_t>(info.st_size), name };
+		}
+
+		//! Removes the shared memory object name. Existing mappings stay valid.
+		static void unlink(std::string const& name)
+		{
+			::shm_unlink(name.c_str());
+		}
+
+		shared_memory_region(shared_memory_region const&) = delete;
+		shared_memory_region& operator=(shared_memory_region const&) = delete;
+
+		shared_memory_region(shared_memory_region&& other) noexcept
+			: data_{ std::exchange(other.data_, nullptr) }, size_{ std::exchange(other.size_, 0) }
+		{}
+
+		shared_memory_region& operator=(shared_memory_region&& other) noexcept
+		{
+			if (this != &other)
+			{
+				unmap();
+				data_ = std::exchange(other.data_, nullptr);
+				size_ = std::exchange(other.size_, 0);
+			}
+			return *this;
+		}
+
+		~shared_memory_region()
+		{
+			unmap();
+		}
+
+		void* data() const { return data_; }
+		std::size_t size() const { return size_; }
+
+	private:
+
+		shared_memory_region(int fd, std::size_t bytes, std::string const& name)
+			: size_{ bytes }
+		{
+			void* mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			const int error = errno;
+			::close(fd);
+			if (mapped == MAP_FAILED)
+				throw std::system_error(error, std::generic_category(), "mmap " + name);
+			data_ = mapped;
+		}
+
+		void unmap()
+		{
+			if (data_)
+				::munmap(data_, size_);
+			data_ = nullptr;
+		}
+
+		void* data_ = nullptr;
+		std::size_t size_ = 0;
+	};
+#endif
+}
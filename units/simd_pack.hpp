@@ -0,0 +1,252 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "units.hpp"
+#include "unit_conversion.hpp"
+#include "quantity.hpp"
+
+namespace units
+{
+	namespace detail
+	{
+		//! Width of the default simd_pack, in bytes. 32 bytes matches AVX registers and is two SSE/NEON registers.
+		constexpr const std::size_t simd_pack_bytes = 32;
+	}
+
+	/*!
+	 * simd_pack is a fixed number of lanes of an arithmetic type that behaves like a single number:
+	 * every arithmetic operator works lane by lane, and a scalar converts implicitly by broadcasting to
+	 * every lane. This is what lets simd_pack be the value_type of a unit system, for example
+	 * @code
+	 * using vsi = si_system_t<simd_pack<double>>;
+	 * quantity<vsi::velocity> v = ...;
+	 * @endcode
+	 * after which the operators in quantity.hpp and the conversions in unit_conversion.hpp run on N values at once.
+	 *
+	 * The lanes are an aligned array and each operator is a fixed-length loop, which compilers turn into
+	 * vector instructions at -O2 and above. std::experimental::simd is not used because it is not available
+	 * on every supported compiler.
+	 *
+	 * == is true when every lane is equal, and so is == between quantities of packs. Ordering comparisons
+	 * are not defined, since a pack has no single ordering, and <, <=> and the other orderings on
+	 * quantities of packs drop out of overload resolution; use min and max, or compare lanes individually.
+	 *
+	 * @tparam T The lane type. Must be arithmetic.
+	 * @tparam N The number of lanes. Defaults to as many as fit in 32 bytes.
+	 */
+	template<class T, std::size_t N = detail::simd_pack_bytes / sizeof(T)>
+	requires std::is_arithmetic_v<T>
+	class alignas(std::has_single_bit(sizeof(T) * N) ? sizeof(T) * N : alignof(T)) simd_pack
+	{
+	public:
+
+		using value_type = T;
+
+		constexpr static const std::size_t size = N;
+
+		constexpr simd_pack() = default;
+
+		//! Broadcasts value to every lane.
+		constexpr simd_pack(T value)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+				lanes_[i] = value;
+		}
+
+		/*!
+		 * Loads N values starting at data. data does not need to be aligned.
+		 */
+		constexpr static simd_pack load(const T* data)
+		{
+			simd_pack result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.lanes_[i] = data[i];
+			return result;
+		}
+
+		/*!
+		 * Stores the N lanes starting at data. data does not need to be aligned.
+		 */
+		constexpr void store(T* data) const
+		{
+			for (std::size_t i = 0; i < N; ++i)
+				data[i] = lanes_[i];
+		}
+
+		constexpr T operator[](std::size_t i) const { return lanes_[i]; }
+		constexpr T& operator[](std::size_t i) { return lanes_[i]; }
+
+		constexpr simd_pack operator-() const
+		{
+			simd_pack result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.lanes_[i] = -lanes_[i];
+			return result;
+		}
+
+#define CPP_UNITS_SIMD_PACK_OPERATOR(op) \
+		constexpr simd_pack& operator op##=(simd_pack const& other) \
+		{ \
+			for (std::size_t i = 0; i < N; ++i) \
+				lanes_[i] op##= other.lanes_[i]; \
+			return *this; \
+		} \
+		friend constexpr simd_pack operator op(simd_pack a, simd_pack const& b) { return a op##= b; } \
+		template<class Scalar> requires std::is_arithmetic_v<Scalar> \
+		friend constexpr simd_pack operator op(simd_pack a, Scalar b) { return a op##= simd_pack{ static_cast<T>(b) }; } \
+		template<class Scalar> requires std::is_arithmetic_v<Scalar> \
+		friend constexpr simd_pack operator op(Scalar a, simd_pack const& b) { return simd_pack{ static_cast<T>(a) } op##= b; }
+
+		CPP_UNITS_SIMD_PACK_OPERATOR(+)
+		CPP_UNITS_SIMD_PACK_OPERATOR(-)
+		CPP_UNITS_SIMD_PACK_OPERATOR(*)
+		CPP_UNITS_SIMD_PACK_OPERATOR(/)
+
+#undef CPP_UNITS_SIMD_PACK_OPERATOR
+
+		//! True if every lane is equal.
+		friend constexpr bool operator==(simd_pack const& a, simd_pack const& b)
+		{
+			bool equal = true;
+			for (std::size_t i = 0; i < N; ++i)
+				equal &= a.lanes_[i] == b.lanes_[i];
+			return equal;
+		}
+
+		friend constexpr simd_pack min(simd_pack const& a, simd_pack const& b)
+		{
+			simd_pack result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.lanes_[i] = b.lanes_[i] < a.lanes_[i] ? b.lanes_[i] : a.lanes_[i];
+			return result;
+		}
+
+		friend constexpr simd_pack max(simd_pack const& a, simd_pack const& b)
+		{
+			simd_pack result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.lanes_[i] = a.lanes_[i] < b.lanes_[i] ? b.lanes_[i] : a.lanes_[i];
+			return result;
+		}
+
+		friend constexpr simd_pack abs(simd_pack const& a)
+		{
+			simd_pack result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.lanes_[i] = a.lanes_[i] < T{} ? -a.lanes_[i] : a.lanes_[i];
+			return result;
+		}
+
+		friend simd_pack sqrt(simd_pack const& a)
+		{
+			simd_pack result;
+			for (std::size_t i = 0; i < N; ++i)
+				result.lanes_[i] = static_cast<T>(std::sqrt(a.lanes_[i]));
+			return result;
+		}
+
+		//! Returns the sum of the lanes.
+		friend constexpr T reduce(simd_pack const& a)
+		{
+			T sum{};
+			for (std::size_t i = 0; i < N; ++i)
+				sum += a.lanes_[i];
+			return sum;
+		}
+
+	private:
+
+		T lanes_[N]{};
+	};
+
+	namespace detail
+	{
+		template<class T>
+		struct is_simd_pack : std::false_type {};
+
+		template<class T, std::size_t N>
+		struct is_simd_pack<simd_pack<T, N>> : std::true_type {};
+	}
+
+	/*!
+	 * Loads simd_pack lanes from a span of scalar quantities, starting at offset, and converts them to PackUnit.
+	 * ScalarUnit and PackUnit must be SimilarUnits; they usually come from the same unit system with
+	 * different value types. Exact scale conversions are applied to the whole pack; anything else
+	 * (offset units) goes through the fundamental unit lane by lane.
+	 *
+	 * @throws std::out_of_range If fewer than a full pack of values remain after offset.
+	 */
+	template<Unit PackUnit, Unit ScalarUnit>
+	requires detail::is_simd_pack<typename PackUnit::value_type>::value && SimilarUnits<PackUnit, ScalarUnit>
+	constexpr quantity<PackUnit> load_pack(std::span<const quantity<ScalarUnit>> values, std::size_t offset)
+	{
+		using pack = typename PackUnit::value_type;
+		using lane = typename pack::value_type;
+		if (offset + pack::size > values.size())
+			throw std::out_of_range("load_pack reads past the end of the span");
+
+		constexpr detail::scale_factor factor = detail::divide(unit_scale_v<ScalarUnit>, unit_scale_v<PackUnit>);
+		pack raw;
+		if constexpr (factor.exact)
+		{
+			for (std::size_t i = 0; i < pack::size; ++i)
+				raw[i] = static_cast<lane>(values[offset + i].value());
+			return quantity<PackUnit>{ detail::apply_scale<factor.num, factor.den>(raw) };
+		}
+		else
+		{
+			for (std::size_t i = 0; i < pack::size; ++i)
+				raw[i] = static_cast<lane>(ScalarUnit::to_fundamental(values[offset + i].value()));
+			return quantity<PackUnit>{ PackUnit::from_fundamental(raw) };
+		}
+	}
+
+	/*!
+	 * Stores the lanes of value into a span of scalar quantities, starting at offset, converting them to ScalarUnit.
+	 *
+	 * @throws std::out_of_range If fewer than a full pack of values remain after offset.
+	 */
+	template<Unit PackUnit, Unit ScalarUnit>
+	requires detail::is_simd_pack<typename PackUnit::value_type>::value && SimilarUnits<PackUnit, ScalarUnit>
+	constexpr void store_pack(quantity<PackUnit> value, std::span<quantity<ScalarUnit>> values, std::size_t offset)
+	{
+		using pack = typename PackUnit::value_type;
+		using scalar = typename ScalarUnit::value_type;
+		if (offset + pack::size > values.size())
+			throw std::out_of_range("store_pack writes past the end of the span");
+
+		constexpr detail::scale_factor factor = detail::divide(unit_scale_v<PackUnit>, unit_scale_v<ScalarUnit>);
+		if constexpr (factor.exact)
+		{
+			const pack raw = detail::apply_scale<factor.num, factor.den>(value.value());
+			for (std::size_t i = 0; i < pack::size; ++i)
+				values[offset + i] = quantity<ScalarUnit>{ static_cast<scalar>(raw[i]) };
+		}
+		else
+		{
+			const pack raw = PackUnit::to_fundamental(value.value());
+			for (std::size_t i = 0; i < pack::size; ++i)
+				values[offset + i] = quantity<ScalarUnit>{ ScalarUnit::from_fundamental(static_cast<scalar>(raw[i])) };
+		}
+	}
+}
+
+/*!
+ * std::common_type specializations, so that unit_conversion between a pack unit and a scalar unit
+ * (or two pack units) has a pack value_type.
+ */
+template<class T, std::size_t N>
+struct std::common_type<units::simd_pack<T, N>, T>
+{
+	using type = units::simd_pack<T, N>;
+};
+
+template<class T, std::size_t N>
+struct std::common_type<T, units::simd_pack<T, N>>
+{
+	using type = units::simd_pack<T, N>;
+};
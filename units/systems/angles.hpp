@@ -0,0 +1,76 @@
+#pragma once
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include "../units.hpp"
+#include "../fundamental_unit.hpp"
+#include "../linear_unit.hpp"
+#include "../quantity.hpp"
+#include "../quantized_unit.hpp"
+
+namespace units
+{
+	namespace angle_system
+	{
+		/*!
+		 * The plane angle is its own dimension here, with the turn as its fundamental unit: degrees, gradians
+		 * and binary angles are exact fractions of a turn, so they convert to each other exactly, and only
+		 * the radian needs an irrational factor. The si treats the radian as dimensionless, which would let
+		 * an angle be added to a ratio; this keeps them apart.
+		 */
+		namespace tags
+		{
+			struct turn : fundamental_unit<turn, double> {};
+		}
+
+		//! 2 pi radians per turn, as a scaled_unit ratio. It is not a std::ratio, so the scale is inexact.
+		struct radians_per_turn
+		{
+			template<class value_type>
+			constexpr static value_type apply(value_type value)
+			{
+				return value * static_cast<value_type>(2.0 * std::numbers::pi);
+			}
+
+			template<class value_type>
+			constexpr static value_type apply_inverse(value_type value)
+			{
+				return value / static_cast<value_type>(2.0 * std::numbers::pi);
+			}
+		};
+
+		template<class ValueType>
+		struct angle_unit_system
+		{
+			struct turn : fundamental_unit<tags::turn, ValueType> {};
+
+			using degree = scaled_unit<turn, ratio<360>>;
+			using arcminute = scaled_unit<degree, ratio<60>>;
+			using arcsecond = scaled_unit<arcminute, ratio<60>>;
+			using gradian = scaled_unit<turn, ratio<400>>;
+			using radian = scaled_unit<turn, radians_per_turn>;
+
+			using plane_angle = radian;
+
+			/*!
+			 * Binary angle measurement: a full turn is 2^N ticks of an unsigned N-bit integer, so angles wrap
+			 * at a full turn by integer overflow. Convert to them with quantize<..., overflow_policy::wrap>.
+			 */
+			template<std::unsigned_integral Storage>
+			requires (std::numeric_limits<Storage>::digits <= 32)
+			using binary_angle = quantized_unit<turn, ratio<std::intmax_t{ 1 } << std::numeric_limits<Storage>::digits>, Storage>;
+		};
+	}
+
+	template<class ValueType>
+	using angle_system_t = angle_system::angle_unit_system<ValueType>;
+
+	using angles = angle_system_t<double>;
+
+	/*!
+	 * AngleUnit concept. Satisfied by any unit of plane angle.
+	 */
+	template<class T>
+	concept AngleUnit = Unit<T> && SimilarUnits<T, angles::turn>;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include "../units.hpp"
+#include "../fundamental_unit.hpp"
+#include "../exponent_unit.hpp"
+#include "../quantity.hpp"
+#include "../compound_unit.hpp"
+#include "../linear_unit.hpp"
+#include "si.hpp"
+
+namespace units
+{
+	namespace data_system
+	{
+		/*!
+		 * Units of information and data rates. The fundamental unit is the bit, so every
+		 * other unit in this system is an exact multiple of it and conversions on integer
+		 * value types never round through floating point. Binary multiples are made with the
+		 * IEC prefixes (kibi, mebi, gibi, ...) and decimal ones with the metric prefixes.
+		 * For example, using gibibyte = kibi<mebi<byte>>; is the same scale as gibi<byte>.
+		 */
+		template<class ValueType>
+		struct data_unit_system
+		{
+			struct bit : fundamental_unit<bit, ValueType> {};
+			struct packet : fundamental_unit<packet, ValueType> {};
+
+			using byte = scaled_unit<bit, ratio<1, 8>>;
+			using second = typename si_system_t<ValueType>::second;
+
+			using information = bit;
+			using time = second;
+			using frequency = inverse_unit<second>;
+
+			using bit_rate = make_compound_t<bit, frequency>;
+			using byte_rate = make_compound_t<byte, frequency>;
+			using packet_rate = make_compound_t<packet, frequency>;
+		};
+	}
+
+	template<class ValueType>
+	using data_system_t = data_system::data_unit_system<ValueType>;
+
+	using data = data_system_t<std::uint64_t>;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "../units.hpp"
+#include "../fundamental_unit.hpp"
+#include "../exponent_unit.hpp"
+#include "../quantity.hpp"
+#include "../compound_unit.hpp"
+#include "../linear_unit.hpp"
+#include "../unit_system.hpp"
+#include "si.hpp"
+
+namespace units
+{
+	namespace imperial_system
+	{
+		/*!
+		 * 0 fahrenheit is 459.67 rankine, and linear_unit subtracts the offset before scaling to kelvin.
+		 */
+		template<class ValueType>
+		struct fahrenheit_offset_type
+		{
+			constexpr static const ValueType value = static_cast<ValueType>(-459.67);
+		};
+
+		/*!
+		 * Imperial and US customary units. The base units are exact scalings of the si base units, using
+		 * the international yard and pound (1 foot = 0.3048 m, 1 pound = 0.45359237 kg), so they share the
+		 * si unit_tags and every conversion to or from si folds to one rational constant.
+		 * The second, ampere, mole and candela are the si units.
+		 */
+		template<class ValueType>
+		struct imperial_unit_system
+		{
+			using si_units = si_system_t<ValueType>;
+
+			using foot = scaled_unit<typename si_units::meter, ratio<1250, 381>>;
+			using inch = scaled_unit<foot, ratio<12>>;
+			using yard = scaled_unit<foot, ratio<1, 3>>;
+			using mile = scaled_unit<foot, ratio<1, 5280>>;
+
+			using pound = scaled_unit<typename si_units::kilogram, ratio<100000000, 45359237>>;
+			using ounce = scaled_unit<pound, ratio<16>>;
+			//! One slug is the mass accelerated at 1 ft/s^2 by one pound-force: standard gravity (9.80665 m/s^2) in pounds.
+			using slug = scaled_unit<pound, ratio<6096, 196133>>;
+
+			using second = typename si_units::second;
+			using ampere = typename si_units::ampere;
+			using mole = typename si_units::mole;
+			using candela = typename si_units::candela;
+
+			using rankine = scaled_unit<typename si_units::kelvin, ratio<9, 5>>;
+			using fahrenheit = linear_unit<typename si_units::kelvin, ratio<9, 5>, fahrenheit_offset_type<ValueType>>;
+
+			using length = foot;
+			using mass = pound;
+			using time = second;
+			using current = ampere;
+			using temperature = rankine;
+			using amount = mole;
+			using luminosity = candela;
+
+			using pound_force = make_compound_t<slug, make_compound_t<foot, make_exponent_t<second, -2>>>;
+			using foot_pound = make_compound_t<pound_force, foot>;
+			using psi = make_compound_t<pound_force, make_exponent_t<inch, -2>>;
+			using miles_per_hour = make_compound_t<mile, inverse_unit<scaled_unit<second, ratio<1, 3600>>>>;
+		};
+	}
+
+	template<class ValueType>
+	using imperial_system_t = unit_system<imperial_system::imperial_unit_system<ValueType>>;
+
+	using imperial = imperial_system_t<double>;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "../units.hpp"
+#include "../exponent_unit.hpp"
+#include "../compound_unit.hpp"
+#include "../logarithmic_unit.hpp"
+#include "si.hpp"
+
+namespace units
+{
+	namespace level_system
+	{
+		template<class ValueType>
+		struct unit_reference
+		{
+			constexpr static const ValueType value = ValueType{ 1 };
+		};
+
+		//! The reference is a double whatever ValueType is, since 0.001 has no integer representation.
+		template<class ValueType>
+		struct milli_reference
+		{
+			constexpr static const double value = 0.001;
+		};
+
+		//! One mole per litre, in moles per cubic meter.
+		template<class ValueType>
+		struct molar_reference
+		{
+			constexpr static const ValueType value = ValueType{ 1000 };
+		};
+
+		/*!
+		 * Common logarithmic units, built on the si system. Levels of power use the power decibel (10 log10),
+		 * levels of voltage use the field decibel (20 log10) and the neper. A gain is the delta of a level,
+		 * so a 3 dB amplifier applied to a signal is quantity<dBm> + delta<dBm>{ 3 }.
+		 */
+		template<class ValueType>
+		struct level_unit_system
+		{
+			using si_units = si_system_t<ValueType>;
+
+			using watt = typename si_units::power;
+			using volt = make_compound_t<watt, inverse_unit<typename si_units::ampere>>;
+			using molar = make_compound_t<typename si_units::mole, inverse_unit<make_exponent_t<typename si_units::meter, 3>>>;
+
+			using dBW = logarithmic_unit<watt, unit_reference<ValueType>, log_scales::decibel_power>;
+			using dBm = logarithmic_unit<watt, milli_reference<ValueType>, log_scales::decibel_power>;
+			using dBV = logarithmic_unit<volt, unit_reference<ValueType>, log_scales::decibel_field>;
+			using neper = logarithmic_unit<volt, unit_reference<ValueType>, log_scales::neper>;
+			using pH = logarithmic_unit<molar, molar_reference<ValueType>, log_scales::p_function>;
+		};
+	}
+
+	template<class ValueType>
+	using level_system_t = level_system::level_unit_system<ValueType>;
+
+	using levels = level_system_t<double>;
+}
@@ -12,22 +12,42 @@ namespace units
 {
 	namespace si_system
 	{
+		/*!
+		 * offset_unit subtracts the offset on the way to the fundamental unit, so celsius is offset by
+		 * -273.15: 0 celsius is 273.15 kelvin.
+		 */
 		template<class ValueType>
 		struct celsius_offset_type
 		{
-			constexpr static const ValueType value = ValueType{ 273.15 };
+			constexpr static const ValueType value = static_cast<ValueType>(-273.15);
 		};
 
+		/*!
+		 * The unit_tags of the si base units. Tags must themselves be units, so these are the double
+		 * fundamental units. They are shared by every value_type, so si_system_t<float>::meter and
+		 * si_system_t<double>::meter are SimilarUnits and convert to each other.
+		 */
+		namespace tags
+		{
+			struct meter : fundamental_unit<meter, double> {};
+			struct kilogram : fundamental_unit<kilogram, double> {};
+			struct second : fundamental_unit<second, double> {};
+			struct ampere : fundamental_unit<ampere, double> {};
+			struct kelvin : fundamental_unit<kelvin, double> {};
+			struct mole : fundamental_unit<mole, double> {};
+			struct candela : fundamental_unit<candela, double> {};
+		}
+
 		template<class ValueType>
 		struct si_unit_system
 		{
-			struct meter : fundamental_unit<meter, ValueType> {};
-			struct kilogram : fundamental_unit<kilogram, ValueType> {};
-			struct second : fundamental_unit<second, ValueType> {};
-			struct ampere : fundamental_unit<ampere, ValueType> {};
-			struct kelvin : fundamental_unit<kelvin, ValueType> {};
-			struct mole : fundamental_unit<mole, ValueType> {};
-			struct candela : fundamental_unit<candela, ValueType> {};
+			struct meter : fundamental_unit<tags::meter, ValueType> {};
+			struct kilogram : fundamental_unit<tags::kilogram, ValueType> {};
+			struct second : fundamental_unit<tags::second, ValueType> {};
+			struct ampere : fundamental_unit<tags::ampere, ValueType> {};
+			struct kelvin : fundamental_unit<tags::kelvin, ValueType> {};
+			struct mole : fundamental_unit<tags::mole, ValueType> {};
+			struct candela : fundamental_unit<tags::candela, ValueType> {};
 
 			using length = meter;
 			using mass = kilogram;
@@ -0,0 +1,58 @@
+#pragma once
+#include "../units.hpp"
+#include "../compound_unit.hpp"
+#include "../constant_quantity.hpp"
+#include "si.hpp"
+
+namespace units
+{
+	namespace si_system
+	{
+		/*!
+		 * The seven defining constants of the si, with their exact values, and constants derived from them.
+		 * Each is a constant_quantity type, so it takes no storage and multiplies into expressions at
+		 * compile time. The derived constants are products of the defining ones, and are constants themselves.
+		 */
+		template<class ValueType>
+		struct si_constant_system
+		{
+			using si_units = si_system_t<ValueType>;
+
+			using hyperfine_transition_frequency = constant_quantity<typename si_units::frequency, static_cast<ValueType>(9192631770.0)>;
+			using speed_of_light = constant_quantity<typename si_units::velocity, static_cast<ValueType>(299792458.0)>;
+			using planck = constant_quantity<make_compound_t<typename si_units::energy, typename si_units::second>, static_cast<ValueType>(6.62607015e-34)>;
+			using elementary_charge = constant_quantity<make_compound_t<typename si_units::ampere, typename si_units::second>, static_cast<ValueType>(1.602176634e-19)>;
+			using boltzmann = constant_quantity<make_compound_t<typename si_units::energy, inverse_unit<typename si_units::kelvin>>, static_cast<ValueType>(1.380649e-23)>;
+			using avogadro = constant_quantity<inverse_unit<typename si_units::mole>, static_cast<ValueType>(6.02214076e23)>;
+			//! Lumens per watt; the steradian is dimensionless, so this is candela per watt.
+			using luminous_efficacy = constant_quantity<make_compound_t<typename si_units::candela, make_inverse_t<typename si_units::power>>, static_cast<ValueType>(683.0)>;
+
+			using molar_gas = decltype(avogadro{} * boltzmann{});
+			using faraday = decltype(avogadro{} * elementary_charge{});
+			//! Standard gravity, exact by the definition of the kilogram-force.
+			using standard_gravity = constant_quantity<typename si_units::acceleration, static_cast<ValueType>(9.80665)>;
+		};
+	}
+
+	template<class ValueType>
+	using si_constants_t = si_system::si_constant_system<ValueType>;
+
+	/*!
+	 * The si constants with double values, as objects: E = m * c * c with si_constants::c.
+	 */
+	namespace si_constants
+	{
+		using constants = si_constants_t<double>;
+
+		constexpr inline constants::hyperfine_transition_frequency delta_nu_cs{};
+		constexpr inline constants::speed_of_light c{};
+		constexpr inline constants::planck h{};
+		constexpr inline constants::elementary_charge e{};
+		constexpr inline constants::boltzmann k_b{};
+		constexpr inline constants::avogadro n_a{};
+		constexpr inline constants::luminous_efficacy k_cd{};
+		constexpr inline constants::molar_gas r{};
+		constexpr inline constants::faraday f{};
+		constexpr inline constants::standard_gravity g_n{};
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "../units.hpp"
+#include "../compound_unit.hpp"
+#include "../exponent_unit.hpp"
+#include "../linear_unit.hpp"
+#include "../constant_quantity.hpp"
+#include "../polynomial_unit.hpp"
+#include "si.hpp"
+
+namespace units
+{
+	namespace thermocouple_system
+	{
+		/*!
+		 * Thermocouple readings as temperatures, from the NIST ITS-90 thermocouple database. A reading is the
+		 * thermoelectric voltage in millivolts with the reference junction at 0 celsius, so a cold-junction
+		 * compensated reading converts straight to a temperature:
+		 * @code
+		 * quantity<si::kelvin> t{ quantity<thermocouples::type_k>{ 4.096 } };
+		 * @endcode
+		 * The curves are the ITS-90 inverse polynomials, accurate to within 0.06 celsius of the reference
+		 * tables on their range. Temperatures convert back to readings by solving the curve (see
+		 * polynomial_unit), which matches the reference functions to the same accuracy.
+		 */
+		template<class ValueType>
+		struct thermocouple_unit_system
+		{
+			using si_units = si_system_t<ValueType>;
+
+			using volt = make_compound_t<typename si_units::power, inverse_unit<typename si_units::ampere>>;
+			using millivolt = prefixes::milli<volt>;
+			using celsius = typename si_units::celsius;
+
+			//! Type K (chromel-alumel), -200 to 1372 celsius.
+			using type_k_curve = piecewise_polynomial<
+				polynomial_range<make_polynomial_t<millivolt, celsius,
+					0.0, 2.5173462e1, -1.1662878, -1.0833638, -8.9773540e-1, -3.7342377e-1, -8.6632643e-2, -1.0450598e-2, -5.1920577e-4>,
+					constant_quantity<millivolt, ValueType(-5.891)>, constant_quantity<millivolt, ValueType(0)>>,
+				polynomial_range<make_polynomial_t<millivolt, celsius,
+					0.0, 2.508355e1, 7.860106e-2, -2.503131e-1, 8.315270e-2, -1.228034e-2, 9.804036e-4, -4.413030e-5, 1.057734e-6, -1.052755e-8>,
+					constant_quantity<millivolt, ValueType(0)>, constant_quantity<millivolt, ValueType(20.644)>>,
+				polynomial_range<make_polynomial_t<millivolt, celsius,
+					-1.318058e2, 4.830222e1, -1.646031, 5.464731e-2, -9.650715e-4, 8.802193e-6, -3.110810e-8>,
+					constant_quantity<millivolt, ValueType(20.644)>, constant_quantity<millivolt, ValueType(54.886)>>>;
+
+			using type_k = polynomial_unit<type_k_curve>;
+		};
+	}
+
+	template<class ValueType>
+	using thermocouple_system_t = thermocouple_system::thermocouple_unit_system<ValueType>;
+
+	using thermocouples = thermocouple_system_t<double>;
+}
@@ -0,0 +1,226 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "unit_conversion.hpp"
+#include "quantized_unit.hpp"
+#include "systems/angles.hpp"
+
+namespace units
+{
+	/*!
+	 * The sine and cosine of one angle, as returned by sincos.
+	 */
+	struct sin_cos
+	{
+		double sin = 0.0;
+		double cos = 1.0;
+	};
+
+	namespace detail
+	{
+		/*!
+		 * sin and cos of r in radians, |r| <= pi / 4, turned by quadrant quarter turns (quadrant is an
+		 * integer-valued double). The polynomials are the Taylor series to r^15 and r^16, whose truncation
+		 * error on [-pi/4, pi/4] is below 5e-17. The quadrant is applied with selects, so loops vectorise.
+		 */
+		inline sin_cos sin_cos_reduced(double r, double quadrant)
+		{
+			const double r2 = r * r;
+			double s = -1.0 / 1307674368000.0;
+			s = s * r2 + 1.0 / 6227020800.0;
+			s = s * r2 - 1.0 / 39916800.0;
+			s = s * r2 + 1.0 / 362880.0;
+			s = s * r2 - 1.0 / 5040.0;
+			s = s * r2 + 1.0 / 120.0;
+			s = s * r2 - 1.0 / 6.0;
+			s = r + r * r2 * s;
+
+			double c = 1.0 / 20922789888000.0;
+			c = c * r2 - 1.0 / 87178291200.0;
+			c = c * r2 + 1.0 / 479001600.0;
+			c = c * r2 - 1.0 / 3628800.0;
+			c = c * r2 + 1.0 / 40320.0;
+			c = c * r2 - 1.0 / 720.0;
+			c = c * r2 + 1.0 / 24.0;
+			c = c * r2 - 0.5;
+			c = 1.0 + r2 * c;
+
+			// quadrant mod 4 in {-2, -1, 0, 1, 2}; nearbyint vectorises where floor does not.
+			const double q = quadrant - 4.0 * std::nearbyint(quadrant * 0.25);
+			const bool odd = q == 1.0 || q == -1.0;
+			const double sin = odd ? c : s;
+			const double cos = odd ? s : c;
+			return { (q >= 2.0 || q < 0.0) ? -sin : sin, (q >= 1.0 || q <= -2.0) ? -cos : cos };
+		}
+
+		/*!
+		 * Reduces an angle in Angle to a quadrant and a remainder in radians, folding the unit scale into
+		 * the reduction:
+		 * - binary angles reduce in integers, exactly;
+		 * - units that are an exact fraction of a turn (degrees, turns, gradians) reduce in their own unit,
+		 *   where the quarter turn is exact, and scale the remainder to radians with one multiply;
+		 * - radians reduce with pi / 2 split in three (Cody-Waite), exact for |x| below about 2^20 pi / 2;
+		 *   other units are scaled to radians first.
+		 */
+		template<AngleUnit Angle>
+		inline sin_cos fast_sin_cos(typename Angle::value_type x)
+		{
+			using turn = angles::turn;
+			using conversion = unit_conversion<Angle, turn>;
+			if constexpr (is_quantized_unit<Angle>::value && std::is_unsigned_v<typename Angle::value_type>
+				&& conversion::factor.exact && conversion::factor.num == 1 && std::has_single_bit(static_cast<std::uintmax_t>(conversion::factor.den))
+				&& conversion::factor.den >= 4 && conversion::factor.den <= (std::intmax_t{ 1 } << 32))
+			{
+				// Scaled to a 32-bit binary angle, where the wrap at a full turn is unsigned overflow and the
+				// quadrant is the top two bits, rounded; 32-bit integers convert to double in vector registers.
+				constexpr int bits = std::countr_zero(static_cast<std::uintmax_t>(conversion::factor.den));
+				const std::uint32_t ticks = static_cast<std::uint32_t>(static_cast<std::uint64_t>(x) << (32 - bits));
+				const std::uint32_t quadrant = (ticks + (std::uint32_t{ 1 } << 29)) >> 30;
+				const auto remainder = static_cast<std::int32_t>(ticks - (quadrant << 30));
+				constexpr double to_radians = 2.0 * std::numbers::pi / 4294967296.0;
+				return sin_cos_reduced(static_cast<double>(remainder) * to_radians, static_cast<double>(static_cast<std::int32_t>(quadrant)));
+			}
+			else if constexpr (conversion::factor.exact)
+			{
+				constexpr double per_turn = static_cast<double>(conversion::factor.den) / static_cast<double>(conversion::factor.num);
+				constexpr double quarter = per_turn / 4.0;
+				constexpr double per_quarter = 4.0 / per_turn;
+				constexpr double to_radians = 2.0 * std::numbers::pi / per_turn;
+				const double value = static_cast<double>(x);
+				const double quadrant = std::nearbyint(value * per_quarter);
+				return sin_cos_reduced((value - quadrant * quarter) * to_radians, quadrant);
+			}
+			else
+			{
+				constexpr double to_radians = affine_conversion<Angle, angles::radian>().scale;
+				const double value = static_cast<double>(x) * to_radians;
+				const double quadrant = std::nearbyint(value * (2.0 / std::numbers::pi));
+				double r = value - quadrant * 1.57079632673412561417e+00;
+				r -= quadrant * 6.07710050630396597660e-11;
+				r -= quadrant * 2.02226624879595063154e-21;
+				return sin_cos_reduced(r, quadrant);
+			}
+		}
+
+		template<class Q>
+		concept AngleQuantity = QuantityOrDelta<Q> && AngleUnit<typename Q::unit_type>;
+	}
+
+	/*!
+	 * sin and cos of an angle in any unit. The unit scale is folded into the argument reduction (see
+	 * detail::fast_sin_cos), so a heading in degrees is never converted to radians first, and quarter
+	 * turns give exact results: sin of 180 degrees is 0, not 1.2e-16.
+	 *
+	 * Accuracy, measured against a reference that reduces the argument exactly (modulo 360 for degrees):
+	 * - degrees, turns and gradians: within 2.5e-16 absolute for |angle| up to 1e7 in the angle's own unit,
+	 *   the range tested. The reduction stays exact while the quadrant times the quarter turn is exact
+	 *   (below 2^53 quarter turns), so the bound is expected to hold beyond that, but it is not measured.
+	 * - binary angles: within 2.5e-16 absolute over their whole range.
+	 * - radians: within 2.5e-16 absolute for |angle| up to 1e6. Beyond about 1.6e6 the three-part pi / 2 is
+	 *   no longer exact; the error grows to about 1e-9 at 1e7, and std::sin should be used.
+	 *
+	 * A reference such as sinl(x * pi / 180) is itself off by about 1e-14 at 1e7 degrees, because the product
+	 * is rounded before the reduction. NaN and infinite inputs give meaningless results.
+	 */
+	template<detail::AngleQuantity Angle>
+	inline sin_cos sincos(Angle angle)
+	{
+		return detail::fast_sin_cos<typename Angle::unit_type>(angle.value());
+	}
+
+	template<detail::AngleQuantity Angle>
+	inline double sin(Angle angle)
+	{
+		return sincos(angle).sin;
+	}
+
+	template<detail::AngleQuantity Angle>
+	inline double cos(Angle angle)
+	{
+		return sincos(angle).cos;
+	}
+
+	/*!
+	 * The angle of the vector (x, y), in Result (radians by default), in (-half turn, half turn]. x and y may be
+	 * in any SimilarUnits; x is converted to the unit of y. A binary angle result wraps into [0, full turn).
+	 */
+	template<AngleUnit Result = angles::radian, detail::QuantityOrDelta Y, detail::QuantityOrDelta X>
+	requires SimilarUnits<typename Y::unit_type, typename X::unit_type>
+	inline quantity<Result> atan2(Y y, X x)
+	{
+		const double radians = std::atan2(static_cast<double>(y.value()),
+			static_cast<double>(unit_conversion<typename X::unit_type, typename Y::unit_type>::convert(x.value())));
+		if constexpr (detail::is_quantized_unit<Result>::value)
+			return quantize<Result, overflow_policy::wrap>(quantity<angles::radian>{ radians });
+		else
+		{
+			constexpr detail::affine_coefficients c = detail::affine_conversion<angles::radian, Result>();
+			return quantity<Result>{ static_cast<typename Result::value_type>(radians * c.scale) };
+		}
+	}
+
+	/*!
+	 * out[i] = sin(values[i]). The loop body has no branches or calls, so it vectorises.
+	 *
+	 * @throws std::invalid_argument If the spans have different lengths.
+	 */
+	template<detail::AngleQuantity Angle>
+	void sin(std::span<const Angle> values, std::span<double> out)
+	{
+		if (values.size() != out.size())
+			throw std::invalid_argument("sin spans must have the same length");
+		for (std::size_t i = 0; i < values.size(); ++i)
+			out[i] = detail::fast_sin_cos<typename Angle::unit_type>(values[i].value()).sin;
+	}
+
+	/*!
+	 * out[i] = cos(values[i]); see the batch sin.
+	 */
+	template<detail::AngleQuantity Angle>
+	void cos(std::span<const Angle> values, std::span<double> out)
+	{
+		if (values.size() != out.size())
+			throw std::invalid_argument("cos spans must have the same length");
+		for (std::size_t i = 0; i < values.size(); ++i)
+			out[i] = detail::fast_sin_cos<typename Angle::unit_type>(values[i].value()).cos;
+	}
+
+	/*!
+	 * sin and cos of every angle, sharing the reduction; see the batch sin.
+	 */
+	template<detail::AngleQuantity Angle>
+	void sincos(std::span<const Angle> values, std::span<double> sin_out, std::span<double> cos_out)
+	{
+		if (values.size() != sin_out.size() || values.size() != cos_out.size())
+			throw std::invalid_argument("sincos spans must have the same length");
+		for (std::size_t i = 0; i < values.size(); ++i)
+		{
+			const sin_cos result = detail::fast_sin_cos<typename Angle::unit_type>(values[i].value());
+			sin_out[i] = result.sin;
+			cos_out[i] = result.cos;
+		}
+	}
+
+	/*!
+	 * out[i] = atan2(y[i], x[i]) in Result. This calls std::atan2, so unlike sin and cos it does not vectorise.
+	 *
+	 * @throws std::invalid_argument If the spans have different lengths.
+	 */
+	template<AngleUnit Result, detail::QuantityOrDelta Y, detail::QuantityOrDelta X>
+	requires SimilarUnits<typename Y::unit_type, typename X::unit_type>
+	void atan2(std::span<const Y> y, std::span<const X> x, std::span<quantity<Result>> out)
+	{
+		if (y.size() != out.size() || x.size() != out.size())
+			throw std::invalid_argument("atan2 spans must have the same length");
+		for (std::size_t i = 0; i < out.size(); ++i)
+			out[i] = atan2<Result>(y[i], x[i]);
+	}
+}
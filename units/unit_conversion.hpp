@@ -1,6 +1,10 @@
 #pragma once
 #include "units.hpp"
 #include "detail/unit_comparisons.hpp"
+#include "unit_scale.hpp"
+#ifdef CPP_UNITS_TRACE_CONVERSIONS
+#include "conversion_trace.hpp"
+#endif
 
 namespace units
 {
@@ -18,12 +22,56 @@ namespace units
 	{
 		using value_type = std::common_type_t<typename From::value_type, typename To::value_type>;
 
+		/*!
+		 * The ratio between From and To, folded at compile time. This is exact whenever both
+		 * units are built from fundamental units by scaling, exponents and compounds.
+		 */
+		constexpr static const detail::scale_factor factor = detail::divide(unit_scale_v<From>, unit_scale_v<To>);
+
 		/*!
 		 * Convert a value of unit type From to unit type To and return the result.
+		 * If the ratio between the units is exact, the conversion is a single multiply and/or
+		 * divide by constants, which keeps integer conversions exact. Otherwise the value is
+		 * converted through the fundamental unit.
 		 */
 		constexpr static value_type convert(value_type value)
 		{
-			return To::from_fundamental(From::to_fundamental(value));
+#ifdef CPP_UNITS_TRACE_CONVERSIONS
+			if (!std::is_constant_evaluated())
+				detail::trace_conversion<From, To>();
+#endif
+			if constexpr (factor.exact)
+				return detail::apply_scale<factor.num, factor.den>(value);
+			else
+				return To::from_fundamental(From::to_fundamental(value));
 		}
 	};
+
+	namespace detail
+	{
+		/*!
+		 * The conversion from From to To written as to = from * scale + offset, in double, for code that converts
+		 * many values and wants to fold the conversion into its own arithmetic (an index computation, a polynomial).
+		 * Exact scale conversions have an offset of zero; anything else is measured through unit_conversion.
+		 */
+		struct affine_coefficients
+		{
+			double scale = 1.0;
+			double offset = 0.0;
+		};
+
+		template<Unit From, Unit To>
+		requires SimilarUnits<From, To>
+		constexpr affine_coefficients affine_conversion()
+		{
+			using conversion = unit_conversion<From, To>;
+			if constexpr (conversion::factor.exact)
+				return { static_cast<double>(conversion::factor.num) / static_cast<double>(conversion::factor.den), 0.0 };
+			else
+			{
+				const double offset = static_cast<double>(conversion::convert(0));
+				return { static_cast<double>(conversion::convert(1)) - offset, offset };
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,391 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "units.hpp"
+#include "exponent_unit.hpp"
+#include "compound_unit.hpp"
+#include "unit_conversion.hpp"
+#include "quantity.hpp"
+
+namespace units
+{
+	/*!
+	 * A list of units describing the rows or columns of a unit_matrix, or the entries of a unit_vector.
+	 */
+	template<Unit... Units>
+	struct unit_pack
+	{
+		constexpr static const std::size_t size = sizeof...(Units);
+	};
+
+	/*!
+	 * Meta-function, returns the unit at position I of a unit_pack.
+	 */
+	template<std::size_t I, class Pack>
+	struct pack_element;
+
+	template<std::size_t I, Unit... Units>
+	struct pack_element<I, unit_pack<Units...>>
+	{
+		using type = std::tuple_element_t<I, std::tuple<Units...>>;
+	};
+
+	template<std::size_t I, class Pack>
+	using pack_element_t = typename pack_element<I, Pack>::type;
+
+	/*!
+	 * Meta-function, returns a unit_pack of the inverse of every unit in Pack.
+	 */
+	template<class Pack>
+	struct inverse_pack;
+
+	template<Unit... Units>
+	struct inverse_pack<unit_pack<Units...>>
+	{
+		using type = unit_pack<make_inverse_t<Units>...>;
+	};
+
+	template<class Pack>
+	using inverse_pack_t = typename inverse_pack<Pack>::type;
+
+	namespace detail
+	{
+		template<class A, class B>
+		struct similar_packs : std::false_type {};
+
+		template<Unit... As, Unit... Bs>
+		requires (sizeof...(As) == sizeof...(Bs))
+		struct similar_packs<unit_pack<As...>, unit_pack<Bs...>> : std::bool_constant<(similar_units_v<As, Bs> && ...)> {};
+
+		//! True if every unit of B is identical to its counterpart in A, so no conversion is needed between them.
+		template<class A, class B>
+		struct identical_scale_packs : std::false_type {};
+
+		template<Unit... As, Unit... Bs>
+		requires (sizeof...(As) == sizeof...(Bs))
+		struct identical_scale_packs<unit_pack<As...>, unit_pack<Bs...>>
+			: std::bool_constant<((std::is_same_v<As, Bs> || (unit_conversion<Bs, As>::factor.exact
+				&& unit_conversion<Bs, As>::factor.num == unit_conversion<Bs, As>::factor.den)) && ...)> {};
+
+		//! Tile size used by the blocked kernels, in elements. A 64x64 tile of doubles fits in L1 alongside a row of C.
+		constexpr const std::size_t gemm_block = 64;
+
+		/*!
+		 * c += a * b for row-major a (m x k), b (k x n) and c (m x n). The loops are tiled over k and n and
+		 * ordered i-k-j so the innermost loop is a unit-stride axpy over a row of b, which compilers vectorise.
+		 */
+		template<class T>
+		constexpr void gemm(std::size_t m, std::size_t n, std::size_t k, const T* a, const T* b, T* c)
+		{
+			for (std::size_t kk = 0; kk < k; kk += gemm_block)
+			{
+				const std::size_t k_end = std::min(k, kk + gemm_block);
+				for (std::size_t jj = 0; jj < n; jj += gemm_block)
+				{
+					const std::size_t j_end = std::min(n, jj + gemm_block);
+					for (std::size_t i = 0; i < m; ++i)
+					{
+						T* c_row = c + i * n;
+						for (std::size_t p = kk; p < k_end; ++p)
+						{
+							const T a_ip = a[i * k + p];
+							const T* b_row = b + p * n;
+							for (std::size_t j = jj; j < j_end; ++j)
+								c_row[j] += a_ip * b_row[j];
+						}
+					}
+				}
+			}
+		}
+
+		/*!
+		 * y += a * x for row-major a (m x n). Each row is reduced into four independent partial sums
+		 * so the dot product is not serialised on a single accumulator.
+		 */
+		template<class T>
+		constexpr void gemv(std::size_t m, std::size_t n, const T* a, const T* x, T* y)
+		{
+			for (std::size_t i = 0; i < m; ++i)
+			{
+				const T* a_row = a + i * n;
+				T partial[4]{};
+				std::size_t j = 0;
+				for (; j + 4 <= n; j += 4)
+				{
+					partial[0] += a_row[j] * x[j];
+					partial[1] += a_row[j + 1] * x[j + 1];
+					partial[2] += a_row[j + 2] * x[j + 2];
+					partial[3] += a_row[j + 3] * x[j + 3];
+				}
+				for (; j < n; ++j)
+					partial[0] += a_row[j] * x[j];
+				y[i] += (partial[0] + partial[1]) + (partial[2] + partial[3]);
+			}
+		}
+	}
+
+	template<class Units>
+	class unit_vector;
+
+	/*!
+	 * unit_vector is a fixed-size column vector whose entries may each have a different unit.
+	 * Entry I has unit pack_element_t<I, unit_pack<Units...>>. The values are stored contiguously
+	 * as raw value_type, so the units only exist at compile time.
+	 */
+	template<Unit... Units>
+	class unit_vector<unit_pack<Units...>>
+	{
+	public:
+
+		using units = unit_pack<Units...>;
+		using value_type = std::common_type_t<typename Units::value_type...>;
+
+		constexpr static const std::size_t size = sizeof...(Units);
+
+		template<std::size_t I>
+		using element_unit = pack_element_t<I, units>;
+
+		constexpr unit_vector() = default;
+
+		/*!
+		 * Constructs the vector from one quantity per entry. Each quantity is converted to the unit of its entry.
+		 */
+		template<Unit... Others>
+		requires (sizeof...(Others) == size && (similar_units_v<Units, Others> && ...))
+		constexpr explicit unit_vector(quantity<Others>... values)
+			: values_{ quantity<Units>{ values }.value()... }
+		{}
+
+		template<std::size_t I>
+		constexpr quantity<element_unit<I>> get() const
+		{
+			return quantity<element_unit<I>>{ values_[I] };
+		}
+
+		template<std::size_t I, Unit unit>
+		requires SimilarUnits<element_unit<I>, unit>
+		constexpr void set(quantity<unit> value)
+		{
+			values_[I] = quantity<element_unit<I>>{ value }.value();
+		}
+
+		/*!
+		 * Returns the raw values. Entry I is in element_unit<I>.
+		 */
+		constexpr std::span<value_type, size> data() { return values_; }
+		constexpr std::span<const value_type, size> data() const { return values_; }
+
+		/*!
+		 * Returns a copy of this vector with the entries converted to the units of Target.
+		 */
+		template<class Target>
+		requires detail::similar_packs<Target, units>::value
+		constexpr unit_vector<Target> convert() const
+		{
+			unit_vector<Target> result;
+			convert_into<Target>(result.data(), std::make_index_sequence<size>{});
+			return result;
+		}
+
+		constexpr unit_vector& operator+=(unit_vector const& other)
+		{
+			for (std::size_t i = 0; i < size; ++i)
+				values_[i] += other.values_[i];
+			return *this;
+		}
+
+		constexpr unit_vector& operator-=(unit_vector const& other)
+		{
+			for (std::size_t i = 0; i < size; ++i)
+				values_[i] -= other.values_[i];
+			return *this;
+		}
+
+		friend constexpr unit_vector operator+(unit_vector a, unit_vector const& b) { return a += b; }
+		friend constexpr unit_vector operator-(unit_vector a, unit_vector const& b) { return a -= b; }
+
+	private:
+
+		template<class Target, std::size_t... I>
+		constexpr void convert_into(std::span<value_type, size> out, std::index_sequence<I...>) const
+		{
+			((out[I] = unit_conversion<Units, pack_element_t<I, Target>>::convert(values_[I])), ...);
+		}
+
+		std::array<value_type, size> values_{};
+	};
+
+	template<class RowUnits, class ColumnUnits>
+	class unit_matrix;
+
+	/*!
+	 * unit_matrix is a fixed-size matrix whose rows and columns each carry a unit. Element (I, J) has
+	 * unit make_compound_t<Row_I, make_inverse_t<Column_J>>, which is the form taken by Jacobians and
+	 * gain matrices: multiplying by a unit_vector in the column units produces a unit_vector in the row units.
+	 *
+	 * The values are stored row-major as raw value_type, and all unit checks happen at compile time.
+	 * Products are checked on the inner dimension and computed by blocked GEMM/GEMV kernels on the raw storage.
+	 */
+	template<Unit... Rows, Unit... Columns>
+	class unit_matrix<unit_pack<Rows...>, unit_pack<Columns...>>
+	{
+	public:
+
+		using row_units = unit_pack<Rows...>;
+		using column_units = unit_pack<Columns...>;
+		using value_type = std::common_type_t<typename Rows::value_type..., typename Columns::value_type...>;
+
+		constexpr static const std::size_t rows = sizeof...(Rows);
+		constexpr static const std::size_t columns = sizeof...(Columns);
+
+		template<std::size_t I, std::size_t J>
+		using element_unit = make_compound_t<pack_element_t<I, row_units>, make_inverse_t<pack_element_t<J, column_units>>>;
+
+		constexpr unit_matrix() = default;
+
+		/*!
+		 * Returns the identity matrix. Only square matrices whose row and column units are the same
+		 * have an identity, since the diagonal elements must be dimensionless.
+		 */
+		constexpr static unit_matrix identity() requires std::is_same_v<row_units, column_units>
+		{
+			unit_matrix result;
+			for (std::size_t i = 0; i < rows; ++i)
+				result.values_[i * columns + i] = value_type{ 1 };
+			return result;
+		}
+
+		template<std::size_t I, std::size_t J>
+		constexpr quantity<element_unit<I, J>> get() const
+		{
+			return quantity<element_unit<I, J>>{ values_[I * columns + J] };
+		}
+
+		template<std::size_t I, std::size_t J, Unit unit>
+		requires SimilarUnits<element_unit<I, J>, unit>
+		constexpr void set(quantity<unit> value)
+		{
+			values_[I * columns + J] = quantity<element_unit<I, J>>{ value }.value();
+		}
+
+		/*!
+		 * Returns the raw values in row-major order. Element (I, J) is in element_unit<I, J>.
+		 */
+		constexpr std::span<value_type, rows * columns> data() { return values_; }
+		constexpr std::span<const value_type, rows * columns> data() const { return values_; }
+
+		/*!
+		 * Returns the transpose. Element (J, I) of the transpose has the same unit as element (I, J)
+		 * of this matrix, so the row units of the result are the inverse column units and vice versa.
+		 */
+		constexpr unit_matrix<inverse_pack_t<column_units>, inverse_pack_t<row_units>> transpose() const
+		{
+			unit_matrix<inverse_pack_t<column_units>, inverse_pack_t<row_units>> result;
+			auto out = result.data();
+			for (std::size_t i = 0; i < rows; ++i)
+				for (std::size_t j = 0; j < columns; ++j)
+					out[j * rows + i] = values_[i * columns + j];
+			return result;
+		}
+
+		constexpr unit_matrix& operator+=(unit_matrix const& other)
+		{
+			for (std::size_t i = 0; i < values_.size(); ++i)
+				values_[i] += other.values_[i];
+			return *this;
+		}
+
+		constexpr unit_matrix& operator-=(unit_matrix const& other)
+		{
+			for (std::size_t i = 0; i < values_.size(); ++i)
+				values_[i] -= other.values_[i];
+			return *this;
+		}
+
+		constexpr unit_matrix& operator*=(value_type scalar)
+		{
+			for (auto& value : values_)
+				value *= scalar;
+			return *this;
+		}
+
+		friend constexpr unit_matrix operator+(unit_matrix a, unit_matrix const& b) { return a += b; }
+		friend constexpr unit_matrix operator-(unit_matrix a, unit_matrix const& b) { return a -= b; }
+		friend constexpr unit_matrix operator*(unit_matrix a, value_type scalar) { return a *= scalar; }
+		friend constexpr unit_matrix operator*(value_type scalar, unit_matrix a) { return a *= scalar; }
+
+		/*!
+		 * Matrix product. The column units of a must be SimilarUnits to the row units of b, position by position.
+		 * When they differ in scale (meters against millimeters, say), the rows of b are converted once
+		 * before the kernel runs, so the cost is O(k * n) on top of the product.
+		 */
+		template<class InnerUnits, class OutputUnits>
+		requires detail::similar_packs<column_units, InnerUnits>::value
+		friend constexpr unit_matrix<row_units, OutputUnits> operator*(unit_matrix const& a, unit_matrix<InnerUnits, OutputUnits> const& b)
+		{
+			using rhs_type = unit_matrix<InnerUnits, OutputUnits>;
+			unit_matrix<row_units, OutputUnits> result;
+			if constexpr (detail::identical_scale_packs<column_units, InnerUnits>::value)
+				detail::gemm(rows, rhs_type::columns, columns, a.values_.data(), b.data().data(), result.data().data());
+			else
+			{
+				const auto converted = b.template convert_rows<column_units>();
+				detail::gemm(rows, rhs_type::columns, columns, a.values_.data(), converted.data().data(), result.data().data());
+			}
+			return result;
+		}
+
+		/*!
+		 * Matrix-vector product. The units of x must be SimilarUnits to the column units, and the result is in the row units.
+		 */
+		template<class VectorUnits>
+		requires detail::similar_packs<column_units, VectorUnits>::value
+		friend constexpr unit_vector<row_units> operator*(unit_matrix const& a, unit_vector<VectorUnits> const& x)
+		{
+			unit_vector<row_units> result;
+			if constexpr (detail::identical_scale_packs<column_units, VectorUnits>::value)
+				detail::gemv(rows, columns, a.values_.data(), x.data().data(), result.data().data());
+			else
+			{
+				const auto converted = x.template convert<column_units>();
+				detail::gemv(rows, columns, a.values_.data(), converted.data().data(), result.data().data());
+			}
+			return result;
+		}
+
+		/*!
+		 * Returns a copy of this matrix with each row converted to the corresponding unit of Target.
+		 * The element units become Target_I / Column_J.
+		 */
+		template<class Target>
+		requires detail::similar_packs<Target, row_units>::value
+		constexpr unit_matrix<Target, column_units> convert_rows() const
+		{
+			unit_matrix<Target, column_units> result;
+			convert_rows_into<Target>(result.data(), std::make_index_sequence<rows>{});
+			return result;
+		}
+
+	private:
+
+		template<class Target, std::size_t... I>
+		constexpr void convert_rows_into(std::span<value_type, rows * columns> out, std::index_sequence<I...>) const
+		{
+			(convert_row<I, pack_element_t<I, Target>>(out), ...);
+		}
+
+		template<std::size_t I, Unit Target>
+		constexpr void convert_row(std::span<value_type, rows * columns> out) const
+		{
+			for (std::size_t j = 0; j < columns; ++j)
+				out[I * columns + j] = unit_conversion<pack_element_t<I, row_units>, Target>::convert(values_[I * columns + j]);
+		}
+
+		std::array<value_type, rows * columns> values_{};
+	};
+}
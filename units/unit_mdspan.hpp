@@ -0,0 +1,245 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include "units.hpp"
+#include "quantity.hpp"
+#include "unit_conversion.hpp"
+#include "compound_unit.hpp"
+#include "difference_unit.hpp"
+
+#if __has_include(<mdspan>)
+#include <mdspan>
+#endif
+
+namespace units
+{
+	namespace detail
+	{
+		template<class Stored>
+		constexpr auto stored_value(Stored const& stored)
+		{
+			if constexpr (is_quantity_or_delta<std::remove_cv_t<Stored>>::value)
+				return stored.value();
+			else
+				return stored;
+		}
+
+		/*!
+		 * Converts a stored value in From to a value in To with the conversion folded at compile time: nothing
+		 * for identical scales, one multiply for scale conversions and one multiply-add for offset units.
+		 * Integer value types keep unit_conversion's exact rational arithmetic.
+		 */
+		template<Unit From, Unit To>
+		constexpr typename To::value_type fold_convert(typename From::value_type value)
+		{
+			using value_type = typename To::value_type;
+			if constexpr (!std::is_floating_point_v<value_type>)
+				return static_cast<value_type>(unit_conversion<From, To>::convert(value));
+			else
+			{
+				constexpr affine_coefficients c = affine_conversion<From, To>();
+				if constexpr (c.scale == 1.0 && c.offset == 0.0)
+					return static_cast<value_type>(value);
+				else if constexpr (c.offset == 0.0)
+					return static_cast<value_type>(value) * static_cast<value_type>(c.scale);
+				else
+					return static_cast<value_type>(value) * static_cast<value_type>(c.scale) + static_cast<value_type>(c.offset);
+			}
+		}
+
+		/*!
+		 * The reference type of a writable unit_accessor: reads convert From -> To and assignments convert back.
+		 */
+		template<Unit From, Unit To, class Stored>
+		class converted_reference
+		{
+		public:
+
+			constexpr explicit converted_reference(Stored* element)
+				: element_{ element }
+			{}
+
+			constexpr operator quantity<To>() const
+			{
+				return quantity<To>{ fold_convert<From, To>(stored_value(*element_)) };
+			}
+
+			constexpr converted_reference const& operator=(quantity<To> value) const
+			{
+				const auto converted = fold_convert<To, From>(value.value());
+				if constexpr (is_quantity_or_delta<Stored>::value)
+					*element_ = Stored{ converted };
+				else
+					*element_ = converted;
+				return *this;
+			}
+
+			constexpr converted_reference const& operator=(converted_reference const& other) const
+			{
+				return *this = static_cast<quantity<To>>(other);
+			}
+
+			constexpr quantity<To> get() const { return *this; }
+
+		private:
+
+			Stored* element_;
+		};
+	}
+
+	/*!
+	 * unit_accessor is an mdspan accessor policy that presents stored values in unit From as quantity<To>.
+	 * Stored may be From::value_type or quantity<From>, optionally const. A const Stored gives a read-only
+	 * view whose reference is quantity<To> by value; otherwise the reference is a proxy that converts on
+	 * assignment too. The conversion is folded to at most one multiply-add per element (see detail::fold_convert),
+	 * and the grid is never copied.
+	 *
+	 * For example, a kelvin field stored as raw doubles, viewed in celsius:
+	 * @code
+	 * std::mdspan<const quantity<si::celsius>, std::dextents<std::size_t, 2>, std::layout_right,
+	 *     unit_accessor<si::kelvin, si::celsius>> field{ data, rows, columns };
+	 * @endcode
+	 */
+	template<Unit From, Unit To, class Stored = const typename From::value_type>
+	requires SimilarUnits<From, To>
+	struct unit_accessor
+	{
+		using offset_policy = unit_accessor;
+		using element_type = std::conditional_t<std::is_const_v<Stored>, const quantity<To>, quantity<To>>;
+		using reference = std::conditional_t<std::is_const_v<Stored>, quantity<To>, detail::converted_reference<From, To, Stored>>;
+		using data_handle_type = Stored*;
+
+		constexpr unit_accessor() noexcept = default;
+
+		//! Conversion from the accessor of a writable view, so mutable views convert to read-only ones as in std::default_accessor.
+		template<class OtherStored>
+		requires std::is_convertible_v<OtherStored(*)[], Stored(*)[]>
+		constexpr unit_accessor(unit_accessor<From, To, OtherStored>) noexcept {}
+
+		constexpr reference access(data_handle_type p, std::size_t i) const noexcept
+		{
+			if constexpr (std::is_const_v<Stored>)
+				return quantity<To>{ detail::fold_convert<From, To>(detail::stored_value(p[i])) };
+			else
+				return reference{ p + i };
+		}
+
+		constexpr data_handle_type offset(data_handle_type p, std::size_t i) const noexcept
+		{
+			return p + i;
+		}
+	};
+
+	/*!
+	 * Accessor for raw values that are already in UnitType: a view of quantity<UnitType> with no conversion.
+	 */
+	template<Unit UnitType>
+	using quantity_accessor = unit_accessor<UnitType, UnitType>;
+
+	/*!
+	 * grid_geometry maps the indices of a grid to physical coordinates: an origin and a delta spacing per
+	 * dimension, each in its own unit, so a space x time grid can be described as
+	 * grid_geometry<si::meter, si::second>.
+	 */
+	template<Unit... Units>
+	class grid_geometry
+	{
+	public:
+
+		constexpr static const std::size_t rank = sizeof...(Units);
+
+		template<std::size_t D>
+		using unit = std::tuple_element_t<D, std::tuple<Units...>>;
+
+		constexpr grid_geometry(std::tuple<quantity<Units>...> origin, std::tuple<delta<Units>...> spacing)
+			: origin_{ origin },
+			  spacing_{ spacing }
+		{}
+
+		template<std::size_t D>
+		constexpr quantity<unit<D>> origin() const { return std::get<D>(origin_); }
+
+		template<std::size_t D>
+		constexpr delta<unit<D>> spacing() const { return std::get<D>(spacing_); }
+
+		//! The coordinate of index i along dimension D.
+		template<std::size_t D>
+		constexpr quantity<unit<D>> coordinate(std::size_t i) const
+		{
+			return origin<D>() + delta<unit<D>>{ static_cast<typename unit<D>::value_type>(i) * spacing<D>().value() };
+		}
+
+		/*!
+		 * The fractional index of x along dimension D. x may be in any SimilarUnits; the conversion is folded
+		 * into the affine map from coordinate to index.
+		 */
+		template<std::size_t D, Unit X>
+		requires SimilarUnits<X, unit<D>>
+		constexpr double index(quantity<X> x) const
+		{
+			constexpr detail::affine_coefficients c = detail::affine_conversion<X, unit<D>>();
+			const double inverse = 1.0 / static_cast<double>(spacing<D>().value());
+			return static_cast<double>(x.value()) * (c.scale * inverse) + (c.offset - static_cast<double>(origin<D>().value())) * inverse;
+		}
+
+	private:
+
+		std::tuple<quantity<Units>...> origin_;
+		std::tuple<delta<Units>...> spacing_;
+	};
+
+	/*!
+	 * Meta-function, the unit of the derivative of a field of Field along a dimension in Along.
+	 */
+	template<Unit Field, Unit Along>
+	using derivative_unit_t = make_compound_t<difference_unit_t<Field>, inverse_unit<Along>>;
+
+	/*!
+	 * Second-order central difference of a unit-typed mdspan along dimension D at index, that is
+	 * (f[i + 1] - f[i - 1]) / (2 h), as a delta of the derivative unit. The neighbours must be inside the view.
+	 * View is any mdspan-like type with an element_type of quantity and operator[](std::array).
+	 */
+	template<std::size_t D, class View, Unit... Units, class Index>
+	constexpr auto central_difference(View const& view, std::array<Index, sizeof...(Units)> index, grid_geometry<Units...> const& grid)
+	{
+		using element = std::remove_cv_t<typename View::element_type>;
+		using field_unit = typename element::unit_type;
+		using along = typename grid_geometry<Units...>::template unit<D>;
+		auto next = index;
+		auto previous = index;
+		++next[D];
+		--previous[D];
+		const auto difference = static_cast<element>(view[next]).value() - static_cast<element>(view[previous]).value();
+		using value_type = decltype(difference);
+		return delta<derivative_unit_t<field_unit, along>>{ difference / (value_type{ 2 } * static_cast<value_type>(grid.template spacing<D>().value())) };
+	}
+
+	/*!
+	 * Second central difference along dimension D, (f[i + 1] - 2 f[i] + f[i - 1]) / h^2, for Laplacian-style stencils.
+	 */
+	template<std::size_t D, class View, Unit... Units, class Index>
+	constexpr auto second_difference(View const& view, std::array<Index, sizeof...(Units)> index, grid_geometry<Units...> const& grid)
+	{
+		using element = std::remove_cv_t<typename View::element_type>;
+		using field_unit = typename element::unit_type;
+		using along = typename grid_geometry<Units...>::template unit<D>;
+		auto next = index;
+		auto previous = index;
+		++next[D];
+		--previous[D];
+		const auto sum = static_cast<element>(view[next]).value() - 2 * static_cast<element>(view[index]).value() + static_cast<element>(view[previous]).value();
+		using value_type = decltype(sum);
+		const auto h = static_cast<value_type>(grid.template spacing<D>().value());
+		return delta<make_compound_t<difference_unit_t<field_unit>, make_exponent_t<along, -2>>>{ sum / (h * h) };
+	}
+
+#if defined(__cpp_lib_mdspan)
+	/*!
+	 * A read-only mdspan of values stored in From, seen as quantity<To>.
+	 */
+	template<Unit To, Unit From, class Extents, class Layout = std::layout_right>
+	using converting_mdspan = std::mdspan<const quantity<To>, Extents, Layout, unit_accessor<From, To>>;
+#endif
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include "units.hpp"
+#include "fundamental_unit.hpp"
+
+namespace units
+{
+	namespace detail
+	{
+		/*!
+		 * A compile-time rational number used to describe how many fundamental units make up one unit.
+		 * If the scale cannot be expressed as a ratio of two std::intmax_t values (because the unit
+		 * has an offset, or the ratio would overflow), exact is false and num/den are meaningless.
+		 */
+		struct scale_factor
+		{
+			std::intmax_t num = 1;
+			std::intmax_t den = 1;
+			bool exact = true;
+		};
+
+		constexpr const scale_factor inexact_scale{ 1, 1, false };
+
+		constexpr bool checked_multiply(std::intmax_t a, std::intmax_t b, std::intmax_t& result)
+		{
+			if (a != 0 && b > std::numeric_limits<std::intmax_t>::max() / a)
+				return false;
+			result = a * b;
+			return true;
+		}
+
+		constexpr scale_factor multiply(scale_factor a, scale_factor b)
+		{
+			if (!a.exact || !b.exact)
+				return inexact_scale;
+
+			const std::intmax_t g1 = std::gcd(a.num, b.den);
+			const std::intmax_t g2 = std::gcd(b.num, a.den);
+			scale_factor result;
+			if (!checked_multiply(a.num / g1, b.num / g2, result.num) || !checked_multiply(a.den / g2, b.den / g1, result.den))
+				return inexact_scale;
+			return result;
+		}
+
+		constexpr scale_factor operator*(scale_factor a, scale_factor b)
+		{
+			return multiply(a, b);
+		}
+
+		constexpr scale_factor invert(scale_factor a)
+		{
+			return scale_factor{ a.den, a.num, a.exact };
+		}
+
+		constexpr scale_factor divide(scale_factor a, scale_factor b)
+		{
+			return multiply(a, invert(b));
+		}
+
+		constexpr scale_factor power(scale_factor a, std::intmax_t n)
+		{
+			if (n < 0)
+				return invert(power(a, -n));
+
+			scale_factor result;
+			for (std::intmax_t i = 0; i < n; ++i)
+				result = multiply(result, a);
+			return result;
+		}
+
+		/*!
+		 * Returns the scale of a ratio type used by scaled_unit. Ratio types that are not std::ratio-like
+		 * (ie, do not provide num and den) produce an inexact scale.
+		 */
+		template<class Ratio>
+		constexpr scale_factor ratio_scale()
+		{
+			if constexpr (requires { Ratio::num; Ratio::den; })
+				return scale_factor{ Ratio::den, Ratio::num };
+			else
+				return inexact_scale;
+		}
+
+		/*!
+		 * Multiplies value by the rational Num/Den, using only the operations that are needed.
+		 * For integer value types and power-of-two denominators the division compiles to a shift.
+		 */
+		template<std::intmax_t Num, std::intmax_t Den, class value_type>
+		constexpr value_type apply_scale(value_type value)
+		{
+			if constexpr (Num == 1 && Den == 1)
+				return value;
+			else if constexpr (Den == 1)
+				return value * static_cast<value_type>(Num);
+			else if constexpr (Num == 1)
+				return value / static_cast<value_type>(Den);
+			else
+				return value * static_cast<value_type>(Num) / static_cast<value_type>(Den);
+		}
+	}
+
+	/*!
+	 * Meta-function, returns the number of fundamental units in one UnitType as a compile-time rational.
+	 * For example, the scale of millimeters is 1/1000 and the scale of square millimeters is 1/1000000.
+	 * Fundamental units have a scale of 1; specializations for scaled_unit, exponent_unit and compound_unit
+	 * are provided next to those types. All other units (offset_unit, for example) are inexact, and
+	 * conversions involving them go through to_fundamental and from_fundamental instead.
+	 */
+	template<Unit UnitType>
+	struct unit_scale
+	{
+		constexpr static const detail::scale_factor value =
+			std::is_base_of_v<fundamental_unit<tag_of_t<UnitType>, typename UnitType::value_type>, UnitType>
+			? detail::scale_factor{}
+			: detail::inexact_scale;
+	};
+
+	template<Unit UnitType>
+	constexpr const detail::scale_factor unit_scale_v = unit_scale<UnitType>::value;
+}
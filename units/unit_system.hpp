@@ -2,6 +2,7 @@
 #include "units.hpp"
 #include "compound_unit.hpp"
 #include "exponent_unit.hpp"
+#include "quantity.hpp"
 
 namespace units
 {
@@ -32,6 +33,85 @@ namespace units
 		using velocity = make_compound_t<typename BaseSystem::length, frequency>;
 		using acceleration = make_compound_t<velocity, frequency>;
 		using force = make_compound_t<typename BaseSystem::mass, acceleration>;
-		using energy = make_compound_t<force, typename BaseSystem::time>;
+		using energy = make_compound_t<force, typename BaseSystem::length>;
+		using power = make_compound_t<energy, frequency>;
 	};
+
+	namespace detail
+	{
+		/*!
+		 * The base unit of System with the given unit_tag, or void if System has none.
+		 */
+		template<UnitSystem System, class Tag>
+		struct system_base_unit
+		{
+			template<class Base, class... Rest>
+			static auto find()
+			{
+				if constexpr (std::is_same_v<tag_of_t<Base>, Tag>)
+					return static_cast<Base*>(nullptr);
+				else if constexpr (sizeof...(Rest) != 0)
+					return find<Rest...>();
+				else
+					return static_cast<void*>(nullptr);
+			}
+
+			using type = std::remove_pointer_t<decltype(find<typename System::length, typename System::time, typename System::mass,
+				typename System::temperature, typename System::amount, typename System::current, typename System::luminosity>())>;
+		};
+
+		template<Unit UnitType, UnitSystem System>
+		struct system_unit
+		{
+			using base = typename system_base_unit<System, tag_of_t<UnitType>>::type;
+			static_assert(!std::is_void_v<base>, "The target unit system has no base unit with this unit_tag");
+			using type = std::conditional_t<exponent_of_v<UnitType> == 1, base, make_exponent_t<base, exponent_of_v<UnitType>>>;
+		};
+
+		template<Unit First, Unit... Rest>
+		struct make_compound_all
+		{
+			using type = make_compound_t<First, typename make_compound_all<Rest...>::type>;
+		};
+
+		template<Unit Last>
+		struct make_compound_all<Last>
+		{
+			using type = Last;
+		};
+
+		template<Unit... Units, UnitSystem System>
+		struct system_unit<compound_unit<Units...>, System>
+		{
+			using type = typename make_compound_all<typename system_unit<Units, System>::type...>::type;
+		};
+	}
+
+	/*!
+	 * Meta-function, returns the unit of System with the same dimension as UnitType, built from System's base
+	 * units. For example, system_unit_t<imperial::force, si> is kilogram meters per second squared.
+	 *
+	 * Every system's base units carry the si unit_tags (imperial::foot is a scaled si meter, and so on), so the
+	 * tags are the hub of the conversion graph between systems: any two units of the same dimension are
+	 * SimilarUnits, and unit_scale folds the whole path from one to the other into a single rational constant.
+	 * A force in pound-force converts to newtons with one multiply, not one per base unit.
+	 */
+	template<Unit UnitType, UnitSystem System>
+	using system_unit_t = typename detail::system_unit<UnitType, System>::type;
+
+	/*!
+	 * Converts a quantity to the corresponding unit of System. This is always explicit, so it is also how to
+	 * narrow between value types, for example si_system_t<double> to si_system_t<float>.
+	 */
+	template<UnitSystem System, Unit UnitType>
+	constexpr quantity<system_unit_t<UnitType, System>> system_cast(quantity<UnitType> value)
+	{
+		return quantity<system_unit_t<UnitType, System>>{ value };
+	}
+
+	template<UnitSystem System, Unit UnitType>
+	constexpr delta<system_unit_t<UnitType, System>> system_cast(delta<UnitType> value)
+	{
+		return delta<system_unit_t<UnitType, System>>{ value };
+	}
 }
\ No newline at end of file